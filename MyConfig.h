@@ -129,6 +129,9 @@
  * - 'V': CPU voltage
  * - 'F': CPU frequency
  * - 'M': free memory
+ * - 'S': input scheduler counters "P=passes,R=radio msgs,C=controller msgs,B=budget exhausted,
+ *   X=backpressure,H=RX high-water" (see @ref MY_PROCESS_BUDGET_MS), counters are cleared after
+ *   reporting. Counters that do not fit into the payload follow in further I_DEBUG messages.
  * - 'E': clear MySensors EEPROM area and reboot (i.e. "factory" reset)
  */
 //#define MY_SPECIAL_DEBUG
@@ -362,10 +365,15 @@
  * @def MY_RX_MESSAGE_BUFFER_FEATURE
  * @brief This enables the receiving buffer feature.
  *
- * This feature is currently not supported for anything but RF24.
- * Require @ref MY_RF24_IRQ_PIN to be set.
+ * Received frames are stored in a buffer until processed by the transport layer,
+ * instead of blocking the radio until read. Frames lost due to a full buffer are
+ * counted, see signal report command L.
  *
- * Note: Not supported on ESP8266, ESP32, STM32, nRF5 and sketches
+ * Supported for RF24, RFM69 (@ref MY_RFM69_NEW_DRIVER), RFM95 and RS485.
+ * RF24 buffers from interrupt context and requires @ref MY_RF24_IRQ_PIN to be set,
+ * the other transports buffer whenever the driver is serviced.
+ *
+ * Note: RF24 buffering is not supported on ESP8266, ESP32, STM32, nRF5 and sketches
  * that use SoftSPI. See below issue for details
  * https://github.com/mysensors/MySensors/issues/1128
  */
@@ -800,6 +808,25 @@
  */
 //#define MY_RFM69_MODEM_CONFIGURATION (RFM69_FSK_BR55_5_FD50)
 
+/**
+ * @def MY_RFM69_TX_QUEUE_SIZE
+ * @brief Number of outgoing frames buffered by the non-blocking TX engine of the new %RFM69 driver.
+ *
+ * With a queue, sending returns as soon as the frame is queued. Channel sensing, transmission,
+ * ACK matching and retries run from the radio handler, results are reported when the frame
+ * is acknowledged or all retries failed. Frames to the same recipient leave in order.
+ *
+ * @note With a queue, send() returns true once the frame is queued, not when the first hop
+ * has acknowledged it. Sketches relying on the return value to retry must keep the default.
+ *
+ * Disabled by default (0), sending blocks until the frame is acknowledged.
+ *
+ * @see MY_RFM69_NEW_DRIVER
+ */
+#ifndef MY_RFM69_TX_QUEUE_SIZE
+#define MY_RFM69_TX_QUEUE_SIZE (0u)
+#endif
+
 
 /** @}*/ // End of RFM69SettingGrpPub group
 
@@ -963,6 +990,24 @@
  * This allows for better stability using SF 9 to 12.
  */
 //#define MY_RFM95_TCXO
+
+/**
+ * @def MY_RFM95_TX_QUEUE_SIZE
+ * @brief Number of outgoing frames buffered by the non-blocking TX engine of the %RFM95 driver.
+ *
+ * With a queue, sending returns as soon as the frame is queued. Channel activity detection,
+ * transmission, ACK matching and retries run from the radio handler, so the main loop keeps
+ * running while LoRa frames are on air. Results are reported when the frame is acknowledged
+ * or all retries failed. Frames to the same recipient leave in order.
+ *
+ * @note With a queue, send() returns true once the frame is queued, not when the first hop
+ * has acknowledged it. Sketches relying on the return value to retry must keep the default.
+ *
+ * Disabled by default (0), sending blocks until the frame is acknowledged.
+ */
+#ifndef MY_RFM95_TX_QUEUE_SIZE
+#define MY_RFM95_TX_QUEUE_SIZE (0u)
+#endif
 /** @}*/ // End of RFM95SettingGrpPub group
 
 /**
@@ -1027,6 +1072,10 @@
  * @def MY_RAM_ROUTING_TABLE_FEATURE
  * @brief If enabled, the routing table is kept in RAM (if memory allows) and saved in regular
  *        intervals.
+ *
+ * Only routes changed since the last save are written (see @ref MY_ROUTING_TABLE_SAVE_INTERVAL_MS),
+ * and again on remote reboot and Linux shutdown. Apart from AVR, last-seen time, hops and RSSI
+ * of the last hop are kept per node, see @ref MY_ROUTING_TABLE_METADATA_ENABLED.
  * @note Enabled by default on most platforms, but on AVR only for atmega1280, atmega1284 and
  *       atmega2560.
  * @see MY_DISABLE_RAM_ROUTING_TABLE_FEATURE
@@ -1119,6 +1168,43 @@
  */
 //#define MY_TRANSPORT_MAX_TX_FAILURES (10u)
 
+/**
+ * @def MY_TRANSPORT_MULTIPATH_FEATURE
+ * @brief If defined, alternative next hops are kept and used if a transmission fails.
+ *
+ * - Nodes remember up to @ref MY_TRANSPORT_ROUTE_CANDIDATES parents that answered the last find
+ *   parent request. A failed uplink transmission switches to the best scoring alternative that is
+ *   not further from the GW, without a new parent search.
+ * - GW and repeaters with @ref MY_ROUTING_TABLE_METADATA_ENABLED keep up to
+ *   @ref MY_TRANSPORT_ROUTE_CANDIDATES next hops per destination, learned from received messages.
+ *   To avoid loops, messages only fail over to next hops with known hops (direct children and
+ *   PING/PONG) that are closer to the destination, and never back to the node they came from.
+ *
+ * Next hops are scored by link RSSI (received frames and ACKs) minus
+ * @ref MY_TRANSPORT_ROUTE_FAILURE_PENALTY per consecutive failed transmission. With a blocking
+ * radio send, a failed message is retried on the next-best hop immediately. With a TX queue
+ * (@ref MY_RFM95_TX_QUEUE_SIZE, @ref MY_RFM69_TX_QUEUE_SIZE) results are only known later,
+ * they update the scores and the following messages use the next-best hop.
+ */
+//#define MY_TRANSPORT_MULTIPATH_FEATURE
+
+/**
+ * @def MY_TRANSPORT_ROUTE_CANDIDATES
+ * @brief Max. number of parents and next hops per destination kept by @ref MY_TRANSPORT_MULTIPATH_FEATURE
+ */
+#ifndef MY_TRANSPORT_ROUTE_CANDIDATES
+#define MY_TRANSPORT_ROUTE_CANDIDATES (3u)
+#endif
+
+/**
+ * @def MY_TRANSPORT_ROUTE_FAILURE_PENALTY
+ * @brief Score penalty (in dB) per consecutive failed transmission to a next hop, see
+ *        @ref MY_TRANSPORT_MULTIPATH_FEATURE
+ */
+#ifndef MY_TRANSPORT_ROUTE_FAILURE_PENALTY
+#define MY_TRANSPORT_ROUTE_FAILURE_PENALTY (10)
+#endif
+
 /**
  * @def MY_TRANSPORT_WAIT_READY_MS
  * @brief Timeout in ms until transport is ready during startup, set to 0 for no timeout
@@ -1191,6 +1277,48 @@
  *        Incompatible libraries are unable to send sensor data.
  */
 #define MY_CORE_COMPATIBILITY_CHECK
+
+/**
+ * @def MY_PROCESS_BUDGET_MS
+ * @brief Time budget (in ms) for processing radio and controller input in one _process() pass.
+ *
+ * Radio and controller messages are processed alternately until both inputs are empty,
+ * the budget is exhausted or @ref MY_PROCESS_MAX_MESSAGES messages have been handled.
+ * Messages left over are processed in the next pass, the Linux event loop does not sleep in between.
+ */
+#ifndef MY_PROCESS_BUDGET_MS
+#if defined(__linux__)
+#define MY_PROCESS_BUDGET_MS (20ul)
+#else
+#define MY_PROCESS_BUDGET_MS (10ul)
+#endif
+#endif
+
+/**
+ * @def MY_PROCESS_MAX_MESSAGES
+ * @brief Max. number of radio and controller messages processed in one _process() pass.
+ *
+ * Bounds the time spent in _process() if the input is faster than the processing.
+ */
+#ifndef MY_PROCESS_MAX_MESSAGES
+#if defined(__linux__)
+#define MY_PROCESS_MAX_MESSAGES (64u)
+#else
+#define MY_PROCESS_MAX_MESSAGES (6u)
+#endif
+#endif
+
+/**
+ * @def MY_PROCESS_TX_RESERVE
+ * @brief Min. free radio TX queue slots required to read the next controller message.
+ *
+ * With a non-blocking radio TX queue (see @ref MY_RFM95_TX_QUEUE_SIZE, @ref MY_RFM69_TX_QUEUE_SIZE)
+ * controller messages are left in the gateway input while the queue is nearly full. The reserve
+ * keeps room for ACKs and routed frames generated by radio input.
+ */
+#ifndef MY_PROCESS_TX_RESERVE
+#define MY_PROCESS_TX_RESERVE (2u)
+#endif
 /** @}*/ // End of CoreSettingGrpPub group
 
 /**
@@ -1262,6 +1390,48 @@
 #define MY_OTA_FLASH_JDECID (0x1F65)
 #endif
 
+/**
+ * @def MY_OTA_WINDOW_SIZE
+ * @brief Number of FW blocks requested at once during OTA updates (1..16).
+ *
+ * With a value > 1 the node requests a window of blocks, the controller streams them
+ * back-to-back and only missing blocks are re-requested. The node reports bootloader
+ * protocol 3.2 in this case. The default (1) requests one block at a time.
+ */
+#ifndef MY_OTA_WINDOW_SIZE
+#define MY_OTA_WINDOW_SIZE (1u)
+#endif
+
+/**
+ * @def MY_OTA_DISABLE_FLASH_VERIFICATION
+ * @brief Define this to skip re-reading the FW image from flash after an OTA update.
+ *
+ * The CRC of the received FW blocks is checked incrementally while they are stored. By default
+ * the stored image is read back and verified again to detect flash write errors.
+ */
+//#define MY_OTA_DISABLE_FLASH_VERIFICATION
+
+/**
+ * @def MY_OTA_DELTA_UPDATE_FEATURE
+ * @brief Define this to accept delta (binary diff) FW updates.
+ *
+ * The node announces delta support if the running image matches the stored FW config.
+ * A controller can then send a patch against the running image instead of the full image.
+ * The patch is stored at @ref MY_OTA_DELTA_PATCH_OFFSET in external flash and the new image
+ * is reconstructed from the running image and the patch before the CRC verification.
+ * @note Requires external flash, not available with mcuboot. The node reports bootloader
+ *       protocol 3.2.
+ */
+//#define MY_OTA_DELTA_UPDATE_FEATURE
+
+/**
+ * @def MY_OTA_DELTA_PATCH_OFFSET
+ * @brief External flash address of the 32K area used to store delta patches.
+ */
+#ifndef MY_OTA_DELTA_PATCH_OFFSET
+#define MY_OTA_DELTA_PATCH_OFFSET (0x10000ul)
+#endif
+
 /**
  * @def MY_DISABLE_REMOTE_RESET
  * @brief Disables over-the-air reset of node
@@ -1447,6 +1617,35 @@
  */
 //#define MY_MQTT_CLIENT_PUBLISH_RETAIN
 
+/**
+ * @def MY_MQTT_CLIENT_RX_QUEUE_SIZE
+ * @brief Number of parsed inbound MQTT messages buffered by the MQTT client gateway (max 255).
+ *
+ * Publishes that arrive while the queue is full are dropped and counted.
+ */
+#ifndef MY_MQTT_CLIENT_RX_QUEUE_SIZE
+#if defined(MY_GATEWAY_LINUX)
+#define MY_MQTT_CLIENT_RX_QUEUE_SIZE (32u)
+#else
+#define MY_MQTT_CLIENT_RX_QUEUE_SIZE (4u)
+#endif
+#endif
+
+/**
+ * @def MY_MQTT_CLIENT_PUBLISH_BATCH_SIZE
+ * @brief Size in bytes of the buffer collecting outgoing MQTT publishes, 0 disables batching.
+ *
+ * Publishes are sent to the broker with a single write at the end of each process pass,
+ * or earlier when the buffer is full. Enabled by default on Linux only to save RAM on MCUs.
+ */
+#ifndef MY_MQTT_CLIENT_PUBLISH_BATCH_SIZE
+#if defined(MY_GATEWAY_LINUX)
+#define MY_MQTT_CLIENT_PUBLISH_BATCH_SIZE (1460u)
+#else
+#define MY_MQTT_CLIENT_PUBLISH_BATCH_SIZE (0u)
+#endif
+#endif
+
 /**
  * @def MY_MQTT_PASSWORD
  * @brief Used for authenticated MQTT connections.
@@ -1875,6 +2074,37 @@
 #define MY_VERIFICATION_TIMEOUT_MS (5*1000ul)
 #endif
 
+/**
+ * @def MY_SIGNING_NONCE_TABLE_SIZE
+ * @brief Number of nodes that can have an outstanding verification nonce at the same time.
+ *
+ * Each entry uses 37 bytes of RAM. When the table is full, the oldest nonce is dropped and the
+ * message signed with it will fail verification. A value of 1 matches a single session.
+ */
+#ifndef MY_SIGNING_NONCE_TABLE_SIZE
+#if defined(__linux__)
+#define MY_SIGNING_NONCE_TABLE_SIZE (16u)
+#else
+#define MY_SIGNING_NONCE_TABLE_SIZE (1u)
+#endif
+#endif
+
+/**
+ * @def MY_SIGNING_ASYNC_QUEUE_SIZE
+ * @brief Number of outgoing messages that can wait for a signing nonce at the same time.
+ *
+ * When larger than 0, a message that has to be signed is queued and its nonce is requested
+ * without blocking. The message is signed and sent when the nonce response arrives, so signed
+ * messages to different nodes overlap their handshakes. Messages to the same node are sent in
+ * order, one handshake at a time. Sending such a message reports success once it is queued,
+ * a message that does not fit into the full queue is dropped and its send call fails.
+ * Each entry uses about 40 bytes of RAM. Disabled by default (0), the nonce is then awaited
+ * in the send call.
+ */
+#ifndef MY_SIGNING_ASYNC_QUEUE_SIZE
+#define MY_SIGNING_ASYNC_QUEUE_SIZE (0u)
+#endif
+
 /**
  * @def MY_SIGNING_NODE_WHITELISTING
  * @brief Define to turn on whitelisting
@@ -1991,6 +2221,43 @@
 #if defined(MY_RF24_ENABLE_ENCRYPTION) || defined(MY_RFM69_ENABLE_ENCRYPTION) || defined(MY_NRF5_ESB_ENABLE_ENCRYPTION) || defined(MY_RFM95_ENABLE_ENCRYPTION)
 #define MY_ENCRYPTION_FEATURE
 #endif
+
+/**
+ * @def MY_ENCRYPTION_CCM
+ * @brief Use authenticated %AES-CCM transport encryption with a per-frame nonce.
+ *
+ * Applies to RF24, nRF5 and %RFM95 encryption (%RFM69 encrypts in hardware). Each frame carries
+ * the transmitting node id in clear, a 4 byte frame counter and a 4 byte MAC. Only the used
+ * message length is encrypted. Frames with an invalid MAC, or a counter that is not higher
+ * than the last one received from the same node, are dropped.
+ *
+ * The frame counter is kept in EEPROM and advanced in steps, so it never repeats across
+ * restarts. The 8 bytes overhead reduce the maximum message size to 24 bytes on RF24 and nRF5,
+ * i.e. 17 payload bytes instead of #MAX_PAYLOAD_SIZE. Larger messages are rejected by send().
+ * Signed messages and OTA firmware blocks (22 bytes) do not fit, combining this flag with
+ * signing or @ref MY_OTA_FIRMWARE_FEATURE is a compile error on these radios, and Linux gateways
+ * do not serve firmware images then. %RFM95 frames have room for the overhead, the payload limit
+ * is unchanged there.
+ *
+ * This flag has to be identical on ALL nodes in the network.
+ */
+//#define MY_ENCRYPTION_CCM
+
+/**
+ * @def MY_ENCRYPTION_CCM_SENDERS
+ * @brief Number of nodes whose last frame counter is tracked for replay protection.
+ *
+ * When the table is full, the least recently heard node is dropped from it. A node whose
+ * counter went backwards (e.g. after clearing its EEPROM) is accepted again once the receiver
+ * restarts or has dropped it from the table.
+ */
+#ifndef MY_ENCRYPTION_CCM_SENDERS
+#if defined(__linux__)
+#define MY_ENCRYPTION_CCM_SENDERS (32u)
+#else
+#define MY_ENCRYPTION_CCM_SENDERS (4u)
+#endif
+#endif
 /** @}*/ // End of EncryptionSettingGrpPub group
 
 /**
@@ -2151,6 +2418,20 @@
 #ifndef MY_LINUX_CONFIG_FILE
 #define MY_LINUX_CONFIG_FILE "/etc/mysensors.conf"
 #endif
+
+/**
+ * @def MY_LINUX_EVENT_LOOP_TIMEOUT_MS
+ * @brief Maximum time in ms the main loop blocks waiting for controller data, radio interrupts or timers.
+ *
+ * A RF24 radio without @ref MY_RF24_IRQ_PIN has to be polled, in that case the loop wakes up every 10ms.
+ */
+#ifndef MY_LINUX_EVENT_LOOP_TIMEOUT_MS
+#if defined(MY_RADIO_RF24) && !defined(MY_RF24_IRQ_PIN)
+#define MY_LINUX_EVENT_LOOP_TIMEOUT_MS (10ul)
+#else
+#define MY_LINUX_EVENT_LOOP_TIMEOUT_MS (100ul)
+#endif
+#endif
 /** @}*/ // End of LinuxSettingGrpPub group
 /** @}*/ // End of PlatformSettingGrpPub group
 
@@ -2300,6 +2581,7 @@
 #define MY_LINUX_SERIAL_GROUPNAME
 #define MY_LINUX_SERIAL_PTY
 #define MY_LINUX_IS_SERIAL_PTY
+#define MY_LINUX_EVENT_LOOP_TIMEOUT_MS
 // inclusion mode
 #define MY_INCLUSION_MODE_FEATURE
 #define MY_INCLUSION_BUTTON_FEATURE
@@ -2310,11 +2592,14 @@
 #define MY_PARENT_NODE_IS_STATIC
 #define MY_REGISTRATION_CONTROLLER
 #define MY_TRANSPORT_UPLINK_CHECK_DISABLED
+#define MY_TRANSPORT_MULTIPATH_FEATURE
 #define MY_TRANSPORT_SANITY_CHECK
 #define MY_NODE_LOCK_FEATURE
 #define MY_REPEATER_FEATURE
 #define MY_PASSIVE_NODE
 #define MY_MQTT_CLIENT_PUBLISH_RETAIN
+#define MY_MQTT_CLIENT_RX_QUEUE_SIZE
+#define MY_MQTT_CLIENT_PUBLISH_BATCH_SIZE
 #define MY_MQTT_PASSWORD
 #define MY_MQTT_USER
 #define MY_MQTT_CLIENT_ID
@@ -2376,12 +2661,18 @@
 #define MY_SIGNING_REQUEST_SIGNATURES
 #define MY_SIGNING_WEAK_SECURITY
 #define MY_SIGNING_NODE_WHITELISTING
+#define MY_SIGNING_NONCE_TABLE_SIZE
+#define MY_SIGNING_ASYNC_QUEUE_SIZE
 #define MY_DEBUG_VERBOSE_SIGNING
 #define MY_SIGNING_FEATURE
 #define MY_ENCRYPTION_FEATURE
+#define MY_ENCRYPTION_CCM
+#define MY_ENCRYPTION_CCM_SENDERS
 // FOTA update
 #define MY_DEBUG_VERBOSE_OTA_UPDATE
 #define MY_OTA_USE_I2C_EEPROM
+#define MY_OTA_DISABLE_FLASH_VERIFICATION
+#define MY_OTA_DELTA_UPDATE_FEATURE
 // RS485
 #define MY_RS485
 #define MY_RS485_DE_PIN
@@ -2414,6 +2705,7 @@
 #define MY_RFM69_RST_PIN
 #define MY_DEBUG_VERBOSE_RFM69
 #define MY_DEBUG_VERBOSE_RFM69_REGISTERS
+#define MY_RFM69_TX_QUEUE_SIZE
 // RFM95
 #define MY_RADIO_RFM95
 #define MY_DEBUG_VERBOSE_RFM95
@@ -2424,6 +2716,7 @@
 #define MY_RFM95_POWER_PIN
 #define MY_RFM95_TCXO
 #define MY_RFM95_MAX_POWER_LEVEL_DBM
+#define MY_RFM95_TX_QUEUE_SIZE
 // SOFT-SPI
 #define MY_SOFTSPI
 #endif
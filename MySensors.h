@@ -334,6 +334,46 @@ MY_DEFAULT_RX_LED_PIN in your sketch instead to enable LEDs
 #endif // ARDUINO_ARCH_AVR
 #endif // DOXYGEN
 
+#ifdef DOXYGEN
+/**
+ * @def MY_ROUTING_TABLE_METADATA_ENABLED
+ * @brief Automatically set if the RAM routing table keeps last-seen time, hops and RSSI per node
+ *
+ * Enabled with @ref MY_RAM_ROUTING_TABLE_ENABLED, except on AVR (RAM limited).
+ */
+#define MY_ROUTING_TABLE_METADATA_ENABLED
+#elif defined(MY_RAM_ROUTING_TABLE_ENABLED) && !defined(ARDUINO_ARCH_AVR)
+#define MY_ROUTING_TABLE_METADATA_ENABLED
+#endif // DOXYGEN
+
+// MULTIPATH ROUTING
+#ifdef DOXYGEN
+/**
+ * @def MY_TRANSPORT_PARENT_FAILOVER_ENABLED
+ * @brief Automatically set if nodes switch to an alternative parent on uplink failures
+ *
+ * @see MY_TRANSPORT_MULTIPATH_FEATURE
+ */
+#define MY_TRANSPORT_PARENT_FAILOVER_ENABLED
+/**
+ * @def MY_TRANSPORT_ROUTE_FAILOVER_ENABLED
+ * @brief Automatically set if GW and repeaters keep alternative next hops per destination
+ *
+ * @see MY_TRANSPORT_MULTIPATH_FEATURE
+ */
+#define MY_TRANSPORT_ROUTE_FAILOVER_ENABLED
+#elif defined(MY_TRANSPORT_MULTIPATH_FEATURE)
+#if !defined(MY_GATEWAY_FEATURE) && !defined(MY_PARENT_NODE_IS_STATIC) && !defined(MY_PASSIVE_NODE)
+#define MY_TRANSPORT_PARENT_FAILOVER_ENABLED
+#endif
+#if defined(MY_ROUTING_TABLE_METADATA_ENABLED)
+#define MY_TRANSPORT_ROUTE_FAILOVER_ENABLED
+#endif
+#if (MY_TRANSPORT_ROUTE_CANDIDATES < 2)
+#error MY_TRANSPORT_ROUTE_CANDIDATES must be at least 2 for multipath routing
+#endif
+#endif // DOXYGEN
+
 // SOFTSERIAL
 #if defined(MY_GSM_TX) != defined(MY_GSM_RX)
 #error Both, MY_GSM_TX and MY_GSM_RX need to be defined when using SoftSerial
@@ -383,10 +423,6 @@ MY_DEFAULT_RX_LED_PIN in your sketch instead to enable LEDs
 #include "hal/transport/RFM95/MyTransportRFM95.cpp"
 #endif
 
-#if (defined(MY_RF24_ENABLE_ENCRYPTION) && defined(MY_RADIO_RF24)) || (defined(MY_NRF5_ESB_ENABLE_ENCRYPTION) && defined(MY_RADIO_NRF5_ESB)) || (defined(MY_RFM69_ENABLE_ENCRYPTION) && defined(MY_RADIO_RFM69)) || (defined(MY_RFM95_ENABLE_ENCRYPTION) && defined(MY_RADIO_RFM95))
-#define MY_TRANSPORT_ENCRYPTION //!< ïnternal flag
-#endif
-
 #include "hal/transport/MyTransportHAL.cpp"
 
 // PASSIVE MODE
@@ -404,6 +440,23 @@ MY_DEFAULT_RX_LED_PIN in your sketch instead to enable LEDs
 #endif
 #endif
 
+// OTA FIRMWARE SERVER
+#if defined(DOXYGEN)
+/**
+ * @def MY_OTA_FIRMWARE_SERVER_ENABLED
+ * @brief Automatically set on Linux gateways, which serve cached OTA firmware images to nodes
+ *
+ * Not set with @ref MY_ENCRYPTION_CCM on RF24 and nRF5, firmware blocks do not fit into the frames.
+ *
+ * @see MyOTAFirmwareServer.h
+ */
+#define MY_OTA_FIRMWARE_SERVER_ENABLED
+#elif defined(MY_GATEWAY_FEATURE) && defined(__linux__) && (MY_TRANSPORT_MAX_PAYLOAD_SIZE == MAX_PAYLOAD_SIZE)
+// not with MY_ENCRYPTION_CCM on RF24 and nRF5, firmware blocks do not fit into the frames
+#define MY_OTA_FIRMWARE_SERVER_ENABLED
+#include "core/MyOTAFirmwareServer.cpp"
+#endif
+
 #include "core/MyTransport.cpp"
 #endif
 
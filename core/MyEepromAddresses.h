@@ -48,6 +48,7 @@
 #define SIZE_SIGNING_SOFT_SERIAL			(9u)		//!< Size soft signing serial
 #define SIZE_RF_ENCRYPTION_AES_KEY			(16u)	//!< Size RF AES encryption key
 #define SIZE_NODE_LOCK_COUNTER				(1u)		//!< Size node lock counter
+#define SIZE_RF_ENCRYPTION_COUNTER			(4u)		//!< Size RF encryption frame counter
 
 
 /** @brief EEPROM start address */
@@ -86,6 +87,8 @@
 #define EEPROM_NODE_LOCK_COUNTER_ADDRESS (EEPROM_RF_ENCRYPTION_AES_KEY_ADDRESS + SIZE_RF_ENCRYPTION_AES_KEY)
 /** @brief First free address for sketch static configuration */
 #define EEPROM_LOCAL_CONFIG_ADDRESS (EEPROM_NODE_LOCK_COUNTER_ADDRESS + SIZE_NODE_LOCK_COUNTER)
+/** @brief Address RF encryption frame counter, see @ref MY_ENCRYPTION_CCM. Uses the last bytes of the controller config range, which controllerConfig_t leaves unused */
+#define EEPROM_RF_ENCRYPTION_COUNTER_ADDRESS (EEPROM_CONTROLLER_CONFIG_ADDRESS + SIZE_CONTROLLER_CONFIG - SIZE_RF_ENCRYPTION_COUNTER)
 
 #endif // MyEepromAddresses_h
 
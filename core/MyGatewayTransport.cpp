@@ -25,45 +25,97 @@ extern bool transportSendRoute(MyMessage &message);
 extern MyMessage _msg;
 extern MyMessage _msgTmp;
 
-inline void gatewayTransportProcess(void)
+#if defined(__linux__)
+char *gatewayRxBufferGetLine(gatewayRxBuffer_t &buffer, size_t &length)
 {
-	if (gatewayTransportAvailable()) {
-		_msg = gatewayTransportReceive();
-		if (_msg.getDestination() == GATEWAY_ADDRESS) {
-
-			// Check if sender requests an echo
-			if (_msg.getRequestEcho()) {
-				// Copy message
-				_msgTmp = _msg;
-				// Reply without echo flag, otherwise we would end up in an eternal loop
-				_msgTmp.setRequestEcho(false);
-				_msgTmp.setEcho(true);
-				_msgTmp.setSender(getNodeId());
-				_msgTmp.setDestination(_msg.getSender());
-				gatewayTransportSend(_msgTmp);
+	while (buffer.head < buffer.tail) {
+		char *line = buffer.data + buffer.head;
+		const size_t available = buffer.tail - buffer.head;
+		char *eol = (char *)memchr(line, '\n', available);
+		// '\r' is a terminator as well
+		char *cr = (char *)memchr(line, '\r', eol ? (size_t)(eol - line) : available);
+		if (cr) {
+			eol = cr;
+		}
+		if (!eol) {
+			if (available >= MY_GATEWAY_MAX_RECEIVE_LENGTH - 1) {
+				// Incoming message too long. Throw away
+				GATEWAY_DEBUG(PSTR("!GWT:RFC:MSG TOO LONG\n"));
+				buffer.head = buffer.tail;
+			}
+			return NULL;
+		}
+		*eol = 0;
+		buffer.head = (uint16_t)(eol - buffer.data + 1);
+		length = eol - line;
+		if (!length) {
+			// empty line, e.g. the '\n' of a "\r\n" terminator
+			continue;
+		}
+		if (length < MY_GATEWAY_MAX_RECEIVE_LENGTH - 1) {
+			if (buffer.head < buffer.tail) {
+				// more data buffered, the next pass must not block
+				EventLoop.wakeup();
 			}
-			if (_msg.getCommand() == C_INTERNAL) {
-				if (_msg.getType() == I_VERSION) {
-					// Request for version. Create the response
-					gatewayTransportSend(buildGw(_msgTmp, I_VERSION).set(MYSENSORS_LIBRARY_VERSION));
+			return line;
+		}
+		GATEWAY_DEBUG(PSTR("!GWT:RFC:MSG TOO LONG\n"));
+	}
+	return NULL;
+}
+
+size_t gatewayRxBufferCompact(gatewayRxBuffer_t &buffer)
+{
+	if (buffer.head) {
+		buffer.tail -= buffer.head;
+		(void)memmove(buffer.data, buffer.data + buffer.head, buffer.tail);
+		buffer.head = 0;
+	}
+	return sizeof(buffer.data) - buffer.tail;
+}
+#endif
+
+inline bool gatewayTransportProcess(void)
+{
+	if (!gatewayTransportAvailable()) {
+		return false;
+	}
+	_msg = gatewayTransportReceive();
+	if (_msg.getDestination() == GATEWAY_ADDRESS) {
+
+		// Check if sender requests an echo
+		if (_msg.getRequestEcho()) {
+			// Copy message
+			_msgTmp = _msg;
+			// Reply without echo flag, otherwise we would end up in an eternal loop
+			_msgTmp.setRequestEcho(false);
+			_msgTmp.setEcho(true);
+			_msgTmp.setSender(getNodeId());
+			_msgTmp.setDestination(_msg.getSender());
+			gatewayTransportSend(_msgTmp);
+		}
+		if (_msg.getCommand() == C_INTERNAL) {
+			if (_msg.getType() == I_VERSION) {
+				// Request for version. Create the response
+				gatewayTransportSend(buildGw(_msgTmp, I_VERSION).set(MYSENSORS_LIBRARY_VERSION));
 #ifdef MY_INCLUSION_MODE_FEATURE
-				} else if (_msg.getType() == I_INCLUSION_MODE) {
-					// Request to change inclusion mode
-					inclusionModeSet(atoi(_msg.data) == 1);
+			} else if (_msg.getType() == I_INCLUSION_MODE) {
+				// Request to change inclusion mode
+				inclusionModeSet(atoi(_msg.data) == 1);
 #endif
-				} else {
-					(void)_processInternalCoreMessage();
-				}
 			} else {
-				// Call incoming message callback if available
-				if (receive) {
-					receive(_msg);
-				}
+				(void)_processInternalCoreMessage();
 			}
 		} else {
+			// Call incoming message callback if available
+			if (receive) {
+				receive(_msg);
+			}
+		}
+	} else {
 #if defined(MY_SENSOR_NETWORK)
-			transportSendRoute(_msg);
+		transportSendRoute(_msg);
 #endif
-		}
 	}
+	return true;
 }
@@ -31,6 +31,7 @@
 * - SUB SYSTEMS:
 *  - GWT:<b>TIN</b>		from @ref gatewayTransportInit()
 *  - GWT:<b>TPS</b>		from @ref gatewayTransportSend()
+*  - GWT:<b>TFL</b>		from @ref gatewayTransportFlush()
 *  - GWT:<b>IMQ</b>		from incomingMQTT()
 *  - GWT:<b>RMQ</b>		from reconnectMQTT()
 *  - GWT:<b>TPC</b>		from gatewayTransportConnect()
@@ -47,10 +48,13 @@
 * |!| GWT | TIN   | DHCP FAIL                 | DHCP request failed
 * | | GWT | TIN   | ETH OK                    | Connected to network
 * |!| GWT | TIN   | ETH FAIL                  | Connection failed
+* |!| GWT | TIN   | BATCH BUFFER FAIL         | MQTT publish batch buffer could not be allocated
 * | | GWT | TPS   | TOPIC=%%s,MSG SENT        | MQTT message sent on topic [%%s]
 * | | GWT | TPS   | ETH OK                    | Connected to network
 * |!| GWT | TPS   | ETH FAIL                  | Connection failed
+* |!| GWT | TFL   | FAIL                      | Sending batched MQTT messages failed
 * | | GWT | IMQ   | TOPIC=%%s,MSG RECEIVE     | MQTT message received on topic [%%s]
+* |!| GWT | IMQ   | QUEUE FULL,DROPPED=%%d    | Inbound queue full, message dropped, [%%d] dropped in total
 * | | GWT | RMQ   | CONNECTING...             | Connecting to MQTT broker
 * | | GWT | RMQ   | OK                        | Connected to MQTT broker
 * |!| GWT | RMQ   | FAIL                      | Connection to MQTT broker failed
@@ -85,10 +89,42 @@
 #define GATEWAY_DEBUG(x,...)									//!< debug NULL
 #endif
 
+#if defined(__linux__)
+#define GATEWAY_RX_BUFFER_SIZE (1024u)	//!< Size of the receive buffer per controller connection
+
+/**
+ * @brief Receive buffer for controller input, filled by bulk reads
+ */
+typedef struct {
+	char data[GATEWAY_RX_BUFFER_SIZE];	//!< received bytes
+	uint16_t head;						//!< start of unprocessed data
+	uint16_t tail;						//!< end of received data
+} gatewayRxBuffer_t;
+
 /**
- * @brief Process gateway-related messages
+ * @brief Extract the next complete line from a receive buffer
+ *
+ * The line terminator ('\n' or '\r') is replaced in place by a string terminator.
+ * Empty lines and lines exceeding @ref MY_GATEWAY_MAX_RECEIVE_LENGTH are discarded.
+ * @param buffer receive buffer
+ * @param length set to the length of the line, without terminator
+ * @return pointer to the line, NULL if no complete line is buffered
  */
-void gatewayTransportProcess(void);
+char *gatewayRxBufferGetLine(gatewayRxBuffer_t &buffer, size_t &length);
+
+/**
+ * @brief Move unprocessed data to the start of the buffer to make room for the next read
+ * @param buffer receive buffer
+ * @return number of bytes that can be read into buffer.data + buffer.tail
+ */
+size_t gatewayRxBufferCompact(gatewayRxBuffer_t &buffer);
+#endif
+
+/**
+ * @brief Process the next gateway-related message
+ * @return true if a message was processed
+ */
+bool gatewayTransportProcess(void);
 
 /**
  * @brief Initialize gateway transport driver
@@ -103,6 +139,11 @@ bool gatewayTransportInit(void);
  */
 bool gatewayTransportSend(MyMessage &message);
 
+/**
+ * @brief Send messages held back by gatewayTransportSend() to the controller
+ */
+void gatewayTransportFlush(void);
+
 /**
  * @brief Check if a new message is available from controller
  * @return true if message available
@@ -79,6 +79,10 @@ MyMessage _ethernetMsg;
 
 #define ARRAY_SIZE(x)  (sizeof(x)/sizeof(x[0]))
 
+#if defined(MY_GATEWAY_LINUX)
+// Filled by bulk reads, see _readFromClient()
+typedef gatewayRxBuffer_t inputBuffer;
+#else
 typedef struct {
 	// Suppress the warning about unused members in this struct because it is used through a complex
 	// set of preprocessor directives
@@ -87,6 +91,7 @@ typedef struct {
 	// cppcheck-suppress unusedStructMember
 	uint8_t idx;
 } inputBuffer;
+#endif
 
 #if defined(MY_GATEWAY_ESP8266) || defined(MY_GATEWAY_ESP32)
 // Some re-defines to make code more readable below
@@ -239,7 +244,9 @@ bool gatewayTransportInit(void)
 bool gatewayTransportSend(MyMessage &message)
 {
 	int nbytes = 0;
-	char *_ethernetMessage = protocolMyMessage2Serial(message);
+	char _ethernetMessage[MY_GATEWAY_MAX_SEND_LENGTH];
+	const size_t length = protocolMyMessage2Serial(_ethernetMessage, sizeof(_ethernetMessage),
+	                      message);
 
 	setIndication(INDICATION_GW_TX);
 
@@ -251,7 +258,7 @@ bool gatewayTransportSend(MyMessage &message)
 #else
 	_ethernetServer.beginPacket(_ethernetControllerIP, MY_PORT);
 #endif /* End of MY_CONTROLLER_URL_ADDRESS */
-	_ethernetServer.write((uint8_t *)_ethernetMessage, strlen(_ethernetMessage));
+	_ethernetServer.write((uint8_t *)_ethernetMessage, length);
 	// returns 1 if the packet was sent successfully
 	nbytes = _ethernetServer.endPacket();
 #else /* Else part of MY_USE_UDP */
@@ -274,28 +281,76 @@ bool gatewayTransportSend(MyMessage &message)
 			return false;
 		}
 	}
-	nbytes = client.write((const uint8_t *)_ethernetMessage, strlen(_ethernetMessage));
+	nbytes = client.write((const uint8_t *)_ethernetMessage, length);
 #endif /* End of MY_USE_UDP */
 #else /* Else part of MY_GATEWAY_CLIENT_MODE */
 	// Send message to connected clients
 #if defined(MY_GATEWAY_ESP8266) || defined(MY_GATEWAY_ESP32)
 	for (uint8_t i = 0; i < ARRAY_SIZE(clients); i++) {
 		if (clients[i] && clients[i].connected()) {
-			nbytes += clients[i].write((uint8_t *)_ethernetMessage, strlen(_ethernetMessage));
+			nbytes += clients[i].write((uint8_t *)_ethernetMessage, length);
 		}
 	}
 #else /* Else part of MY_GATEWAY_ESPxx*/
-	nbytes = _ethernetServer.write(_ethernetMessage);
+	nbytes = _ethernetServer.write((const uint8_t *)_ethernetMessage, length);
 #endif /* End of MY_GATEWAY_ESPxx */
 #endif /* End of MY_GATEWAY_CLIENT_MODE */
 	_w5100_spi_en(false);
 	return (nbytes > 0);
 }
 
+void gatewayTransportFlush(void)
+{
+	// messages are written immediately
+}
+
 #if defined(MY_USE_UDP)
 // Nothing to do here
-#else
-#if (defined(MY_GATEWAY_ESP8266) || defined(MY_GATEWAY_ESP32) || defined(MY_GATEWAY_LINUX)) && !defined(MY_GATEWAY_CLIENT_MODE)
+#elif defined(MY_GATEWAY_LINUX)
+// Read as much as the socket has in one call and scan the buffer for complete lines
+bool _readFromBuffer(EthernetClient &ethernetClient, inputBuffer &buffer, char *&line,
+                     size_t &length)
+{
+	while (!(line = gatewayRxBufferGetLine(buffer, length))) {
+		const int nbytes = ethernetClient.read((uint8_t *)buffer.data + buffer.tail,
+		                                       gatewayRxBufferCompact(buffer));
+		if (nbytes <= 0) {
+			return false;
+		}
+		buffer.tail += nbytes;
+	}
+	return true;
+}
+
+#if defined(MY_GATEWAY_CLIENT_MODE)
+bool _readFromClient(void)
+{
+	char *line;
+	size_t length;
+	while (_readFromBuffer(client, inputString, line, length)) {
+		GATEWAY_DEBUG(PSTR("GWT:RFC:MSG=%s\n"), line);
+		if (protocolSerial2MyMessage(_ethernetMsg, line, length)) {
+			return true;
+		}
+	}
+	return false;
+}
+#else /* Else part of MY_GATEWAY_CLIENT_MODE */
+bool _readFromClient(uint8_t i)
+{
+	char *line;
+	size_t length;
+	while (_readFromBuffer(clients[i], inputString[i], line, length)) {
+		GATEWAY_DEBUG(PSTR("GWT:RFC:C=%" PRIu8 ",MSG=%s\n"), i, line);
+		if (protocolSerial2MyMessage(_ethernetMsg, line, length)) {
+			return true;
+		}
+	}
+	return false;
+}
+#endif /* End of MY_GATEWAY_CLIENT_MODE */
+#else /* Else part of MY_GATEWAY_LINUX */
+#if (defined(MY_GATEWAY_ESP8266) || defined(MY_GATEWAY_ESP32)) && !defined(MY_GATEWAY_CLIENT_MODE)
 bool _readFromClient(uint8_t i)
 {
 	while (clients[i].connected() && clients[i].available()) {
@@ -324,7 +379,7 @@ bool _readFromClient(uint8_t i)
 	}
 	return false;
 }
-#else /* Else part of MY_GATEWAY_ESP8266 || MY_GATEWAY_LINUX || !MY_GATEWAY_CLIENT_MODE */
+#else /* Else part of MY_GATEWAY_ESP8266 || !MY_GATEWAY_CLIENT_MODE */
 bool _readFromClient(void)
 {
 	while (client.connected() && client.available()) {
@@ -354,7 +409,7 @@ bool _readFromClient(void)
 	}
 	return false;
 }
-#endif /* End of MY_GATEWAY_ESP8266 || MY_GATEWAY_LINUX || !MY_GATEWAY_CLIENT_MODE */
+#endif /* End of MY_GATEWAY_ESP8266 || !MY_GATEWAY_CLIENT_MODE */
 #endif /* End of MY_USE_UDP */
 
 bool gatewayTransportAvailable(void)
@@ -419,7 +474,12 @@ bool gatewayTransportAvailable(void)
 			//check if there are any new clients
 			if (_ethernetServer.hasClient()) {
 				clients[i] = _ethernetServer.available();
+#if defined(MY_GATEWAY_LINUX)
+				inputString[i].head = 0;
+				inputString[i].tail = 0;
+#else
 				inputString[i].idx = 0;
+#endif
 				GATEWAY_DEBUG(PSTR("GWT:TSA:C=%" PRIu8 ",CONNECTED\n"), i);
 				gatewayTransportSend(buildGw(_msgTmp, I_GATEWAY_READY).set(MSG_GW_STARTUP_COMPLETE));
 				// Send presentation of locally attached sensors (and node if applicable)
@@ -114,8 +114,13 @@ static EthernetClient _MQTT_ethClient;
 
 static PubSubClient _MQTT_client(_MQTT_ethClient);
 static bool _MQTT_connecting = true;
-static bool _MQTT_available = false;
 static MyMessage _MQTT_msg;
+// Parsed inbound messages. Producer (PubSubClient callback) and consumer both run
+// in the main loop, so the queue needs neither locks nor atomics.
+static MyMessage _MQTT_rxQueue[MY_MQTT_CLIENT_RX_QUEUE_SIZE];
+static uint8_t _MQTT_rxQueueTail = 0;		// oldest message
+static uint8_t _MQTT_rxQueueCount = 0;
+static uint32_t _MQTT_rxQueueOverflow = 0;
 
 // cppcheck-suppress constParameter
 bool gatewayTransportSend(MyMessage &message)
@@ -124,7 +129,10 @@ bool gatewayTransportSend(MyMessage &message)
 		return false;
 	}
 	setIndication(INDICATION_GW_TX);
-	char *topic = protocolMyMessage2MQTT(MY_MQTT_PUBLISH_TOPIC_PREFIX, message);
+	char topic[MY_GATEWAY_MAX_SEND_LENGTH];
+	char payload[MAX_PAYLOAD_SIZE * 2 + 1];
+	(void)protocolMyMessage2MQTT(topic, sizeof(topic), MY_MQTT_PUBLISH_TOPIC_PREFIX, message);
+	const size_t length = protocolMyMessagePayload2String(payload, sizeof(payload), message);
 	GATEWAY_DEBUG(PSTR("GWT:TPS:TOPIC=%s,MSG SENT\n"), topic);
 #if defined(MY_MQTT_CLIENT_PUBLISH_RETAIN)
 	const bool retain = message.getCommand() == C_SET ||
@@ -132,13 +140,29 @@ bool gatewayTransportSend(MyMessage &message)
 #else
 	const bool retain = false;
 #endif /* End of MY_MQTT_CLIENT_PUBLISH_RETAIN */
-	return _MQTT_client.publish(topic, message.getString(_convBuffer), retain);
+	return _MQTT_client.publish(topic, (const uint8_t *)payload, length, retain);
+}
+
+void gatewayTransportFlush(void)
+{
+	if (!_MQTT_client.flushBatch()) {
+		GATEWAY_DEBUG(PSTR("!GWT:TFL:FAIL\n"));
+	}
 }
 
 void incomingMQTT(char *topic, uint8_t *payload, unsigned int length)
 {
 	GATEWAY_DEBUG(PSTR("GWT:IMQ:TOPIC=%s, MSG RECEIVED\n"), topic);
-	_MQTT_available = protocolMQTT2MyMessage(_MQTT_msg, topic, payload, length);
+	if (_MQTT_rxQueueCount >= MY_MQTT_CLIENT_RX_QUEUE_SIZE) {
+		_MQTT_rxQueueOverflow++;
+		GATEWAY_DEBUG(PSTR("!GWT:IMQ:QUEUE FULL,DROPPED=%" PRIu32 "\n"), _MQTT_rxQueueOverflow);
+		return;
+	}
+	const uint8_t head = (uint8_t)((_MQTT_rxQueueTail + _MQTT_rxQueueCount) %
+	                               MY_MQTT_CLIENT_RX_QUEUE_SIZE);
+	if (protocolMQTT2MyMessage(_MQTT_rxQueue[head], topic, payload, length)) {
+		_MQTT_rxQueueCount++;
+	}
 	setIndication(INDICATION_GW_RX);
 }
 
@@ -249,6 +273,11 @@ bool gatewayTransportInit(void)
 #endif /* End of MY_CONTROLLER_IP_ADDRESS */
 
 	_MQTT_client.setCallback(incomingMQTT);
+#if (MY_MQTT_CLIENT_PUBLISH_BATCH_SIZE > 0)
+	if (!_MQTT_client.setBatchBufferSize(MY_MQTT_CLIENT_PUBLISH_BATCH_SIZE)) {
+		GATEWAY_DEBUG(PSTR("!GWT:TIN:BATCH BUFFER FAIL\n"));
+	}
+#endif
 
 #if defined(MY_GATEWAY_ESP8266) || defined(MY_GATEWAY_ESP32)
 	// Turn off access point
@@ -295,13 +324,27 @@ bool gatewayTransportAvailable(void)
 		}
 		return false;
 	}
-	_MQTT_client.loop();
-	return _MQTT_available;
+	// PubSubClient handles one packet per loop(), drain the socket while there is room
+	while (_MQTT_rxQueueCount < MY_MQTT_CLIENT_RX_QUEUE_SIZE && _MQTT_client.loop() &&
+	        _MQTT_ethClient.available()) {
+		// keep reading
+	}
+	return _MQTT_rxQueueCount > 0;
 }
 
 MyMessage & gatewayTransportReceive(void)
 {
-	// Return the last parsed message
-	_MQTT_available = false;
+	// Return the oldest parsed message
+	if (_MQTT_rxQueueCount > 0) {
+		_MQTT_msg = _MQTT_rxQueue[_MQTT_rxQueueTail];
+		_MQTT_rxQueueTail = (uint8_t)((_MQTT_rxQueueTail + 1) % MY_MQTT_CLIENT_RX_QUEUE_SIZE);
+		_MQTT_rxQueueCount--;
+#if defined(__linux__)
+		if (_MQTT_rxQueueCount > 0) {
+			// more messages queued, the next pass must not block
+			EventLoop.wakeup();
+		}
+#endif
+	}
 	return _MQTT_msg;
 }
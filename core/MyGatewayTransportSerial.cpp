@@ -26,19 +26,30 @@
 // global variables
 extern MyMessage _msgTmp;
 
+#if defined(MY_LINUX_SERIAL_PORT)
+gatewayRxBuffer_t _serialRxBuffer;    // A buffer for incoming commands from serial interface, filled by bulk reads
+#else
 char _serialInputString[MY_GATEWAY_MAX_RECEIVE_LENGTH];    // A buffer for incoming commands from serial interface
 uint8_t _serialInputPos;
+#endif
 MyMessage _serialMsg;
 
 // cppcheck-suppress constParameter
 bool gatewayTransportSend(MyMessage &message)
 {
+	char buffer[MY_GATEWAY_MAX_SEND_LENGTH];
+	const size_t length = protocolMyMessage2Serial(buffer, sizeof(buffer), message);
 	setIndication(INDICATION_GW_TX);
-	MY_SERIALDEVICE.print(protocolMyMessage2Serial(message));
+	(void)MY_SERIALDEVICE.write((const uint8_t *)buffer, length);
 	// Serial print is always successful
 	return true;
 }
 
+void gatewayTransportFlush(void)
+{
+	// messages are written immediately
+}
+
 bool gatewayTransportInit(void)
 {
 	(void)gatewayTransportSend(buildGw(_msgTmp, I_GATEWAY_READY).set(MSG_GW_STARTUP_COMPLETE));
@@ -47,6 +58,28 @@ bool gatewayTransportInit(void)
 	return true;
 }
 
+#if defined(MY_LINUX_SERIAL_PORT)
+bool gatewayTransportAvailable(void)
+{
+	char *line;
+	size_t length;
+	for (;;) {
+		while (!(line = gatewayRxBufferGetLine(_serialRxBuffer, length))) {
+			const int nbytes = MY_SERIALDEVICE.read((uint8_t *)_serialRxBuffer.data + _serialRxBuffer.tail,
+			                                        gatewayRxBufferCompact(_serialRxBuffer));
+			if (nbytes <= 0) {
+				return false;
+			}
+			_serialRxBuffer.tail += nbytes;
+		}
+		// invalid lines are skipped, continue with the next buffered line
+		if (protocolSerial2MyMessage(_serialMsg, line, length)) {
+			setIndication(INDICATION_GW_RX);
+			return true;
+		}
+	}
+}
+#else
 bool gatewayTransportAvailable(void)
 {
 	while (MY_SERIALDEVICE.available()) {
@@ -58,11 +91,12 @@ bool gatewayTransportAvailable(void)
 			if (inChar == '\n') {
 				_serialInputString[_serialInputPos] = 0;
 				const bool ok = protocolSerial2MyMessage(_serialMsg, _serialInputString);
+				_serialInputPos = 0;
 				if (ok) {
 					setIndication(INDICATION_GW_RX);
+					return true;
 				}
-				_serialInputPos = 0;
-				return ok;
+				// empty or invalid line, continue with the next buffered input
 			} else {
 				// add it to the inputString:
 				_serialInputString[_serialInputPos] = inChar;
@@ -75,6 +109,7 @@ bool gatewayTransportAvailable(void)
 	}
 	return false;
 }
+#endif
 
 MyMessage & gatewayTransportReceive(void)
 {
@@ -87,6 +87,13 @@ void ledsProcess()
 	state = (countErr & (LED_ON_OFF_RATIO-1)) ? LED_ON : LED_OFF;
 	hwDigitalWrite(MY_DEFAULT_ERR_LED_PIN, state);
 #endif
+
+#if defined(__linux__)
+	if (ledsBlinking()) {
+		// wake up the main loop for the next blinking step
+		EventLoop.setTimeout(LED_PROCESS_INTERVAL_MS);
+	}
+#endif
 }
 
 void ledsBlinkRx(uint8_t cnt)
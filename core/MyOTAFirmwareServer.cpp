@@ -0,0 +1,203 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+
+#include "MyOTAFirmwareServer.h"
+
+// global variables
+extern MyMessage _msg;
+extern MyMessage _msgTmp;
+
+// local variables
+static FirmwareCache _firmwareServerCache;
+static firmwareServerNode_t _firmwareServerNodes[256];
+
+// wire formats, see MyOTAFirmwareUpdate.h
+#define FIRMWARE_SERVER_FEATURE_DELTA	(0x01u)
+#define FIRMWARE_SERVER_MAX_DELTA		(0x8000u)
+
+typedef struct {
+	uint16_t type;
+	uint16_t version;
+	uint16_t blocks;
+	uint16_t crc;
+	uint16_t BLVersion;
+	uint8_t blockSize;
+	uint8_t img_commited;
+	uint16_t img_revision;
+	uint32_t img_build_num;
+	uint8_t windowSize;
+	uint8_t features;
+} __attribute__((packed)) firmwareServerConfigRequest_t;
+
+typedef struct {
+	uint16_t type;
+	uint16_t version;
+	uint16_t blocks;
+	uint16_t crc;
+	uint16_t patchBlocks;
+} __attribute__((packed)) firmwareServerConfigResponse_t;
+
+typedef struct {
+	uint16_t type;
+	uint16_t version;
+	uint16_t block;
+	uint8_t window;
+	uint16_t received;
+} __attribute__((packed)) firmwareServerBlockRequest_t;
+
+typedef struct {
+	uint16_t type;
+	uint16_t version;
+	uint16_t block;
+	uint8_t data[16];
+} __attribute__((packed)) firmwareServerBlockResponse_t;
+
+static void firmwareServerNotify(const char *fmt, ...)
+{
+	(void)build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL, I_LOG_MESSAGE);
+	va_list args;
+	va_start(args, fmt);
+	const int n = vsnprintf_P(_msgTmp.data, sizeof(_msgTmp.data), fmt, args);
+	va_end(args);
+	if (n < 1) {
+		return;
+	}
+	(void)_msgTmp.setLength(n < (int)MAX_PAYLOAD_SIZE ? n : MAX_PAYLOAD_SIZE);
+	(void)_msgTmp.setPayloadType(P_STRING);
+	(void)gatewayTransportSend(_msgTmp);
+}
+
+bool firmwareServerInit(const char *directory)
+{
+	(void)memset(_firmwareServerNodes, 0, sizeof(_firmwareServerNodes));
+	return _firmwareServerCache.load(directory) > 0;
+}
+
+bool firmwareServerProcess(void)
+{
+	if (!_firmwareServerCache.size()) {
+		return false;
+	}
+	const uint8_t sender = _msg.getSender();
+	const uint8_t length = _msg.getLength();
+	firmwareServerNode_t *node = &_firmwareServerNodes[sender];
+
+	if (_msg.getType() == ST_FIRMWARE_CONFIG_REQUEST) {
+		firmwareServerConfigRequest_t request;
+		(void)memset(&request, 0, sizeof(request));
+		(void)memcpy(&request, _msg.data, length < sizeof(request) ? length : sizeof(request));
+		const FirmwareImage *image = _firmwareServerCache.latest(request.type);
+		if (length < offsetof(firmwareServerConfigRequest_t, blockSize) || !image) {
+			return false;
+		}
+		// protocol 3.0 nodes use 16 byte blocks, 3.1+ report the block size
+		uint8_t blockSize = 16;
+		if ((request.BLVersion >> 8) >= 1 && length > offsetof(firmwareServerConfigRequest_t, blockSize)) {
+			blockSize = request.blockSize;
+		}
+		const size_t blocks = blockSize ? image->data.size() / blockSize : 0;
+		if ((blockSize != 16 && blockSize != 8) || blocks > 0xFFFF) {
+			GATEWAY_DEBUG(PSTR("!GWT:FWS:BSZ,N=%" PRIu8 ",S=%" PRIu8 "\n"), sender, blockSize);
+			return false;
+		}
+		if (request.version == image->version && request.blocks == blocks && request.crc == image->crc) {
+			GATEWAY_DEBUG(PSTR("GWT:FWS:UTD,N=%" PRIu8 "\n"), sender);
+			return false;
+		}
+		node->type = image->type;
+		node->version = image->version;
+		node->blocks = (uint16_t)blocks;
+		node->data = &image->data[0];
+		node->blockSize = blockSize;
+		node->progress = 0;
+		firmwareServerConfigResponse_t response;
+		response.type = image->type;
+		response.version = image->version;
+		response.blocks = (uint16_t)blocks;
+		response.crc = image->crc;
+		response.patchBlocks = 0;
+		// patch against the running image if the node supports it and the image is known
+		const FirmwareImage *base = _firmwareServerCache.find(request.type, request.version);
+		if ((request.BLVersion >> 8) >= 2 && length > offsetof(firmwareServerConfigRequest_t, features) &&
+		        (request.features & FIRMWARE_SERVER_FEATURE_DELTA) && base && base != image &&
+		        base->crc == request.crc && base->data.size() == (size_t)request.blocks * blockSize) {
+			const std::vector<uint8_t> *patch = _firmwareServerCache.delta(base, image);
+			if (patch && patch->size() <= FIRMWARE_SERVER_MAX_DELTA) {
+				node->blocks = response.patchBlocks = (uint16_t)(patch->size() / blockSize);
+				node->data = &(*patch)[0];
+				GATEWAY_DEBUG(PSTR("GWT:FWS:DELTA,N=%" PRIu8 ",P=%" PRIu16 "\n"), sender, response.patchBlocks);
+			}
+		}
+		GATEWAY_DEBUG(PSTR("GWT:FWS:CFG,N=%" PRIu8 ",T=%" PRIu16 ",V=%" PRIu16 ",B=%" PRIu16 "\n"), sender,
+		              response.type, response.version, response.blocks);
+		(void)_sendRoute(build(_msgTmp, sender, NODE_SENSOR_ID, C_STREAM, ST_FIRMWARE_CONFIG_RESPONSE,
+		                       false).set(&response, response.patchBlocks ? sizeof(response) :
+		                                  offsetof(firmwareServerConfigResponse_t, patchBlocks)));
+		firmwareServerNotify(PSTR("FWS:N=%" PRIu8 ",T=%" PRIu16 ",V=%" PRIu16), sender, response.type,
+		                     response.version);
+		return true;
+	}
+
+	if (_msg.getType() == ST_FIRMWARE_REQUEST) {
+		firmwareServerBlockRequest_t request;
+		if (length < offsetof(firmwareServerBlockRequest_t, window)) {
+			return false;
+		}
+		(void)memset(&request, 0, sizeof(request));
+		(void)memcpy(&request, _msg.data, length < sizeof(request) ? length : sizeof(request));
+		if (!node->blockSize || node->type != request.type || node->version != request.version) {
+			// update not started by gateway, controller serves it
+			return false;
+		}
+		if (request.block >= node->blocks) {
+			// not part of this update, nothing to send
+			GATEWAY_DEBUG(PSTR("!GWT:FWS:BLK,N=%" PRIu8 ",B=%" PRIu16 "\n"), sender, request.block);
+			return true;
+		}
+		uint8_t window = 1;
+		if (length >= sizeof(request) && request.window) {
+			window = request.window < MY_OTA_FIRMWARE_SERVER_MAX_WINDOW ? request.window :
+			         MY_OTA_FIRMWARE_SERVER_MAX_WINDOW;
+		}
+		GATEWAY_DEBUG(PSTR("GWT:FWS:REQ,N=%" PRIu8 ",B=%" PRIu16 ",W=%" PRIu8 "\n"), sender, request.block,
+		              window);
+		firmwareServerBlockResponse_t response;
+		response.type = request.type;
+		response.version = request.version;
+		for (uint8_t i = 0; i < window && i <= request.block; i++) {
+			if (request.received & (1u << i)) {
+				continue;
+			}
+			response.block = request.block - i;
+			(void)memcpy(response.data, &node->data[(size_t)response.block * node->blockSize],
+			             node->blockSize);
+			(void)_sendRoute(build(_msgTmp, sender, NODE_SENSOR_ID, C_STREAM, ST_FIRMWARE_RESPONSE,
+			                       false).set(&response, offsetof(firmwareServerBlockResponse_t, data) + node->blockSize));
+		}
+		// blocks are requested top down
+		const uint8_t progress = (uint8_t)((uint32_t)(node->blocks - request.block) * 100u / node->blocks);
+		if (progress / 10u > node->progress / 10u) {
+			node->progress = progress;
+			firmwareServerNotify(PSTR("FWS:N=%" PRIu8 ",P=%" PRIu8 "%%"), sender, progress);
+		}
+		return true;
+	}
+	return false;
+}
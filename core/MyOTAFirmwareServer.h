@@ -0,0 +1,94 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+
+/**
+* @file MyOTAFirmwareServer.h
+*
+* @defgroup MyOTAFirmwareServergrp MyOTAFirmwareServer
+* @ingroup internals
+* @{
+*
+* Linux gateways serve OTA firmware updates from an in-memory image cache
+* instead of relaying every block request to the controller. Images are loaded
+* from the directory set with firmware_dir in the gateway configuration file,
+* see @ref FirmwareCache for the file naming.
+*
+* - A config request (@ref ST_FIRMWARE_CONFIG_REQUEST) of a node whose type has a
+*   newer or different cached image is answered by the gateway, otherwise it is
+*   handed over to the controller as before.
+* - Block requests (@ref ST_FIRMWARE_REQUEST) of an update started by the gateway are
+*   answered from the cache, including windowed requests of bootloader protocol 3.2.
+* - Nodes announcing delta support get a patch against their running image if that
+*   image is cached too and the patch is smaller than the new image.
+* - The controller is notified with I_LOG_MESSAGE messages when an update starts and
+*   every 10% of progress.
+*
+* MyOTAFirmwareServer debug log messages:
+*
+* |E| SYS | SUB | Message                       | Comment
+* |-|-----|-----|-------------------------------|----------------------------------------------------------
+* | | GWT | FWS | CFG,N=%d,T=%d,V=%d,B=%d       | FW update of node (N) started, type (T), version (V), blocks (B)
+* | | GWT | FWS | DELTA,N=%d,P=%d               | FW update of node (N) is sent as delta patch of (P) blocks
+* | | GWT | FWS | UTD,N=%d                      | Node (N) already runs the cached image, request forwarded
+* |!| GWT | FWS | BSZ,N=%d,S=%d                 | Node (N) reports unsupported block size (S), request forwarded
+* | | GWT | FWS | REQ,N=%d,B=%d,W=%d            | Block request of node (N), first block (B), window size (W)
+*
+* @brief API declaration for MyOTAFirmwareServer
+*/
+
+#ifndef MyOTAFirmwareServer_h
+#define MyOTAFirmwareServer_h
+
+#include "MySensorsCore.h"
+#include "FirmwareCache.h"
+
+#define MY_OTA_FIRMWARE_SERVER_MAX_WINDOW	(16u)	//!< Max blocks served per windowed request
+
+/**
+* @brief Update of a single node served by the gateway
+*/
+typedef struct {
+	uint16_t type;								//!< Firmware type
+	uint16_t version;							//!< Firmware version
+	uint16_t blocks;							//!< Number of blocks served, image or delta patch
+	const uint8_t *data;						//!< Data served, image or delta patch
+	uint8_t blockSize;							//!< Block size reported by the node, 0 if no update is served
+	uint8_t progress;							//!< Last progress reported to the controller (%)
+} firmwareServerNode_t;
+
+/**
+ * @brief Load firmware images into the cache
+ *
+ * @param directory Directory containing the firmware images
+ * @return true if at least one image was loaded
+ */
+bool firmwareServerInit(const char *directory);
+/**
+ * @brief Serve firmware requests from the cache
+ *
+ * Processes the C_STREAM message in _msg
+ *
+ * @return true if the request was answered by the gateway, false if it has to be handed over to the controller
+ */
+bool firmwareServerProcess(void);
+
+#endif
+
+/** @}*/
@@ -34,32 +34,110 @@ SPIFlash _flash(MY_OTA_FLASH_SS, MY_OTA_FLASH_JDECID);
 #ifndef MCUBOOT_PRESENT
 #define _flash_initialize()	_flash.initialize()
 #define _flash_readByte(addr)	_flash.readByte(addr)
+#define _flash_readBytes(addr, buf, len)	_flash.readBytes(addr, buf, len)
 #define _flash_writeBytes( dstaddr, data, size) _flash.writeBytes( dstaddr, data, size)
-#define  _flash_blockErase32K(num)  _flash.blockErase32K(num)
+#define _flash_writeBegin(addr, len)	_flash.writeBufferBegin(addr, len)
+#define _flash_writeBuffered(addr, data, size)	_flash.writeBuffered(addr, data, size)
+#define _flash_writeProcess()	_flash.writeBufferProcess()
+#define _flash_writeFlush()	_flash.writeBufferFlush()
 #define _flash_busy() _flash.busy()
 #else
 #define _flash_initialize()	true
 #define _flash_readByte(addr)	(*((uint8_t *)(addr)))
-#define  _flash_blockErase32K(num)  Flash.erase((uint32_t *)FLASH_AREA_IMAGE_1_OFFSET_0, FLASH_AREA_IMAGE_1_SIZE_0)
+#define _flash_readBytes(addr, buf, len)	(void)memcpy(buf, (const void *)(addr), len)
+#define _flash_writeBegin(addr, len)  Flash.erase((uint32_t *)FLASH_AREA_IMAGE_1_OFFSET_0, FLASH_AREA_IMAGE_1_SIZE_0)
+#define _flash_writeProcess()
+#define _flash_writeFlush()
 #define _flash_busy() false
 #endif
 
+#ifdef MY_OTA_DELTA_UPDATE_FEATURE
+// Map running image, delta patches are applied against it
+#if defined(ARDUINO_ARCH_AVR) && defined(RAMPZ)
+#define _running_readByte(addr)	pgm_read_byte_far(addr)
+#elif defined(ARDUINO_ARCH_AVR)
+#define _running_readByte(addr)	pgm_read_byte((uint16_t)(addr))
+#else
+#define _running_readByte(addr)	(*((const uint8_t *)(uintptr_t)(addr)))
+#endif
+#endif
+
 LOCAL nodeFirmwareConfig_t _nodeFirmwareConfig;
 LOCAL bool _firmwareUpdateOngoing = false;
 LOCAL uint32_t _firmwareLastRequest;
 LOCAL uint16_t _firmwareBlock;
 LOCAL uint8_t _firmwareRetry;
+LOCAL uint16_t _firmwareCrc;				// FW CRC run backwards over the blocks stored so far
+#ifdef MY_OTA_WINDOWED_TRANSFER
+LOCAL uint16_t _firmwareWindowMap;		// received blocks within window, bit n = block (_firmwareBlock - 1 - n)
+LOCAL uint16_t _firmwareWindowEnd;		// lowest block index covered by last request
+#endif
+#ifdef MY_OTA_DELTA_UPDATE_FEATURE
+LOCAL bool _firmwareDeltaCapable = false;	// running image matches _nodeFirmwareConfig
+LOCAL uint16_t _firmwareDeltaBlocks;		// patch blocks of ongoing delta update, 0 if full image
+LOCAL uint16_t _firmwareDeltaBaseBlocks;	// running image blocks
+LOCAL uint16_t _firmwareDeltaBaseCrc;		// running image CRC
+LOCAL bool _firmwareApplyDelta(void);
+#endif
 LOCAL bool _firmwareResponse(uint16_t block, uint8_t *data);
+LOCAL void _firmwareCrcBlock(const uint16_t block, const uint8_t *data);
+
+// CRC16 (poly 0xA001) nibble table, 4 bit steps per entry
+static const uint16_t _firmwareCrcTable[16] PROGMEM = {
+	0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+	0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400
+};
+// _firmwareCrcTable index by upper nibble of the entry, used to run the CRC backwards
+static const uint8_t _firmwareCrcIndex[16] PROGMEM = {
+	0x0, 0x3, 0x6, 0x5, 0xF, 0xC, 0x9, 0xA, 0xE, 0xD, 0x8, 0xB, 0x1, 0x2, 0x7, 0x4
+};
+
+LOCAL uint16_t _firmwareCrc16(uint16_t crc, const uint8_t data)
+{
+	crc = (crc >> 4) ^ pgm_read_word(&_firmwareCrcTable[(crc ^ data) & 0x0F]);
+	crc = (crc >> 4) ^ pgm_read_word(&_firmwareCrcTable[(crc ^ (data >> 4)) & 0x0F]);
+	return crc;
+}
+
+// inverse of _firmwareCrc16(), returns the CRC before data was added
+LOCAL uint16_t _firmwareCrc16Reverse(uint16_t crc, const uint8_t data)
+{
+	uint8_t index = pgm_read_byte(&_firmwareCrcIndex[crc >> 12]);
+	crc = ((crc ^ pgm_read_word(&_firmwareCrcTable[index])) << 4) | (index ^ (data >> 4));
+	index = pgm_read_byte(&_firmwareCrcIndex[crc >> 12]);
+	crc = ((crc ^ pgm_read_word(&_firmwareCrcTable[index])) << 4) | (index ^ (data & 0x0F));
+	return crc;
+}
 
 LOCAL void readFirmwareSettings(void)
 {
 	hwReadConfigBlock((void*)&_nodeFirmwareConfig, (void*)EEPROM_FIRMWARE_TYPE_ADDRESS,
 	                  sizeof(nodeFirmwareConfig_t));
+#ifdef MY_OTA_DELTA_UPDATE_FEATURE
+	// delta updates require the running image to match the stored config
+	const uint32_t size = (uint32_t)_nodeFirmwareConfig.blocks * FIRMWARE_BLOCK_SIZE;
+	_firmwareDeltaCapable = false;
+#if defined(FLASHEND)
+	if (size && size <= (uint32_t)FLASHEND + 1) {
+#else
+	if (size && _nodeFirmwareConfig.blocks != 0xFFFF) {
+#endif
+		uint16_t crc = ~0;
+		for (uint32_t i = 0; i < size; ++i) {
+			crc = _firmwareCrc16(crc, _running_readByte(i));
+		}
+		_firmwareDeltaCapable = (crc == _nodeFirmwareConfig.crc);
+	}
+#endif
 }
 
 LOCAL void firmwareOTAUpdateRequest(void)
 {
 	const uint32_t enterMS = hwMillis();
+	if (_firmwareUpdateOngoing) {
+		// erase flash ahead of the blocks to come while waiting for them
+		_flash_writeProcess();
+	}
 	if (_firmwareUpdateOngoing && (enterMS - _firmwareLastRequest > MY_OTA_RETRY_DELAY)) {
 		if (!_firmwareRetry) {
 			setIndication(INDICATION_ERR_FW_TIMEOUT);
@@ -70,6 +148,22 @@ LOCAL void firmwareOTAUpdateRequest(void)
 		}
 		_firmwareRetry--;
 		_firmwareLastRequest = enterMS;
+#ifdef MY_OTA_WINDOWED_TRANSFER
+		// Time to (re-)request firmware window from controller, skip blocks already received
+		requestFirmwareWindow_t firmwareRequest;
+		firmwareRequest.type = _nodeFirmwareConfig.type;
+		firmwareRequest.version = _nodeFirmwareConfig.version;
+		firmwareRequest.block = (_firmwareBlock - 1);
+		firmwareRequest.window = (uint8_t)(_firmwareBlock < MY_OTA_WINDOW_SIZE ? _firmwareBlock :
+		                                   MY_OTA_WINDOW_SIZE);
+		firmwareRequest.received = _firmwareWindowMap;
+		_firmwareWindowEnd = _firmwareBlock - firmwareRequest.window;
+		OTA_DEBUG(PSTR("OTA:FRQ:FW REQ,T=%04" PRIX16 ",V=%04" PRIX16 ",B=%04" PRIX16 ",W=%02" PRIX8 ",M=%04"
+		               PRIX16 "\n"), _nodeFirmwareConfig.type, _nodeFirmwareConfig.version, _firmwareBlock - 1,
+		          firmwareRequest.window, _firmwareWindowMap); // request FW update window
+		(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_STREAM, ST_FIRMWARE_REQUEST,
+		                       false).set(&firmwareRequest, sizeof(requestFirmwareWindow_t)));
+#else
 		// Time to (re-)request firmware block from controller
 		requestFirmwareBlock_t firmwareRequest;
 		firmwareRequest.type = _nodeFirmwareConfig.type;
@@ -80,6 +174,7 @@ LOCAL void firmwareOTAUpdateRequest(void)
 		          _nodeFirmwareConfig.version, _firmwareBlock - 1); // request FW update block
 		(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_STREAM, ST_FIRMWARE_REQUEST,
 		                       false).set(&firmwareRequest, sizeof(requestFirmwareBlock_t)));
+#endif
 	}
 }
 
@@ -93,21 +188,52 @@ LOCAL bool firmwareOTAUpdateProcess(void)
 		nodeFirmwareConfig_t *firmwareConfigResponse = (nodeFirmwareConfig_t *)_msg.data;
 		// compare with current node configuration, if they differ, start FW fetch process
 		if (memcmp(&_nodeFirmwareConfig, firmwareConfigResponse, sizeof(nodeFirmwareConfig_t))) {
+#ifdef MY_OTA_DELTA_UPDATE_FEATURE
+			_firmwareDeltaBlocks = 0;
+			if (_msg.getLength() >= sizeof(replyFirmwareConfigDelta_t)) {
+				const uint16_t patchBlocks = ((replyFirmwareConfigDelta_t *)_msg.data)->patchBlocks;
+				if (!_firmwareDeltaCapable || !patchBlocks ||
+				        (uint32_t)patchBlocks * FIRMWARE_BLOCK_SIZE > 0x8000ul) {
+					setIndication(INDICATION_ERR_FW_FLASH_INIT);
+					OTA_DEBUG(PSTR("!OTA:FWP:DELTA REJECTED\n"));
+					return true;
+				}
+				_firmwareDeltaBlocks = patchBlocks;
+				_firmwareDeltaBaseBlocks = _nodeFirmwareConfig.blocks;
+				_firmwareDeltaBaseCrc = _nodeFirmwareConfig.crc;
+				OTA_DEBUG(PSTR("OTA:FWP:UPDATE DELTA,P=%04" PRIX16 "\n"), patchBlocks);	// delta FW update initiated
+			}
+#endif
 			setIndication(INDICATION_FW_UPDATE_START);
 			OTA_DEBUG(PSTR("OTA:FWP:UPDATE\n"));	// FW update initiated
 			// copy new FW config
 			(void)memcpy(&_nodeFirmwareConfig, firmwareConfigResponse, sizeof(nodeFirmwareConfig_t));
+			// blocks arrive in descending order, the CRC is run backwards from the expected value
+			_firmwareCrc = _nodeFirmwareConfig.crc;
 			// Init flash
 			if (!_flash_initialize()) {
 				setIndication(INDICATION_ERR_FW_FLASH_INIT);
 				OTA_DEBUG(PSTR("!OTA:FWP:FLASH INIT FAIL\n"));	// failed to initialise flash
 				_firmwareUpdateOngoing = false;
 			} else {
-				// erase lower 32K -> max flash size for ATMEGA328
-				_flash_blockErase32K(0);
-				// wait until flash erased
-				while ( _flash_busy() ) {}
+				// image area incl. header, sectors are erased on demand while blocks are written
+				uint32_t writeAddress = 0;
+				uint32_t writeSize = FIRMWARE_START_OFFSET + (uint32_t)_nodeFirmwareConfig.blocks *
+				                     FIRMWARE_BLOCK_SIZE;
 				_firmwareBlock = _nodeFirmwareConfig.blocks;
+#ifdef MY_OTA_DELTA_UPDATE_FEATURE
+				if (_firmwareDeltaBlocks) {
+					// fetch patch, the image area is written when the patch is applied
+					writeAddress = MY_OTA_DELTA_PATCH_OFFSET;
+					writeSize = (uint32_t)_firmwareDeltaBlocks * FIRMWARE_BLOCK_SIZE;
+					_firmwareBlock = _firmwareDeltaBlocks;
+				}
+#endif
+				_flash_writeBegin(writeAddress, writeSize);
+#ifdef MY_OTA_WINDOWED_TRANSFER
+				_firmwareWindowMap = 0;
+				_firmwareWindowEnd = _firmwareBlock;
+#endif
 				_firmwareUpdateOngoing = true;
 				// reset flags
 				_firmwareRetry = MY_OTA_RETRY + 1;
@@ -182,6 +308,15 @@ LOCAL void presentBootloaderInformation(void)
 	requestFirmwareConfig->img_revision = *((uint16_t*)(MCUBOOT_IMAGE_0_IMG_REVISION_ADDR));
 	requestFirmwareConfig->img_build_num = *((uint16_t*)(MCUBOOT_IMAGE_0_IMG_BUILD_NUM_ADDR));
 #endif
+#endif
+#ifdef FIRMWARE_PROTOCOL_32
+	requestFirmwareConfig->windowSize = MY_OTA_WINDOW_SIZE;
+	requestFirmwareConfig->features = 0;
+#ifdef MY_OTA_DELTA_UPDATE_FEATURE
+	if (_firmwareDeltaCapable) {
+		requestFirmwareConfig->features |= FIRMWARE_FEATURE_DELTA;
+	}
+#endif
 #endif
 	_firmwareUpdateOngoing = false;
 	(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_STREAM,
@@ -192,19 +327,17 @@ LOCAL bool isFirmwareUpdateOngoing(void)
 {
 	return _firmwareUpdateOngoing;
 }
-// do a crc16 on the whole received firmware
+// do a crc16 on the whole firmware stored in flash
 LOCAL bool transportIsValidFirmware(void)
 {
+	uint8_t buffer[FIRMWARE_BLOCK_SIZE];
 	// init crc
 	uint16_t crc = ~0;
-	for (uint32_t i = 0; i < _nodeFirmwareConfig.blocks * FIRMWARE_BLOCK_SIZE; ++i) {
-		crc ^= _flash_readByte(i + FIRMWARE_START_OFFSET);
-		for (int8_t j = 0; j < 8; ++j) {
-			if (crc & 1) {
-				crc = (crc >> 1) ^ 0xA001;
-			} else {
-				crc = (crc >> 1);
-			}
+	for (uint16_t block = 0; block < _nodeFirmwareConfig.blocks; ++block) {
+		_flash_readBytes((uint32_t)block * FIRMWARE_BLOCK_SIZE + FIRMWARE_START_OFFSET, buffer,
+		                 FIRMWARE_BLOCK_SIZE);
+		for (uint8_t i = 0; i < FIRMWARE_BLOCK_SIZE; ++i) {
+			crc = _firmwareCrc16(crc, buffer[i]);
 		}
 	}
 	OTA_DEBUG(PSTR("OTA:CRC:B=%04" PRIX16 ",C=%04" PRIX16 ",F=%04" PRIX16 "\n"),
@@ -217,31 +350,46 @@ LOCAL bool _firmwareResponse(uint16_t block, uint8_t *data)
 {
 	if (_firmwareUpdateOngoing) {
 		OTA_DEBUG(PSTR("OTA:FWP:RECV B=%04" PRIX16 "\n"), block);	// received FW block
+#ifdef MY_OTA_WINDOWED_TRANSFER
+		const uint16_t windowOffset = (uint16_t)(_firmwareBlock - 1 - block);
+		if (block >= _firmwareBlock || windowOffset >= MY_OTA_WINDOW_SIZE) {
+#else
 		if (block != _firmwareBlock - 1) {
+#endif
 			OTA_DEBUG(PSTR("!OTA:FWP:WRONG FWB\n"));	// received FW block
 			// wrong firmware block received
 			setIndication(INDICATION_FW_UPDATE_RX_ERR);
 			// no further processing required
 			return true;
 		}
+#ifdef MY_OTA_WINDOWED_TRANSFER
+		if (_firmwareWindowMap & (1u << windowOffset)) {
+			OTA_DEBUG(PSTR("OTA:FWP:DUP B=%04" PRIX16 "\n"), block);	// block already stored
+			return true;
+		}
+#endif
 		setIndication(INDICATION_FW_UPDATE_RX);
 		// Save block to flash
 #ifdef MCUBOOT_PRESENT
-		uint32_t addr = ((size_t)(((_firmwareBlock - 1) * FIRMWARE_BLOCK_SIZE)) + (size_t)(
+		uint32_t addr = ((size_t)((block * FIRMWARE_BLOCK_SIZE)) + (size_t)(
 		                     FIRMWARE_START_OFFSET));
 		if (addr<FLASH_AREA_IMAGE_SCRATCH_OFFSET_0) {
 			Flash.write_block( (uint32_t *)addr, (uint32_t *)data, FIRMWARE_BLOCK_SIZE>>2);
 		}
 #else
-		_flash_writeBytes( ((_firmwareBlock - 1) * FIRMWARE_BLOCK_SIZE) + FIRMWARE_START_OFFSET,
-		                   data, FIRMWARE_BLOCK_SIZE);
+		uint32_t addr = ((uint32_t)block * FIRMWARE_BLOCK_SIZE) + FIRMWARE_START_OFFSET;
+#ifdef MY_OTA_DELTA_UPDATE_FEATURE
+		if (_firmwareDeltaBlocks) {
+			addr = ((uint32_t)block * FIRMWARE_BLOCK_SIZE) + MY_OTA_DELTA_PATCH_OFFSET;
+		}
+#endif
+		// collected into pages, programming overlaps with receiving the next blocks
+		_flash_writeBuffered(addr, data, FIRMWARE_BLOCK_SIZE);
 #endif
-		// wait until flash written
-		while (_flash_busy()) {}
 #ifdef OTA_EXTRA_FLASH_DEBUG
 		{
 			char prbuf[8];
-			uint32_t addr = ((_firmwareBlock - 1) * FIRMWARE_BLOCK_SIZE) + FIRMWARE_START_OFFSET;
+			uint32_t addr = ((uint32_t)block * FIRMWARE_BLOCK_SIZE) + FIRMWARE_START_OFFSET;
 			OTA_DEBUG(PSTR("OTA:FWP:FL DUMP "));
 			sprintf_P(prbuf,PSTR("%04" PRIX16 ":"), (uint16_t)addr);
 			MY_SERIALDEVICE.print(prbuf);
@@ -253,12 +401,42 @@ LOCAL bool _firmwareResponse(uint16_t block, uint8_t *data)
 			OTA_DEBUG(PSTR("\n"));
 		}
 #endif
+#ifdef MY_OTA_WINDOWED_TRANSFER
+		// slide window over consecutively received blocks
+		_firmwareWindowMap |= (1u << windowOffset);
+		while (_firmwareWindowMap & 1u) {
+			_firmwareWindowMap >>= 1;
+			_firmwareBlock--;
+			// blocks received ahead of the window are read back from flash
+			_firmwareCrcBlock(_firmwareBlock, _firmwareBlock == block ? data : NULL);
+		}
+#else
 		_firmwareBlock--;
+		_firmwareCrcBlock(_firmwareBlock, data);
+#endif
 		if (!_firmwareBlock) {
 			// We're done! Do a checksum and reboot.
 			OTA_DEBUG(PSTR("OTA:FWP:FW END\n"));	// received FW block
 			_firmwareUpdateOngoing = false;
-			if (transportIsValidFirmware()) {
+			// program the remaining buffered data
+			_flash_writeFlush();
+			while (_flash_busy()) {}
+			bool imageComplete;
+#ifdef MY_OTA_DELTA_UPDATE_FEATURE
+			if (_firmwareDeltaBlocks) {
+				imageComplete = _firmwareApplyDelta();
+			} else
+#endif
+			{
+				// all blocks matched the FW CRC if the backwards CRC arrived at its initial value
+				OTA_DEBUG(PSTR("OTA:CRC:R=%04" PRIX16 "\n"), _firmwareCrc);
+				imageComplete = (_firmwareCrc == (uint16_t)~0);
+			}
+#ifndef MY_OTA_DISABLE_FLASH_VERIFICATION
+			// re-read the stored image to detect flash write errors
+			imageComplete = imageComplete && transportIsValidFirmware();
+#endif
+			if (imageComplete) {
 				OTA_DEBUG(PSTR("OTA:FWP:CRC OK\n"));	// FW checksum ok
 				// Write the new firmware config to eeprom
 				hwWriteConfigBlock((void*)&_nodeFirmwareConfig, (void*)EEPROM_FIRMWARE_TYPE_ADDRESS,
@@ -279,9 +457,125 @@ LOCAL bool _firmwareResponse(uint16_t block, uint8_t *data)
 		}
 		// reset flags
 		_firmwareRetry = MY_OTA_RETRY + 1;
+#ifdef MY_OTA_WINDOWED_TRANSFER
+		// request next window once all requested blocks are stored, otherwise wait for the stream to complete
+		_firmwareLastRequest = (_firmwareBlock <= _firmwareWindowEnd) ? 0 : hwMillis();
+#else
 		_firmwareLastRequest = 0;
+#endif
 	} else {
 		OTA_DEBUG(PSTR("!OTA:FWP:NO UPDATE\n"));
 	}
 	return true;
 }
+
+LOCAL void _firmwareCrcBlock(const uint16_t block, const uint8_t *data)
+{
+#ifdef MY_OTA_DELTA_UPDATE_FEATURE
+	if (_firmwareDeltaBlocks) {
+		// patch data, the image CRC is calculated when the patch is applied
+		return;
+	}
+#endif
+	uint8_t buffer[FIRMWARE_BLOCK_SIZE];
+	if (!data) {
+		_flash_readBytes((uint32_t)block * FIRMWARE_BLOCK_SIZE + FIRMWARE_START_OFFSET, buffer,
+		                 FIRMWARE_BLOCK_SIZE);
+		data = buffer;
+	}
+	for (uint8_t i = FIRMWARE_BLOCK_SIZE; i > 0; --i) {
+		_firmwareCrc = _firmwareCrc16Reverse(_firmwareCrc, data[i - 1]);
+	}
+}
+
+#ifdef MY_OTA_DELTA_UPDATE_FEATURE
+// reconstruct new image from running image and patch, see MyOTAFirmwareUpdate.h for the format
+LOCAL bool _firmwareApplyDelta(void)
+{
+	const uint32_t patchSize = (uint32_t)_firmwareDeltaBlocks * FIRMWARE_BLOCK_SIZE;
+	const uint32_t sourceSize = (uint32_t)_firmwareDeltaBaseBlocks * FIRMWARE_BLOCK_SIZE;
+	const uint32_t targetSize = (uint32_t)_nodeFirmwareConfig.blocks * FIRMWARE_BLOCK_SIZE;
+	uint32_t patchPos = 0;
+	uint32_t targetPos = 0;
+	uint8_t buffer[FIRMWARE_BLOCK_SIZE];
+	uint8_t fill = 0;
+	uint8_t op = 0;
+	uint16_t crc = ~0;
+
+#define _patch_readByte() _flash_readByte(MY_OTA_DELTA_PATCH_OFFSET + patchPos++)
+	uint16_t magic = _patch_readByte();
+	magic |= (uint16_t)_patch_readByte() << 8;
+	uint16_t baseCrc = _patch_readByte();
+	baseCrc |= (uint16_t)_patch_readByte() << 8;
+	if (magic != FIRMWARE_DELTA_MAGIC || baseCrc != _firmwareDeltaBaseCrc ||
+	        targetSize > 0x8000ul - FIRMWARE_START_OFFSET) {
+		OTA_DEBUG(PSTR("!OTA:FWP:DELTA FAIL\n"));
+		return false;
+	}
+	_flash_writeBegin(0, FIRMWARE_START_OFFSET + targetSize);
+
+	while (patchPos < patchSize) {
+		op = _patch_readByte();
+		if (op == FIRMWARE_DELTA_OP_END) {
+			break;
+		}
+		uint16_t length;
+		uint32_t source = 0;
+		uint8_t value = 0;
+		if (op <= FIRMWARE_DELTA_OP_LITERAL) {
+			length = op + 1;
+			if (patchPos + length > patchSize) {
+				break;
+			}
+		} else if ((op == FIRMWARE_DELTA_OP_COPY || op == FIRMWARE_DELTA_OP_FILL) && patchPos + 5 <= patchSize) {
+			length = _patch_readByte();
+			length |= (uint16_t)_patch_readByte() << 8;
+			if (op == FIRMWARE_DELTA_OP_COPY) {
+				source = _patch_readByte();
+				source |= (uint32_t)_patch_readByte() << 8;
+				source |= (uint32_t)_patch_readByte() << 16;
+				if (source + length > sourceSize) {
+					break;
+				}
+			} else {
+				value = _patch_readByte();
+			}
+		} else {
+			break;
+		}
+		if (targetPos + length > targetSize) {
+			break;
+		}
+		while (length--) {
+			if (op <= FIRMWARE_DELTA_OP_LITERAL) {
+				value = _patch_readByte();
+			} else if (op == FIRMWARE_DELTA_OP_COPY) {
+				value = _running_readByte(source++);
+			}
+			buffer[fill++] = value;
+			crc = _firmwareCrc16(crc, value);
+			targetPos++;
+			if (fill == FIRMWARE_BLOCK_SIZE) {
+				_flash_writeBuffered(targetPos - fill + FIRMWARE_START_OFFSET, buffer, fill);
+				fill = 0;
+			}
+		}
+	}
+#undef _patch_readByte
+	_flash_writeFlush();
+	while (_flash_busy()) {}
+	// target size is a multiple of FIRMWARE_BLOCK_SIZE, no partial block left if complete
+	if (op != FIRMWARE_DELTA_OP_END || targetPos != targetSize) {
+		OTA_DEBUG(PSTR("!OTA:FWP:DELTA FAIL\n"));
+		return false;
+	}
+	OTA_DEBUG(PSTR("OTA:CRC:B=%04" PRIX16 ",C=%04" PRIX16 ",F=%04" PRIX16 "\n"),
+	          _nodeFirmwareConfig.blocks, crc, _nodeFirmwareConfig.crc);
+	if (crc != _nodeFirmwareConfig.crc) {
+		OTA_DEBUG(PSTR("!OTA:FWP:DELTA FAIL\n"));
+		return false;
+	}
+	OTA_DEBUG(PSTR("OTA:FWP:DELTA OK,S=%04" PRIX16 "\n"), _nodeFirmwareConfig.blocks);
+	return true;
+}
+#endif
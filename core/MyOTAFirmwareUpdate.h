@@ -32,22 +32,46 @@
 *  - OTA:<b>FRQ</b>	from @ref firmwareOTAUpdateRequest()
 *  - OTA:<b>FWP</b>	from @ref firmwareOTAUpdateProcess()
 *
+* Windowed transfer (@ref MY_OTA_WINDOW_SIZE > 1, reported as bootloader protocol 3.2):
+* - The node reports its window size in @ref requestFirmwareConfig_t::windowSize.
+* - Blocks are requested with @ref requestFirmwareWindow_t: the controller streams the blocks
+*   block, block-1, ..., block-window+1 whose bit in the received bitmap is not set.
+* - The node slides the window over consecutively received blocks and re-requests only the gaps
+*   after @ref MY_OTA_RETRY_DELAY without new blocks.
+* - Controllers unaware of the extension answer the first block only, which degrades to stop-and-wait.
+*
+* Delta updates (@ref MY_OTA_DELTA_UPDATE_FEATURE, reported as bootloader protocol 3.2):
+* - The node sets @ref FIRMWARE_FEATURE_DELTA in @ref requestFirmwareConfig_t::features if its running
+*   image matches the reported type, version, blocks and CRC.
+* - The controller answers with @ref replyFirmwareConfigDelta_t, the block requests that follow
+*   address the patch (block n holds patch bytes n * FIRMWARE_BLOCK_SIZE onwards) instead of the image.
+* - Patch format: uint16 @ref FIRMWARE_DELTA_MAGIC, uint16 CRC of the running image, followed by ops
+*   that append to the new image: literal bytes, copies from the running image and fills,
+*   terminated by @ref FIRMWARE_DELTA_OP_END. All values are little endian.
+*
 * MyOTAFirmwareUpdate debug log messages:
 *
 * |E| SYS | SUB | Message                     | Comment
 * |-|-----|-----|-----------------------------|----------------------------------------------------------------------------
 * | | OTA | FWP | UPDATE                      | FW update initiated
+* | | OTA | FWP | UPDATE DELTA,P=%04X         | Delta FW update initiated, patch blocks (P)
+* |!| OTA | FWP | DELTA REJECTED              | Delta FW update not possible, running image unverified or patch too large
+* | | OTA | FWP | DELTA OK,S=%04X             | Image reconstructed from delta patch, image size (S) in blocks
+* |!| OTA | FWP | DELTA FAIL                  | Delta patch invalid or not matching the running image
 * |!| OTA | FWP | UPDO                        | FW config response received, FW update already ongoing
 * |!| OTA | FWP | FLASH INIT FAIL             | Failed to initialise flash
 * | | OTA | FWP | UPDATE SKIPPED              | FW update skipped, no newer version available
 * | | OTA | FWP | RECV B=%04X                 | Received FW block (B)
 * |!| OTA | FWP | WRONG FWB                   | Wrong FW block received
+* | | OTA | FWP | DUP B=%04X                  | Duplicate FW block (B) received within window, ignored
 * | | OTA | FWP | FW END                      | FW received, proceed to CRC verification
 * | | OTA | FWP | CRC OK                      | FW CRC verification OK
 * |!| OTA | FWP | CRC FAIL                    | FW CRC verification failed
 * | | OTA | FRQ | FW REQ,T=%04X,V=%04X,B=%04X | Request FW update, FW type (T), version (V), block (B)
+* | | OTA | FRQ | FW REQ,T=%04X,V=%04X,B=%04X,W=%02X,M=%04X | Request FW window, FW type (T), version (V), first block (B), window size (W), received bitmap (M)
 * |!| OTA | FRQ | FW UPD FAIL                 | FW update failed
 * | | OTA | CRC | B=%04X,C=%04X,F=%04X        | FW CRC verification. FW blocks (B), calculated CRC (C), FW CRC (F)
+* | | OTA | CRC | R=%04X                      | Incremental FW CRC check, residual (R) is FFFF if all received blocks match the FW CRC
 *
 *
 * @brief API declaration for MyOTAFirmwareUpdate
@@ -85,8 +109,34 @@
 #define	FIRMWARE_START_OFFSET	(FLASH_AREA_IMAGE_1_OFFSET_0)	//!< Use offset from generated_dts_board.h (mcuboot)
 #endif
 
+#if (MY_OTA_WINDOW_SIZE < 1) || (MY_OTA_WINDOW_SIZE > 16)
+#error MY_OTA_WINDOW_SIZE must be between 1 and 16
+#endif
+#if (MY_OTA_WINDOW_SIZE > 1)
+#define MY_OTA_WINDOWED_TRANSFER					//!< Windowed FW block transfer
+#endif
+#if defined(MY_OTA_DELTA_UPDATE_FEATURE) && defined(MCUBOOT_PRESENT)
+#error MY_OTA_DELTA_UPDATE_FEATURE requires external flash and is not available with mcuboot
+#endif
+#if defined(MY_OTA_WINDOWED_TRANSFER) || defined(MY_OTA_DELTA_UPDATE_FEATURE)
+#define FIRMWARE_PROTOCOL_32						//!< FOTA 3.2 protocol extensions
+#ifndef FIRMWARE_PROTOCOL_31
+#define FIRMWARE_PROTOCOL_31
+#endif
+#endif
+
+#define FIRMWARE_FEATURE_DELTA		(0x01u)			//!< Node accepts delta updates against the running image
+
+#define FIRMWARE_DELTA_MAGIC		(0x444Du)		//!< Delta patch header magic, "MD"
+#define FIRMWARE_DELTA_OP_LITERAL	(0x7Fu)			//!< Delta op 0x00..0x7F: op+1 literal bytes follow
+#define FIRMWARE_DELTA_OP_COPY		(0x80u)			//!< Delta op: uint16 length, uint24 source address follow
+#define FIRMWARE_DELTA_OP_FILL		(0x81u)			//!< Delta op: uint16 length, fill byte follow
+#define FIRMWARE_DELTA_OP_END		(0xFFu)			//!< Delta op: end of patch, also used as padding
+
 #define MY_OTA_BOOTLOADER_MAJOR_VERSION (3u)		//!< Bootloader version major
-#ifdef FIRMWARE_PROTOCOL_31
+#if defined(FIRMWARE_PROTOCOL_32)
+#define MY_OTA_BOOTLOADER_MINOR_VERSION (2u)		//!< Bootloader version minor
+#elif defined(FIRMWARE_PROTOCOL_31)
 #define MY_OTA_BOOTLOADER_MINOR_VERSION (1u)		//!< Bootloader version minor
 #else
 #define MY_OTA_BOOTLOADER_MINOR_VERSION (0u)		//!< Bootloader version minor
@@ -121,6 +171,17 @@ typedef struct {
 	uint16_t crc;								//!< CRC of block data
 } __attribute__((packed)) nodeFirmwareConfig_t;
 
+/**
+* @brief FW config reply structure of a delta update (protocol version >= 3.2)
+*/
+typedef struct {
+	uint16_t type;								//!< Type of config
+	uint16_t version;							//!< Version of config
+	uint16_t blocks;							//!< Number of blocks of the new image
+	uint16_t crc;								//!< CRC of the new image
+	uint16_t patchBlocks;						//!< Number of blocks of the delta patch
+} __attribute__((packed)) replyFirmwareConfigDelta_t;
+
 /**
 * @brief FW config request structure
 */
@@ -136,6 +197,10 @@ typedef struct {
 	uint16_t img_revision;							//!< mcuboot revision attribute, when protocol version >= 3.1 is reported
 	uint32_t img_build_num;							//!< mcuboot build_num attribute, when protocol version >= 3.1 is reported
 #endif
+#ifdef FIRMWARE_PROTOCOL_32
+	uint8_t  windowSize;							//!< Number of blocks the node accepts per request, when protocol version >= 3.2 is reported
+	uint8_t  features;							//!< FIRMWARE_FEATURE_* flags, when protocol version >= 3.2 is reported
+#endif
 } __attribute__((packed)) requestFirmwareConfig_t;
 
 /**
@@ -147,6 +212,17 @@ typedef struct {
 	uint16_t block;								//!< Block index
 } __attribute__((packed)) requestFirmwareBlock_t;
 
+/**
+* @brief FW window request structure (protocol version >= 3.2)
+*/
+typedef struct {
+	uint16_t type;								//!< Type of config
+	uint16_t version;							//!< Version of config
+	uint16_t block;								//!< Highest missing block index, first block of the window
+	uint8_t  window;							//!< Number of blocks in window, counting down from block
+	uint16_t received;							//!< Bitmap of blocks already received, bit n refers to block - n
+} __attribute__((packed)) requestFirmwareWindow_t;
+
 /**
 * @brief  FW block reply structure
 */
@@ -187,7 +263,8 @@ LOCAL bool firmwareOTAUpdateProcess(void);
 /**
  * @brief Validate uploaded FW CRC
  *
- * This function verifies if uploaded FW CRC is valid
+ * This function re-reads the uploaded FW from flash and verifies its CRC. The received blocks
+ * are already checked incrementally, see @ref MY_OTA_DISABLE_FLASH_VERIFICATION.
  */
 LOCAL bool transportIsValidFirmware(void);
 /**
@@ -24,144 +24,351 @@
 #include <string.h>
 
 char _fmtBuffer[MY_GATEWAY_MAX_SEND_LENGTH];
-char _convBuffer[MAX_PAYLOAD_SIZE * 2 + 1];
 
-bool protocolSerial2MyMessage(MyMessage &message, char *inputString)
+// Value of a hex digit for the 7-bit ASCII range, PROTOCOL_INVALID_DIGIT for any other character
+#define PROTOCOL_INVALID_DIGIT (0xFFu)
+static const uint8_t _protocolDigitValue[128] PROGMEM = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+static inline uint8_t protocolDigitValue(const char c)
+{
+	const uint8_t index = (uint8_t)c;
+	return (index & 0x80u) ? PROTOCOL_INVALID_DIGIT : pgm_read_byte(&_protocolDigitValue[index]);
+}
+
+// Parse an unsigned 8 bit decimal field terminated by delimiter or the end of input.
+// Returns a pointer to the terminating character, NULL if the field is empty or not a valid number.
+static const char *protocolParseUint8(const char *str, const char *end, const char delimiter,
+                                      uint8_t &value)
+{
+	const char *start = str;
+	uint16_t result = 0;
+	while (str < end && *str != delimiter) {
+		const uint8_t digit = protocolDigitValue(*str++);
+		if (digit > 9) {
+			return NULL;
+		}
+		result = result * 10 + digit;
+		if (result > UINT8_MAX) {
+			return NULL;
+		}
+	}
+	if (str == start) {
+		return NULL;
+	}
+	value = (uint8_t)result;
+	return str;
+}
+
+// Parse the five header fields (destination, sensor, command, echo request, type) into message.
+// Returns a pointer behind the last field, NULL if a field is missing or invalid.
+static const char *protocolParseHeader(MyMessage &message, const char *str, const char *end,
+                                       const char delimiter)
+{
+	uint8_t field[5];
+	for (uint8_t index = 0; index < 5; index++) {
+		if (index) {
+			if (str == end || *str != delimiter) {
+				return NULL;
+			}
+			str++;
+		}
+		str = protocolParseUint8(str, end, delimiter, field[index]);
+		if (!str) {
+			return NULL;
+		}
+	}
+	message.setDestination(field[0]);
+	message.setSensor(field[1]);
+	message.setCommand(static_cast<mysensors_command_t>(field[2]));
+	message.setRequestEcho(field[3] ? 1 : 0);
+	message.setType(field[4]);
+	return str;
+}
+
+// Set the message payload from a (pointer, length) view, C_STREAM payloads are hex encoded
+static bool protocolSetPayload(MyMessage &message, const char *str, size_t length)
+{
+	if (message.getCommand() == C_STREAM) {
+		uint8_t bvalue[MAX_PAYLOAD_SIZE];
+		if ((length & 1u) || length > 2 * MAX_PAYLOAD_SIZE) {
+			return false;
+		}
+		for (uint8_t blen = 0; blen < length / 2; blen++) {
+			const uint8_t high = protocolDigitValue(*str++);
+			const uint8_t low = protocolDigitValue(*str++);
+			if ((high | low) > 0x0Fu) {
+				return false;
+			}
+			bvalue[blen] = (uint8_t)(high << 4) | low;
+		}
+		message.set(bvalue, length / 2);
+	} else {
+		// clamp before narrowing to uint8_t, long strings are truncated
+		(void)message.setLength(length > MAX_PAYLOAD_SIZE ? MAX_PAYLOAD_SIZE : (uint8_t)length);
+		(void)message.setPayloadType(P_STRING);
+		(void)memcpy(message.data, str, message.getLength());
+		// null terminate string
+		message.data[message.getLength()] = 0;
+	}
+	return true;
+}
+
+bool protocolSerial2MyMessage(MyMessage &message, const char *inputString, const size_t length)
 {
-	char *str, *p;
-	uint8_t index = 0;
-	mysensors_command_t command = C_INVALID_7;
+	const char *end = inputString + length;
 	message.setSender(GATEWAY_ADDRESS);
 	message.setLast(GATEWAY_ADDRESS);
 	message.setEcho(false);
 
-	// Extract command data coming on serial line
-	for (str = strtok_r(inputString, ";", &p); // split using semicolon
-	        str && index < 5; // loop while str is not null an max 4 times
-	        str = strtok_r(NULL, ";", &p), index++ // get subsequent tokens
-	    ) {
-		switch (index) {
-		case 0: // Radio id (destination)
-			message.setDestination(atoi(str));
-			break;
-		case 1: // Child id
-			message.setSensor(atoi(str));
-			break;
-		case 2: // Message type
-			command = static_cast<mysensors_command_t>(atoi(str));
-			message.setCommand(command);
-			break;
-		case 3: // Should we request echo from destination?
-			message.setRequestEcho(atoi(str) ? 1 : 0);
-			break;
-		case 4: // Data type
-			message.setType(atoi(str));
-			break;
-		}
+	// Remove trailing carriage return and newline characters (if they exist)
+	while (end > inputString && (end[-1] == '\r' || end[-1] == '\n')) {
+		end--;
+	}
+	const char *str = protocolParseHeader(message, inputString, end, ';');
+	if (!str) {
+		return false;
+	}
+	// payload, ends at the next semicolon
+	if (str < end) {
+		str++;
 	}
-	// payload
-	if (str == NULL) {
+	const char *payloadEnd = (const char *)memchr(str, ';', end - str);
+	if (!payloadEnd) {
+		payloadEnd = end;
+	}
+	if (str == payloadEnd) {
 		// no payload, set default value
 		message.set((uint8_t)0);
-	} else if (command == C_STREAM) {
-		// stream payload
-		uint8_t bvalue[MAX_PAYLOAD_SIZE];
-		uint8_t blen = 0;
-		while (*str) {
-			uint8_t val;
-			val = convertH2I(*str++) << 4;
-			val += convertH2I(*str++);
-			bvalue[blen] = val;
-			blen++;
-		}
-		message.set(bvalue, blen);
+		return true;
+	}
+	return protocolSetPayload(message, str, payloadEnd - str);
+}
+
+bool protocolSerial2MyMessage(MyMessage &message, char *inputString)
+{
+	return protocolSerial2MyMessage(message, inputString, strlen(inputString));
+}
+
+// Output helpers, they stop writing at end (which is reserved for the string terminator)
+static inline void protocolPutChar(char *&pos, const char *end, const char c)
+{
+	if (pos < end) {
+		*pos++ = c;
+	}
+}
+
+static void protocolPutString(char *&pos, const char *end, const char *str, size_t length)
+{
+	if (length > (size_t)(end - pos)) {
+		length = end - pos;
+	}
+	(void)memcpy(pos, str, length);
+	pos += length;
+}
+
+static void protocolPutUint32(char *&pos, const char *end, uint32_t value)
+{
+	char digits[10];
+	uint8_t count = 0;
+	do {
+		digits[count++] = '0' + (char)(value % 10);
+		value /= 10;
+	} while (value);
+	while (count) {
+		protocolPutChar(pos, end, digits[--count]);
+	}
+}
+
+static void protocolPutInt32(char *&pos, const char *end, const int32_t value)
+{
+	if (value < 0) {
+		protocolPutChar(pos, end, '-');
+		protocolPutUint32(pos, end, 0u - (uint32_t)value);
 	} else {
-		// regular payload
-		char *value = str;
-		// Remove trailing carriage return and newline character (if it exists)
-		const uint8_t lastCharacter = strlen(value) - 1;
-		if (value[lastCharacter] == '\r' || value[lastCharacter] == '\n') {
-			value[lastCharacter] = '\0';
+		protocolPutUint32(pos, end, (uint32_t)value);
+	}
+}
+
+static void protocolPutHex(char *&pos, const char *end, const uint8_t *data, const uint8_t length)
+{
+	for (uint8_t i = 0; i < length; i++) {
+		protocolPutChar(pos, end, convertI2H(data[i] >> 4));
+		protocolPutChar(pos, end, convertI2H(data[i]));
+	}
+}
+
+// Formats like dtostrf(value, 2, decimals), which is what MyMessage::getString() uses. The output
+// is identical to the sprintf() based dtostrf() on Linux. The other cores bring their own
+// dtostrf(), on AVR float math and avr-libc rounding can differ in the last decimal.
+static void protocolPutFloat(char *&pos, const char *end, const float value, uint8_t decimals)
+{
+	static const uint32_t scale[] = { 1ul, 10ul, 100ul, 1000ul, 10000ul, 100000ul, 1000000ul, 10000000ul, 100000000ul };
+	if (decimals > 8) {
+		decimals = 8;
+	}
+	// double is float on AVR, elsewhere the product is exact and rounds like printf("%f")
+	const double scaled = (value < 0 ? -(double)value : (double)value) * scale[decimals];
+	if (isnan(value) || !(scaled < 4294967295.0)) {
+		// nan, inf or out of range for the integer path, the longest dtostrf() output
+		// is 49 characters (-3.4e38 with 8 decimals)
+		char str[MAX_PAYLOAD_SIZE * 2 + 1];
+		(void)dtostrf(value, 2, decimals, str);
+		protocolPutString(pos, end, str, strlen(str));
+		return;
+	}
+	uint32_t fixed = (uint32_t)scaled;
+	const double remainder = scaled - fixed;
+	if (remainder > 0.5 || (remainder == 0.5 && (fixed & 1u))) {
+		// round half to even
+		fixed++;
+	}
+	const char *start = pos;
+	if (value < 0) {
+		protocolPutChar(pos, end, '-');
+	}
+	protocolPutUint32(pos, end, fixed / scale[decimals]);
+	if (decimals) {
+		uint32_t fraction = fixed % scale[decimals];
+		protocolPutChar(pos, end, '.');
+		while (decimals--) {
+			protocolPutChar(pos, end, '0' + (char)(fraction / scale[decimals]));
+			fraction %= scale[decimals];
 		}
-		message.set(value);
 	}
-	return (index == 5);
+	if (pos - start == 1 && pos < end) {
+		// minimum width 2, pad with a leading space
+		pos[0] = pos[-1];
+		pos[-1] = ' ';
+		pos++;
+	}
+}
+
+static void protocolPutPayload(char *&pos, const char *end, const MyMessage &message)
+{
+	const uint8_t length = message.getLength();
+	switch (message.getPayloadType()) {
+	case P_STRING: {
+		// payload is not necessarily terminated at length
+		const char *nul = (const char *)memchr(message.data, 0, length);
+		protocolPutString(pos, end, message.data, nul ? (size_t)(nul - message.data) : length);
+		break;
+	}
+	case P_BYTE:
+		protocolPutUint32(pos, end, message.bValue);
+		break;
+	case P_INT16:
+		protocolPutInt32(pos, end, message.iValue);
+		break;
+	case P_UINT16:
+		protocolPutUint32(pos, end, message.uiValue);
+		break;
+	case P_LONG32:
+		protocolPutInt32(pos, end, message.lValue);
+		break;
+	case P_ULONG32:
+		protocolPutUint32(pos, end, message.ulValue);
+		break;
+	case P_FLOAT32:
+		protocolPutFloat(pos, end, message.fValue, message.fPrecision);
+		break;
+	case P_CUSTOM:
+		protocolPutHex(pos, end, (const uint8_t *)message.data, length);
+		break;
+	default:
+		break;
+	}
+}
+
+// Terminate the string in buffer and return its length
+static size_t protocolTerminate(char *buffer, char *pos)
+{
+	*pos = 0;
+	return pos - buffer;
+}
+
+size_t protocolMyMessage2Serial(char *buffer, const size_t size, const MyMessage &message)
+{
+	char *pos = buffer;
+	const char *end = buffer + size - 1;
+	protocolPutUint32(pos, end, message.getSender());
+	protocolPutChar(pos, end, ';');
+	protocolPutUint32(pos, end, message.getSensor());
+	protocolPutChar(pos, end, ';');
+	protocolPutUint32(pos, end, message.getCommand());
+	protocolPutChar(pos, end, ';');
+	protocolPutUint32(pos, end, message.isEcho());
+	protocolPutChar(pos, end, ';');
+	protocolPutUint32(pos, end, message.getType());
+	protocolPutChar(pos, end, ';');
+	protocolPutPayload(pos, end, message);
+	protocolPutChar(pos, end, '\n');
+	return protocolTerminate(buffer, pos);
+}
+
+size_t protocolMyMessage2MQTT(char *buffer, const size_t size, const char *prefix,
+                              const MyMessage &message)
+{
+	char *pos = buffer;
+	const char *end = buffer + size - 1;
+	protocolPutString(pos, end, prefix, strlen(prefix));
+	protocolPutChar(pos, end, '/');
+	protocolPutUint32(pos, end, message.getSender());
+	protocolPutChar(pos, end, '/');
+	protocolPutUint32(pos, end, message.getSensor());
+	protocolPutChar(pos, end, '/');
+	protocolPutUint32(pos, end, message.getCommand());
+	protocolPutChar(pos, end, '/');
+	protocolPutUint32(pos, end, message.isEcho());
+	protocolPutChar(pos, end, '/');
+	protocolPutUint32(pos, end, message.getType());
+	return protocolTerminate(buffer, pos);
+}
+
+size_t protocolMyMessagePayload2String(char *buffer, const size_t size, const MyMessage &message)
+{
+	char *pos = buffer;
+	protocolPutPayload(pos, buffer + size - 1, message);
+	return protocolTerminate(buffer, pos);
 }
 
 char *protocolMyMessage2Serial(const MyMessage &message)
 {
-	(void)snprintf_P(_fmtBuffer, (uint8_t)MY_GATEWAY_MAX_SEND_LENGTH,
-	                 PSTR("%" PRIu8 ";%" PRIu8 ";%" PRIu8 ";%" PRIu8 ";%" PRIu8 ";%s\n"), message.getSender(),
-	                 message.getSensor(), message.getCommand(), message.isEcho(), message.getType(),
-	                 message.getString(_convBuffer));
+	(void)protocolMyMessage2Serial(_fmtBuffer, sizeof(_fmtBuffer), message);
 	return _fmtBuffer;
 }
 
 char *protocolMyMessage2MQTT(const char *prefix, const MyMessage &message)
 {
-	(void)snprintf_P(_fmtBuffer, (uint8_t)MY_GATEWAY_MAX_SEND_LENGTH,
-	                 PSTR("%s/%" PRIu8 "/%" PRIu8 "/%" PRIu8 "/%" PRIu8 "/%" PRIu8 ""), prefix,
-	                 message.getSender(), message.getSensor(), message.getCommand(), message.isEcho(),
-	                 message.getType());
+	(void)protocolMyMessage2MQTT(_fmtBuffer, sizeof(_fmtBuffer), prefix, message);
 	return _fmtBuffer;
 }
 
 
-bool protocolMQTT2MyMessage(MyMessage &message, char *topic, uint8_t *payload,
+bool protocolMQTT2MyMessage(MyMessage &message, const char *topic, const uint8_t *payload,
                             const unsigned int length)
 {
-	char *str, *p;
-	uint8_t index = 0;
+	const size_t prefixLength = strlen(MY_MQTT_SUBSCRIBE_TOPIC_PREFIX) + 1;
+	const size_t topicLength = strlen(topic);
 	message.setSender(GATEWAY_ADDRESS);
 	message.setLast(GATEWAY_ADDRESS);
 	message.setEcho(false);
-	for (str = strtok_r(topic + strlen(MY_MQTT_SUBSCRIBE_TOPIC_PREFIX) + 1, "/", &p);
-	        str && index < 5;
-	        str = strtok_r(NULL, "/", &p), index++
-	    ) {
-		switch (index) {
-		case 0:
-			// Node id
-			message.setDestination(atoi(str));
-			break;
-		case 1:
-			// Sensor id
-			message.setSensor(atoi(str));
-			break;
-		case 2: {
-			// Command type
-			const mysensors_command_t command = static_cast<mysensors_command_t>(atoi(str));
-			message.setCommand(command);
-			// Add payload
-			if (command == C_STREAM) {
-				uint8_t bvalue[MAX_PAYLOAD_SIZE];
-				uint8_t blen = 0;
-				while (*payload) {
-					uint8_t val;
-					val = convertH2I(*payload++) << 4;
-					val += convertH2I(*payload++);
-					bvalue[blen] = val;
-					blen++;
-				}
-				message.set(bvalue, blen);
-			} else {
-				// terminate string
-				char *value = (char *)payload;
-				value[length] = '\0';
-				message.set((const char*)payload);
-			}
-			break;
-		}
-		case 3:
-			// Echo flag
-			message.setRequestEcho(atoi(str) ? 1 : 0);
-			break;
-		case 4:
-			// Sub type
-			message.setType(atoi(str));
-			break;
-		}
+	if (topicLength <= prefixLength) {
+		return false;
+	}
+	// topic: <prefix>/<node id>/<sensor id>/<command>/<echo>/<sub type>
+	const char *end = topic + topicLength;
+	const char *str = protocolParseHeader(message, topic + prefixLength, end, '/');
+	if (!str || str != end) {
+		return false;
 	}
-	// Return true if input valid
-	return (index == 5);
+	return protocolSetPayload(message, (const char *)payload, length);
 }
@@ -27,12 +27,32 @@
 // returns true if successfully parsed the input string
 bool protocolSerial2MyMessage(MyMessage &message, char *inputString);
 
+// parse(message, inputString, length)
+// parse length characters of a string into a message element, the input is not modified
+// returns true if successfully parsed the input string
+bool protocolSerial2MyMessage(MyMessage &message, const char *inputString, const size_t length);
+
 // Format MyMessage to the protocol representation
 char *protocolMyMessage2Serial(const MyMessage &message);
 
 char *protocolMyMessage2MQTT(const char *prefix, const MyMessage &message);
 
-bool protocolMQTT2MyMessage(MyMessage &message, char *topic, uint8_t *payload,
+// Format MyMessage to the protocol representation into buffer (reentrant)
+// output is truncated to size - 1 characters and always terminated
+// returns the length of the formatted string
+size_t protocolMyMessage2Serial(char *buffer, const size_t size, const MyMessage &message);
+
+// Format the MQTT topic of MyMessage into buffer (reentrant)
+// returns the length of the formatted string
+size_t protocolMyMessage2MQTT(char *buffer, const size_t size, const char *prefix,
+                              const MyMessage &message);
+
+// Format the payload of MyMessage into buffer, same representation as MyMessage::getString() (reentrant)
+// floats may differ from getString() in the last decimal on AVR, see protocolPutFloat()
+// returns the length of the formatted string
+size_t protocolMyMessagePayload2String(char *buffer, const size_t size, const MyMessage &message);
+
+bool protocolMQTT2MyMessage(MyMessage &message, const char *topic, const uint8_t *payload,
                             const unsigned int length);
 
 #endif
@@ -38,6 +38,9 @@ static uint8_t waitLock = 0;
 static uint8_t processLock = 0;
 #endif
 
+// input scheduler counters
+static processStats_t _processStats;
+
 #if defined(DEBUG_OUTPUT_ENABLED)
 char _convBuf[MAX_PAYLOAD_SIZE * 2 + 1];
 #endif
@@ -54,6 +57,81 @@ void _callbackTransportReady(void)
 	}
 }
 
+const processStats_t &getProcessStats(void)
+{
+	return _processStats;
+}
+
+void resetProcessStats(void)
+{
+	(void)memset((void *)&_processStats, 0, sizeof(_processStats));
+}
+
+// Process radio and controller input alternately within time budget and message limit
+static void _processInput(void)
+{
+	_processStats.passes++;
+#if defined(MY_SENSOR_NETWORK)
+	transportUpdateSM();
+	const bool radioActive = transportProcessHousekeeping();
+	if (radioActive) {
+		const uint8_t rxPending = transportHALGetRxPending();
+		if (rxPending > _processStats.rxHighWater) {
+			_processStats.rxHighWater = rxPending;
+		}
+	}
+#endif
+	const uint32_t enterMS = hwMillis();
+	uint8_t processedMessages = 0;
+	bool inputLeft = true;
+#if defined(MY_GATEWAY_FEATURE)
+	bool controllerReady = true;
+#if defined(MY_SENSOR_NETWORK)
+	bool deferred = false;
+#endif
+#endif
+	while (inputLeft) {
+		inputLeft = false;
+#if defined(MY_GATEWAY_FEATURE)
+#if defined(MY_SENSOR_NETWORK)
+		// outbound radio queue nearly full, leave controller input until frames are sent
+		controllerReady = (transportHALGetTxQueueFree() >= MY_PROCESS_TX_RESERVE);
+		deferred |= !controllerReady;
+#endif
+		if (controllerReady && gatewayTransportProcess()) {
+			_processStats.controllerMessages++;
+			processedMessages++;
+			inputLeft = true;
+		}
+#endif
+#if defined(MY_SENSOR_NETWORK)
+		if (radioActive && transportProcessNextMessage()) {
+			_processStats.radioMessages++;
+			processedMessages++;
+			inputLeft = true;
+		}
+#endif
+		if (inputLeft && (processedMessages >= MY_PROCESS_MAX_MESSAGES ||
+		                  hwMillis() - enterMS >= MY_PROCESS_BUDGET_MS)) {
+			_processStats.budgetExhausted++;
+#if defined(__linux__)
+			// do not block the main loop while input is left
+			EventLoop.wakeup();
+#endif
+			break;
+		}
+	}
+#if defined(MY_GATEWAY_FEATURE) && defined(MY_SENSOR_NETWORK)
+	if (deferred) {
+		_processStats.backpressure++;
+	}
+#if defined(__linux__)
+	// unread controller input would wake up the event loop at once, wait for the radio instead
+	EventLoop.pauseInput(!controllerReady);
+#endif
+#endif
+}
+
 void _process(void)
 {
 #if defined(MY_DEBUG_VERBOSE_CORE)
@@ -68,17 +146,16 @@ void _process(void)
 	inclusionProcess();
 #endif
 
-#if defined(MY_GATEWAY_FEATURE)
-	gatewayTransportProcess();
-#endif
+	_processInput();
 
-#if defined(MY_SENSOR_NETWORK)
-	transportProcess();
+#if defined(MY_GATEWAY_FEATURE)
+	// send everything queued for the controller during this pass
+	gatewayTransportFlush();
 #endif
 
 #if defined(__linux__)
-	// To avoid high cpu usage
-	usleep(10000); // 10ms
+	// Sleep until there is data to process, a radio interrupt or a pending timeout
+	EventLoop.wait(MY_LINUX_EVENT_LOOP_TIMEOUT_MS);
 #endif
 #if defined(MY_DEBUG_VERBOSE_CORE)
 	processLock--;
@@ -443,6 +520,10 @@ bool _processInternalCoreMessage(void)
 		if (type == I_REBOOT) {
 #if !defined(MY_DISABLE_REMOTE_RESET)
 			setIndication(INDICATION_REBOOT);
+#if defined(MY_SENSOR_NETWORK)
+			// write routes changed since the last save interval
+			transportSaveRoutingTable();
+#endif
 			// WDT fuse should be enabled
 			hwReboot();
 #endif
@@ -498,6 +579,36 @@ bool _processInternalCoreMessage(void)
 			} else if (debug_msg == 'M') {	// free memory
 				(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
 				                       I_DEBUG).set(hwFreeMem()));
+			} else if (debug_msg == 'S') {	// input scheduler counters, cleared after reporting
+				CORE_DEBUG(PSTR("MCO:PRO:STAT,P=%" PRIu32 ",R=%" PRIu32 ",C=%" PRIu32 ",B=%" PRIu32 ",X=%" PRIu32
+				                ",H=%" PRIu8 "\n"), _processStats.passes, _processStats.radioMessages,
+				           _processStats.controllerMessages, _processStats.budgetExhausted,
+				           _processStats.backpressure, _processStats.rxHighWater);
+				const char labels[] = "PRCBXH";
+				const uint32_t values[] = { _processStats.passes, _processStats.radioMessages,
+				                            _processStats.controllerMessages, _processStats.budgetExhausted,
+				                            _processStats.backpressure, _processStats.rxHighWater
+				                          };
+				resetProcessStats();
+				// "P=..,R=..,C=..,B=..,X=..,H=..", continued in further messages if it exceeds the payload
+				char stats[MAX_PAYLOAD_SIZE + 1];
+				char item[13];	// longest is "P=4294967295"
+				uint8_t len = 0;
+				for (uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+					const uint8_t itemLen = (uint8_t)snprintf_P(item, sizeof(item), PSTR("%c=%" PRIu32),
+					                        labels[i], values[i]);
+					if (len && len + 1u + itemLen > MAX_PAYLOAD_SIZE) {
+						(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+						                       I_DEBUG).set(stats));
+						len = 0;
+					}
+					if (len) {
+						stats[len++] = ',';
+					}
+					(void)memcpy((void *)&stats[len], (const void *)item, itemLen + 1u);
+					len += itemLen;
+				}
+				(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL, I_DEBUG).set(stats));
 			} else if (debug_msg == 'E') {	// clear MySensors eeprom area and reboot
 				(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL, I_DEBUG).set("OK"));
 				for (uint16_t i = EEPROM_START; i<EEPROM_LOCAL_CONFIG_ADDRESS; i++) {
@@ -563,6 +674,9 @@ void wait(const uint32_t waitingMS)
 #endif
 	const uint32_t enteringMS = hwMillis();
 	while (hwMillis() - enteringMS < waitingMS) {
+#if defined(__linux__)
+		EventLoop.setTimeout(waitingMS - (hwMillis() - enteringMS));
+#endif
 		_process();
 	}
 #if defined(MY_DEBUG_VERBOSE_CORE)
@@ -584,6 +698,9 @@ bool wait(const uint32_t waitingMS, const mysensors_command_t cmd)
 	_msg.setCommand(C_INVALID_7);
 	bool expectedResponse = false;
 	while ((hwMillis() - enteringMS < waitingMS) && !expectedResponse) {
+#if defined(__linux__)
+		EventLoop.setTimeout(waitingMS - (hwMillis() - enteringMS));
+#endif
 		_process();
 		expectedResponse = (_msg.getCommand() == cmd);
 	}
@@ -607,6 +724,9 @@ bool wait(const uint32_t waitingMS, const mysensors_command_t cmd, const uint8_t
 	_msg.setCommand(C_INVALID_7);
 	bool expectedResponse = false;
 	while ( (hwMillis() - enteringMS < waitingMS) && !expectedResponse ) {
+#if defined(__linux__)
+		EventLoop.setTimeout(waitingMS - (hwMillis() - enteringMS));
+#endif
 		_process();
 		expectedResponse = (_msg.getCommand() == cmd && _msg.getType() == msgType);
 	}
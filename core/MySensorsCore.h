@@ -34,6 +34,7 @@
 *  - MCO:<b>SND</b>	from @ref send()
 *  - MCO:<b>PIM</b>	from @ref _processInternalCoreMessage()
 *  - MCO:<b>NLK</b>	from @ref _nodeLock()
+*  - MCO:<b>PRO</b>	from @ref _process()
 *
 * MySensorsCore debug log messages:
 *
@@ -59,6 +60,7 @@
 * |!| MCO | SLP | TNR																					| Transport not ready, attempt to reconnect until timeout (@ref MY_SLEEP_TRANSPORT_RECONNECT_TIMEOUT_MS)
 * | | MCO | NLK | NODE LOCKED. UNLOCK: GND PIN %%d AND RESET	| Node locked during booting, see signing chapter for additional information
 * | | MCO | NLK | TSL																					| Set transport to sleep
+* | | MCO | PRO | STAT,P=%%lu,R=%%lu,C=%%lu,B=%%lu,X=%%lu,H=%%d	| Input scheduler counters: passes (P), radio (R) and controller (C) messages, budget exhausted (B), backpressure (X), RX high-water (H)
 *
 * @brief API declaration for MySensorsCore
 */
@@ -106,6 +108,18 @@ typedef struct {
 	uint8_t reserved : 6;					//!< reserved
 } coreConfig_t;
 
+/**
+* @brief Input scheduler counters, see @ref MY_PROCESS_BUDGET_MS
+*/
+typedef struct {
+	uint32_t passes;						//!< _process() passes
+	uint32_t radioMessages;					//!< Radio messages processed
+	uint32_t controllerMessages;			//!< Controller messages processed
+	uint32_t budgetExhausted;				//!< Passes ended by time budget or message limit with input left
+	uint32_t backpressure;					//!< Passes that deferred controller input due to a full radio TX queue
+	uint8_t rxHighWater;					//!< Max. radio frames pending at the start of a pass
+} processStats_t;
+
 
 // **** public functions ********
 
@@ -169,6 +183,8 @@ bool sendSketchInfo(const __FlashStringHelper *name, const __FlashStringHelper *
  * contents of the message, triggering the receive() function on the original node with a copy of
  * the message, with message.isEcho() set to true and sender/destination switched.
  * @return true Returns true if message reached the first stop on its way to destination.
+ * With a radio TX queue (@ref MY_RFM95_TX_QUEUE_SIZE, @ref MY_RFM69_TX_QUEUE_SIZE) or the
+ * signing queue (@ref MY_SIGNING_ASYNC_QUEUE_SIZE), true means the message has been queued.
  */
 bool send(MyMessage &msg, const bool requestEcho = false);
 
@@ -301,6 +317,17 @@ bool wait(const uint32_t waitingMS, const mysensors_command_t cmd, const uint8_t
  */
 void doYield(void);
 
+/**
+ * Input scheduler counters accumulated since start or the last @ref resetProcessStats() call.
+ * @return Reference to the counters
+ */
+const processStats_t &getProcessStats(void);
+
+/**
+ * Clear the input scheduler counters.
+ */
+void resetProcessStats(void);
+
 /**
  * Sleep handler will be called right before and right after entering sleep mode.
  * Applications can define own handler to optimize powering down peripherals before entering sleep.
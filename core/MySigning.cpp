@@ -51,6 +51,34 @@ static uint8_t nof_failed_verifications = 0;
 // Status when waiting for signing nonce in signerSignMsg
 enum { SIGN_WAITING_FOR_NONCE = 0, SIGN_OK = 1 };
 
+// Verification nonces handed out to other nodes
+#define SIGN_NONCE_UNUSED (255u) // nodeId of unused entries (broadcast address, never a requester)
+typedef struct {
+	uint32_t timestamp;
+	uint8_t nodeId;
+	uint8_t nonce[32];
+} signerNonceEntry_t;
+static signerNonceEntry_t _signingNonceTable[MY_SIGNING_NONCE_TABLE_SIZE];
+
+#if defined(MY_SENSOR_NETWORK) && (MY_SIGNING_ASYNC_QUEUE_SIZE > 0)
+#define SIGNING_ASYNC_QUEUE
+#include "MyTransport.h"
+// Outgoing messages waiting for a nonce from their destination
+enum { SIGN_PENDING_FREE = 0, SIGN_PENDING_QUEUED = 1, SIGN_PENDING_NONCE = 2 };
+typedef struct {
+	MyMessage msg;      // Message to sign
+	uint32_t timestamp; // Time the nonce was requested
+	uint16_t order;     // Queue order, messages to one destination are sent oldest first
+	uint8_t to;         // Next hop
+	uint8_t state;      // SIGN_PENDING_*
+} signerPendingEntry_t;
+static signerPendingEntry_t _signingPending[MY_SIGNING_ASYNC_QUEUE_SIZE];
+static uint16_t _signingPendingOrder = 0;
+static void signerPendingRequestNonce(const uint8_t destination);
+static bool signerPendingComplete(MyMessage &msg);
+static void signerPendingExpire(void);
+#endif
+
 // Macros for manipulating signing requirement tables
 #define DO_SIGN(node) (~_doSign[node>>3]&(1<<node%8))
 #define SET_SIGN(node) (_doSign[node>>3]&=~(1<<node%8))
@@ -90,6 +118,7 @@ extern bool signerAtsha204SignMsg(MyMessage &msg);
 #define signerBackendVerifyMsg  signerAtsha204VerifyMsg
 #define signerBackendSignMsg    signerAtsha204SignMsg
 #endif
+static bool isSkipSign(const MyMessage &msg);
 static bool skipSign(MyMessage &msg);
 #else // not MY_SIGNING_FEATURE
 #define signerBackendCheckTimer() true
@@ -130,6 +159,16 @@ void signerInit(void)
 	hwReadConfigBlock((void*)_doWhitelist, (void*)EEPROM_WHITELIST_REQUIREMENT_TABLE_ADDRESS,
 	                  sizeof(_doWhitelist));
 
+	for (uint8_t i = 0; i < MY_SIGNING_NONCE_TABLE_SIZE; i++) {
+		_signingNonceTable[i].nodeId = SIGN_NONCE_UNUSED;
+		(void)memset((void *)_signingNonceTable[i].nonce, 0xAA, sizeof(_signingNonceTable[i].nonce));
+	}
+#if defined(SIGNING_ASYNC_QUEUE)
+	for (uint8_t i = 0; i < MY_SIGNING_ASYNC_QUEUE_SIZE; i++) {
+		_signingPending[i].state = SIGN_PENDING_FREE;
+	}
+#endif
+
 	if (!signerBackendInit()) {
 		SIGN_DEBUG(PSTR("!SGN:INI:BND FAIL\n"));
 	} else {
@@ -190,6 +229,9 @@ bool signerProcessInternal(MyMessage &msg)
 
 bool signerCheckTimer(void)
 {
+#if defined(SIGNING_ASYNC_QUEUE)
+	signerPendingExpire();
+#endif
 	return signerBackendCheckTimer();
 }
 
@@ -264,6 +306,41 @@ bool signerSignMsg(MyMessage &msg)
 
 }
 
+signerQueueResult_t signerQueueMsg(const uint8_t to, MyMessage &msg)
+{
+#if defined(SIGNING_ASYNC_QUEUE)
+	// Only messages we sign ourselves wait for a nonce, signerSignMsg() handles everything else
+	if (!DO_SIGN(msg.getDestination()) || msg.getSender() != getNodeId() || !stateValid ||
+	        isSkipSign(msg)) {
+		return SIGN_QUEUE_BYPASS;
+	}
+	signerPendingEntry_t *entry = NULL;
+	for (uint8_t i = 0; i < MY_SIGNING_ASYNC_QUEUE_SIZE; i++) {
+		if (_signingPending[i].state == SIGN_PENDING_FREE) {
+			entry = &_signingPending[i];
+			break;
+		}
+	}
+	if (!entry) {
+		// Waiting for the nonce here would request a second nonce from a node we may already
+		// have a handshake with, invalidating the nonce of the queued message
+		SIGN_DEBUG(PSTR("!SGN:SGN:QUE FULL\n")); // No free entry, message dropped
+		return SIGN_QUEUE_FULL;
+	}
+	entry->msg = msg;
+	entry->to = to;
+	entry->order = _signingPendingOrder++;
+	entry->state = SIGN_PENDING_QUEUED;
+	SIGN_DEBUG(PSTR("SGN:SGN:QUE,TO=%" PRIu8 "\n"), msg.getDestination());
+	signerPendingRequestNonce(msg.getDestination());
+	return SIGN_QUEUE_QUEUED;
+#else
+	(void)to;
+	(void)msg;
+	return SIGN_QUEUE_BYPASS;
+#endif
+}
+
 // cppcheck-suppress constParameter
 bool signerVerifyMsg(MyMessage &msg)
 {
@@ -321,6 +398,69 @@ bool signerVerifyMsg(MyMessage &msg)
 	return verificationResult;
 }
 
+#if defined(MY_SIGNING_FEATURE)
+void signerNonceTablePut(const uint8_t nodeId, const uint8_t *nonce)
+{
+	const uint32_t now = hwMillis();
+	signerNonceEntry_t *entry = NULL;
+	signerNonceEntry_t *oldest = &_signingNonceTable[0];
+	for (uint8_t i = 0; i < MY_SIGNING_NONCE_TABLE_SIZE; i++) {
+		signerNonceEntry_t *current = &_signingNonceTable[i];
+		if (current->nodeId == nodeId) {
+			entry = current;
+			break;
+		}
+		if (current->nodeId == SIGN_NONCE_UNUSED) {
+			if (!entry) {
+				entry = current;
+			}
+		} else if (now - current->timestamp > now - oldest->timestamp) {
+			oldest = current;
+		}
+	}
+	if (!entry) {
+		SIGN_DEBUG(PSTR("!SGN:NCE:EVICT,ID=%" PRIu8 "\n"), oldest->nodeId);
+		entry = oldest;
+	}
+	entry->nodeId = nodeId;
+	entry->timestamp = now;
+	(void)memcpy((void *)entry->nonce, (const void *)nonce, sizeof(entry->nonce));
+}
+
+bool signerNonceTableTake(const uint8_t nodeId, uint8_t *nonce)
+{
+	for (uint8_t i = 0; i < MY_SIGNING_NONCE_TABLE_SIZE; i++) {
+		signerNonceEntry_t *current = &_signingNonceTable[i];
+		if (current->nodeId == nodeId) {
+			const bool valid = hwMillis() - current->timestamp <= MY_VERIFICATION_TIMEOUT_MS;
+			if (valid) {
+				(void)memcpy((void *)nonce, (const void *)current->nonce, sizeof(current->nonce));
+			}
+			// Purge nonce, it is used only once
+			(void)memset((void *)current->nonce, 0xAA, sizeof(current->nonce));
+			current->nodeId = SIGN_NONCE_UNUSED;
+			return valid;
+		}
+	}
+	return false;
+}
+
+bool signerNonceTableExpire(void)
+{
+	bool result = true;
+	const uint32_t now = hwMillis();
+	for (uint8_t i = 0; i < MY_SIGNING_NONCE_TABLE_SIZE; i++) {
+		signerNonceEntry_t *current = &_signingNonceTable[i];
+		if (current->nodeId != SIGN_NONCE_UNUSED && now - current->timestamp > MY_VERIFICATION_TIMEOUT_MS) {
+			(void)memset((void *)current->nonce, 0xAA, sizeof(current->nonce));
+			current->nodeId = SIGN_NONCE_UNUSED;
+			result = false;
+		}
+	}
+	return result;
+}
+#endif // MY_SIGNING_FEATURE
+
 int signerMemcmp(const void* a, const void* b, size_t sz)
 {
 	int retVal;
@@ -354,28 +494,111 @@ int signerMemcmp(const void* a, const void* b, size_t sz)
 #if defined(MY_SIGNING_FEATURE)
 // Helper function to centralize signing/verification exceptions
 // cppcheck-suppress constParameter
-static bool skipSign(MyMessage &msg)
+#if defined(SIGNING_ASYNC_QUEUE)
+// Helper to request a nonce for the oldest queued message to destination
+// Only one nonce request per destination is in flight, as the destination keeps one nonce per sender
+static void signerPendingRequestNonce(const uint8_t destination)
 {
-	bool ret = false;
-	if (msg.isEcho()) {
-		ret = true;
-	}	else if (msg.getCommand() == C_INTERNAL &&
-	             (msg.getType() == I_SIGNING_PRESENTATION	||
-	              msg.getType() == I_REGISTRATION_REQUEST	||
-	              msg.getType() == I_NONCE_REQUEST					|| msg.getType() == I_NONCE_RESPONSE				||
-	              msg.getType() == I_ID_REQUEST						|| msg.getType() == I_ID_RESPONSE					||
-	              msg.getType() == I_FIND_PARENT_REQUEST		|| msg.getType() == I_FIND_PARENT_RESPONSE	||
-	              msg.getType() == I_HEARTBEAT_REQUEST			|| msg.getType() == I_HEARTBEAT_RESPONSE		||
-	              msg.getType() == I_PING									|| msg.getType() == I_PONG									||
-	              msg.getType() == I_DISCOVER_REQUEST	    || msg.getType() == I_DISCOVER_RESPONSE    ||
-	              msg.getType() == I_LOG_MESSAGE)) {
-		ret = true;
-	} else if (msg.getCommand() == C_STREAM &&
-	           (msg.getType() == ST_SOUND            ||
-	            msg.getType() == ST_IMAGE            ||
-	            msg.getType() == ST_FIRMWARE_REQUEST || msg.getType() == ST_FIRMWARE_RESPONSE )) {
-		ret = true;
+	while (true) {
+		signerPendingEntry_t *next = NULL;
+		for (uint8_t i = 0; i < MY_SIGNING_ASYNC_QUEUE_SIZE; i++) {
+			signerPendingEntry_t *current = &_signingPending[i];
+			if (current->state == SIGN_PENDING_FREE || current->msg.getDestination() != destination) {
+				continue;
+			}
+			if (current->state == SIGN_PENDING_NONCE) {
+				return; // Handshake with destination ongoing
+			}
+			if (!next || (int16_t)(current->order - next->order) < 0) {
+				next = current;
+			}
+		}
+		if (!next) {
+			return;
+		}
+		MyMessage request;
+		next->state = SIGN_PENDING_NONCE;
+		next->timestamp = hwMillis();
+		if (_sendRoute(build(request, destination, next->msg.getSensor(), C_INTERNAL,
+		                     I_NONCE_REQUEST).set(""))) {
+			SIGN_DEBUG(PSTR("SGN:SGN:NCE REQ,TO=%" PRIu8 "\n"), destination); // Nonce requested
+			return;
+		}
+		SIGN_DEBUG(PSTR("!SGN:SGN:NCE REQ,TO=%" PRIu8 " FAIL\n"),
+		           destination); // Failed to transmit nonce request!
+		setIndication(INDICATION_ERR_SIGN);
+		next->state = SIGN_PENDING_FREE;
+	}
+}
+
+// Helper to sign and transmit the queued message the received nonce belongs to
+static bool signerPendingComplete(MyMessage &msg)
+{
+	const uint8_t sender = msg.getSender();
+	signerPendingEntry_t *entry = NULL;
+	for (uint8_t i = 0; i < MY_SIGNING_ASYNC_QUEUE_SIZE; i++) {
+		if (_signingPending[i].state == SIGN_PENDING_NONCE &&
+		        _signingPending[i].msg.getDestination() == sender) {
+			entry = &_signingPending[i];
+			break;
+		}
 	}
+	if (!entry) {
+		return false;
+	}
+	signerBackendPutNonce(msg);
+	if (signerBackendSignMsg(entry->msg)) {
+		SIGN_DEBUG(PSTR("SGN:SGN:SGN\n")); // Message to send has been signed
+		(void)transportSendFrame(entry->to, entry->msg);
+	} else {
+		SIGN_DEBUG(PSTR("!SGN:SGN:SGN FAIL\n")); // Message to send could not be signed!
+		setIndication(INDICATION_ERR_SIGN);
+	}
+	entry->state = SIGN_PENDING_FREE;
+	signerPendingRequestNonce(sender);
+	return true;
+}
+
+// Helper to drop queued messages whose nonce did not arrive in time
+static void signerPendingExpire(void)
+{
+	for (uint8_t i = 0; i < MY_SIGNING_ASYNC_QUEUE_SIZE; i++) {
+		signerPendingEntry_t *current = &_signingPending[i];
+		if (current->state == SIGN_PENDING_NONCE &&
+		        hwMillis() - current->timestamp > MY_VERIFICATION_TIMEOUT_MS) {
+			const uint8_t destination = current->msg.getDestination();
+			SIGN_DEBUG(PSTR("!SGN:SGN:NCE TMO,TO=%" PRIu8 "\n"), destination); // Timeout waiting for nonce!
+			setIndication(INDICATION_ERR_SIGN);
+			current->state = SIGN_PENDING_FREE;
+			signerPendingRequestNonce(destination);
+		}
+	}
+}
+#endif // SIGNING_ASYNC_QUEUE
+
+// Helper to check if a message type is exempt from signing
+static bool isSkipSign(const MyMessage &msg)
+{
+	return msg.isEcho() ||
+	       (msg.getCommand() == C_INTERNAL &&
+	        (msg.getType() == I_SIGNING_PRESENTATION	||
+	         msg.getType() == I_REGISTRATION_REQUEST	||
+	         msg.getType() == I_NONCE_REQUEST					|| msg.getType() == I_NONCE_RESPONSE				||
+	         msg.getType() == I_ID_REQUEST						|| msg.getType() == I_ID_RESPONSE					||
+	         msg.getType() == I_FIND_PARENT_REQUEST		|| msg.getType() == I_FIND_PARENT_RESPONSE	||
+	         msg.getType() == I_HEARTBEAT_REQUEST			|| msg.getType() == I_HEARTBEAT_RESPONSE		||
+	         msg.getType() == I_PING									|| msg.getType() == I_PONG									||
+	         msg.getType() == I_DISCOVER_REQUEST	    || msg.getType() == I_DISCOVER_RESPONSE    ||
+	         msg.getType() == I_LOG_MESSAGE)) ||
+	       (msg.getCommand() == C_STREAM &&
+	        (msg.getType() == ST_SOUND            ||
+	         msg.getType() == ST_IMAGE            ||
+	         msg.getType() == ST_FIRMWARE_REQUEST || msg.getType() == ST_FIRMWARE_RESPONSE ));
+}
+
+static bool skipSign(MyMessage &msg)
+{
+	const bool ret = isSkipSign(msg);
 	if (ret) {
 		SIGN_DEBUG(PSTR("SGN:SKP:%s CMD=%" PRIu8 ",TYPE=%" PRIu8 "\n"), msg.isEcho() ? "ECHO" : "MSG",
 		           msg.getCommand(),
@@ -548,6 +771,11 @@ static bool signerInternalProcessNonceResponse(MyMessage &msg)
 #if defined(MY_SIGNING_FEATURE)
 	// Proceed with signing if nonce has been received
 	SIGN_DEBUG(PSTR("SGN:NCE:FROM=%" PRIu8 "\n"), msg.getSender());
+#if defined(SIGNING_ASYNC_QUEUE)
+	if (signerPendingComplete(msg)) {
+		return true;
+	}
+#endif
 	if (msg.getSender() != _msgSign.getDestination()) {
 		SIGN_DEBUG(PSTR("SGN:NCE:%" PRIu8 "!=%" PRIu8 " (DROPPED)\n"), _msgSign.getDestination(),
 		           msg.getSender());
@@ -609,6 +609,15 @@ typedef struct {
 } whitelist_entry_t;
 #endif
 
+/**
+ * @brief Result of @ref signerQueueMsg
+ */
+typedef enum {
+	SIGN_QUEUE_BYPASS,   //!< Message does not wait for a nonce, sign it with @ref signerSignMsg
+	SIGN_QUEUE_QUEUED,   //!< Message queued, it is signed and sent when the nonce arrives
+	SIGN_QUEUE_FULL      //!< No free queue entry, message dropped
+} signerQueueResult_t;
+
 /** @brief Helper macro to determine the number of elements in a array */
 #define NUM_OF(x) (sizeof(x)/sizeof(x[0]))
 
@@ -694,6 +703,25 @@ bool signerPutNonce(MyMessage &msg);
 */
 bool signerSignMsg(MyMessage &msg);
 
+/**
+ * @brief Queues provided message until its destination has returned a nonce.
+ *
+ * Requests a nonce for the message without waiting for it. When the nonce arrives,
+ * @ref signerProcessInternal() signs the message and transmits it to @p to.<br>
+ * If no queue entry is free, the message is dropped. It is not signed in the send call,
+ * as a second nonce request would replace the nonce of a queued handshake with the same node.<br>
+ * Only available with @ref MY_SIGNING_ASYNC_QUEUE_SIZE larger than 0, always returns
+ * @ref SIGN_QUEUE_BYPASS otherwise.
+ * \n@b Usage: This function is called by the transport before transmitting a message.
+ *
+ * @param to Next hop of the message.
+ * @param msg The message to sign.
+ * @returns @ref SIGN_QUEUE_BYPASS if the message does not need a nonce and the caller signs
+ *          it with @ref signerSignMsg(), @ref SIGN_QUEUE_QUEUED if it has been queued,
+ *          @ref SIGN_QUEUE_FULL if it has been dropped.
+ */
+signerQueueResult_t signerQueueMsg(const uint8_t to, MyMessage &msg);
+
 /**
  * @brief Verifies signature in provided message.
  *
@@ -711,6 +739,37 @@ bool signerSignMsg(MyMessage &msg);
  */
 bool signerVerifyMsg(MyMessage &msg);
 
+/**
+ * @brief Store a verification nonce sent to a node.
+ *
+ * A pending nonce of the same node is replaced. When all @ref MY_SIGNING_NONCE_TABLE_SIZE
+ * entries are in use, the oldest nonce is evicted.
+ * \n@b Usage: Called by the signing backend when a nonce is generated.
+ *
+ * @param nodeId The node the nonce is sent to.
+ * @param nonce The 32 byte nonce.
+ */
+void signerNonceTablePut(const uint8_t nodeId, const uint8_t *nonce);
+
+/**
+ * @brief Take the verification nonce of a node out of the table.
+ *
+ * The entry is purged to prevent re-use of the nonce.
+ * \n@b Usage: Called by the signing backend before verifying a message from the node.
+ *
+ * @param nodeId The node that signed the message.
+ * @param nonce Buffer receiving the 32 byte nonce.
+ * @returns @c true if an unexpired nonce was stored for the node.
+ */
+bool signerNonceTableTake(const uint8_t nodeId, uint8_t *nonce);
+
+/**
+ * @brief Purge verification nonces older than @ref MY_VERIFICATION_TIMEOUT_MS.
+ *
+ * @returns @c true if no nonce expired.
+ */
+bool signerNonceTableExpire(void);
+
 /**
  * @brief Do a timing neutral memory comparison.
  *
@@ -743,7 +802,7 @@ int signerMemcmp(const void* a, const void* b, size_t sz);
  *  - SGN:<b>INI</b>	from @ref signerInit
  *  - SGN:<b>PER</b>	from @ref signerInit
  *  - SGN:<b>PRE</b>	from @ref signerPresentation
- *  - SGN:<b>SGN</b>	from @ref signerSignMsg
+ *  - SGN:<b>SGN</b>	from @ref signerSignMsg or @ref signerQueueMsg
  *  - SGN:<b>VER</b>	from @ref signerVerifyMsg
  *  - SGN:<b>SKP</b>	from @ref signerSignMsg or @ref signerVerifyMsg (skipSign)
  *  - SGN:<b>NCE</b>	from @ref signerProcessInternal (signerInternalProcessNonceRequest)
@@ -780,6 +839,9 @@ int signerMemcmp(const void* a, const void* b, size_t sz);
  * | | SGN | SGN | NCE REQ,TO='node'				| Nonce request transmitted to 'node'
  * |!| SGN | SGN | NCE REQ,TO='node' FAIL		| Nonce request not properly transmitted to 'node'
  * |!| SGN | SGN | NCE TMO									| Timeout waiting for nonce
+ * |!| SGN | SGN | NCE TMO,TO='node'				| Timeout waiting for nonce from 'node', queued message dropped
+ * | | SGN | SGN | QUE,TO='node'						| Message to 'node' queued until its nonce arrives
+ * |!| SGN | SGN | QUE FULL									| Signing queue full, message dropped
  * | | SGN | SGN | SGN											| Message signed
  * |!| SGN | SGN | SGN FAIL									| Message failed to be signed
  * | | SGN | SGN | NREQ='node'							| 'node' does not require signed messages
@@ -796,6 +858,7 @@ int signerMemcmp(const void* a, const void* b, size_t sz);
  * | | SGN | NCE | XMT,TO='node'						| Nonce data transmitted to 'node'
  * |!| SGN | NCE | XMT,TO='node' FAIL				| Nonce data not properly transmitted to 'node'
  * |!| SGN | NCE | GEN											| Failed to generate nonce
+ * |!| SGN | NCE | EVICT,ID='node'					| Nonce table full, pending nonce of 'node' dropped
  * | | SGN | NCE | NSUP (DROPPED)						| Ignored nonce/request for nonce (signing not supported)
  * | | SGN | NCE | FROM='node'							| Received nonce from 'node'
  * | | SGN | NCE | 'sender'!='dst' (DROPPED)| Ignoring nonce as it did not come from the designation of the message to sign
@@ -807,7 +870,7 @@ int signerMemcmp(const void* a, const void* b, size_t sz);
  * |!| SGN | BND | SIG,SIZE,'message'>'max'	| Refusing to sign 'message' because it is bigger than 'max' allowed size
  * | | SGN | BND | SIG WHI,ID='id'					| Salting message with our 'id'
  * | | SGN | BND | SIG WHI,SERIAL='serial'	| Salting message with our 'serial'
- * |!| SGN | BND | VER ONGOING							| Verification failed, no ongoing session
+ * |!| SGN | BND | VER ONGOING							| Verification failed, no ongoing session with the sender
  * |!| SGN | BND | VER,IDENT='identifier'		| Verification failed, 'identifier' is unknown
  * | | SGN | BND | VER WHI,ID='sender'			| 'sender' found in whitelist
  * | | SGN | BND | VER WHI,SERIAL='serial'	| Expecting 'serial' for this sender
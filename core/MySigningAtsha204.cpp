@@ -37,8 +37,6 @@
 #define SIGN_DEBUG(x,...)
 #endif
 
-static unsigned long _signing_timestamp;
-static bool _signing_verification_ongoing = false;
 static uint8_t _signing_verifying_nonce[32+9+1];
 static uint8_t _signing_signing_nonce[32+9+1];
 static uint8_t _signing_temp_message[SHA_MSG_SIZE];
@@ -86,23 +84,10 @@ bool signerAtsha204CheckTimer(void)
 	if (!init_ok) {
 		return false;
 	}
-	if (_signing_verification_ongoing) {
-		unsigned long time_now = hwMillis();
-		// If timestamp is taken so late a rollover can take place during the timeout,
-		// offset both timestamp and current time to make sure no rollover takes place during the
-		// timeout
-		if (_signing_timestamp + MY_VERIFICATION_TIMEOUT_MS < _signing_timestamp) {
-			_signing_timestamp += MY_VERIFICATION_TIMEOUT_MS;
-			time_now += MY_VERIFICATION_TIMEOUT_MS;
-		}
-		if (time_now > _signing_timestamp + MY_VERIFICATION_TIMEOUT_MS) {
-			SIGN_DEBUG(PSTR("!SGN:BND:TMR\n")); //Verification timeout
-			// Purge nonce
-			memset(_signing_signing_nonce, 0xAA, 32);
-			memset(_signing_verifying_nonce, 0xAA, 32);
-			_signing_verification_ongoing = false;
-			return false;
-		}
+	// Purge nonces which were not used in time
+	if (!signerNonceTableExpire()) {
+		SIGN_DEBUG(PSTR("!SGN:BND:TMR\n")); //Verification timeout
+		return false;
 	}
 	return true;
 }
@@ -139,8 +124,9 @@ bool signerAtsha204GetNonce(MyMessage &msg)
 
 	// Transfer the first part of the nonce to the message
 	msg.set(_signing_verifying_nonce, min((uint8_t)MAX_PAYLOAD_SIZE, 32u));
-	_signing_verification_ongoing = true;
-	_signing_timestamp = hwMillis(); // Set timestamp to determine when to purge nonce
+	// Remember the nonce until the sender returns a message signed with it
+	signerNonceTablePut(msg.getSender(), _signing_verifying_nonce);
+	(void)memset((void *)_signing_verifying_nonce, 0xAA, 32);
 	return true;
 }
 
@@ -204,17 +190,11 @@ bool signerAtsha204SignMsg(MyMessage &msg)
 
 bool signerAtsha204VerifyMsg(MyMessage &msg)
 {
-	if (!_signing_verification_ongoing) {
+	// Fetch the nonce sent to the sender, it is purged and must not have expired
+	if (!signerNonceTableTake(msg.getSender(), _signing_verifying_nonce)) {
 		SIGN_DEBUG(PSTR("!SGN:BND:VER ONGOING\n"));
 		return false;
 	} else {
-		// Make sure we have not expired
-		if (!signerCheckTimer()) {
-			return false;
-		}
-
-		_signing_verification_ongoing = false;
-
 		if (msg.data[msg.getLength()] != SIGNING_IDENTIFIER) {
 			SIGN_DEBUG(PSTR("!SGN:BND:VER,IDENT=%" PRIu8 "\n"), msg.data[msg.getLength()]);
 			return false;
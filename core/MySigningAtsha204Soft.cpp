@@ -40,12 +40,13 @@
 #define SIGN_DEBUG(x,...)
 #endif
 
-static unsigned long _signing_timestamp;
-static bool _signing_verification_ongoing = false;
 static bool _signing_init_ok = false;
 static uint8_t _signing_verifying_nonce[32+9+1];
 static uint8_t _signing_nonce[32+9+1];
 static uint8_t _signing_hmac_key[SIZE_SIGNING_SOFT_HMAC_KEY];
+#if defined(MY_CRYPTO_SHA256HMAC_KEYED)
+static _SHA256HMACcontext_t _signing_hmac_keyed;	// HMAC states after hashing the key
+#endif
 static uint8_t _signing_hmac[32];
 static uint8_t _signing_node_serial_info[SIZE_SIGNING_SOFT_SERIAL];
 
@@ -81,6 +82,9 @@ bool signerAtsha204SoftInit(void)
 	hwReadConfigBlock((void *)_signing_node_serial_info, (void *)EEPROM_SIGNING_SOFT_SERIAL_ADDRESS,
 	                  SIZE_SIGNING_SOFT_SERIAL);
 #endif
+#if defined(MY_CRYPTO_SHA256HMAC_KEYED)
+	SHA256HMACInit(&_signing_hmac_keyed, _signing_hmac_key, SIZE_SIGNING_SOFT_HMAC_KEY);
+#endif
 
 	uint16_t chk = 0;
 	for (uint8_t i = 0; i < SIZE_SIGNING_SOFT_SERIAL; i++) {
@@ -103,23 +107,10 @@ bool signerAtsha204SoftCheckTimer(void)
 	if (!_signing_init_ok) {
 		return false;
 	}
-	if (_signing_verification_ongoing) {
-		unsigned long time_now = hwMillis();
-		// If timestamp is taken so late a rollover can take place during the timeout,
-		// offset both timestamp and current time to make sure no rollover takes place during the
-		// timeout
-		if (_signing_timestamp + MY_VERIFICATION_TIMEOUT_MS < _signing_timestamp) {
-			_signing_timestamp += MY_VERIFICATION_TIMEOUT_MS;
-			time_now += MY_VERIFICATION_TIMEOUT_MS;
-		}
-		if (time_now > _signing_timestamp + MY_VERIFICATION_TIMEOUT_MS) {
-			SIGN_DEBUG(PSTR("!SGN:BND:TMR\n")); //Verification timeout
-			// Purge nonce
-			(void)memset((void *)_signing_nonce, 0xAA, sizeof(_signing_nonce));
-			(void)memset((void *)_signing_verifying_nonce, 0xAA, sizeof(_signing_verifying_nonce));
-			_signing_verification_ongoing = false;
-			return false;
-		}
+	// Purge nonces which were not used in time
+	if (!signerNonceTableExpire()) {
+		SIGN_DEBUG(PSTR("!SGN:BND:TMR\n")); //Verification timeout
+		return false;
 	}
 	return true;
 }
@@ -150,14 +141,9 @@ bool signerAtsha204SoftGetNonce(MyMessage &msg)
 
 	// Transfer the first part of the nonce to the message
 	msg.set(_signing_verifying_nonce, MIN((uint8_t)MAX_PAYLOAD_SIZE, (uint8_t)32));
-	_signing_verification_ongoing = true;
-	_signing_timestamp = hwMillis(); // Set timestamp to determine when to purge nonce
-	// Be a little fancy to handle turnover (prolong the time allowed to timeout after turnover)
-	// Note that if message is "too" quick, and arrives before turnover, it will be rejected
-	// but this is consider such a rare case that it is accepted and rejects are 'safe'
-	if (_signing_timestamp + MY_VERIFICATION_TIMEOUT_MS < hwMillis()) {
-		_signing_timestamp = 0;
-	}
+	// Remember the nonce until the sender returns a message signed with it
+	signerNonceTablePut(msg.getSender(), _signing_verifying_nonce);
+	(void)memset((void *)_signing_verifying_nonce, 0xAA, 32);
 	return true;
 }
 
@@ -215,17 +201,11 @@ bool signerAtsha204SoftSignMsg(MyMessage &msg)
 
 bool signerAtsha204SoftVerifyMsg(MyMessage &msg)
 {
-	if (!_signing_verification_ongoing) {
+	// Fetch the nonce sent to the sender, it is purged and must not have expired
+	if (!signerNonceTableTake(msg.getSender(), _signing_verifying_nonce)) {
 		SIGN_DEBUG(PSTR("!SGN:BND:VER ONGOING\n"));
 		return false;
 	} else {
-		// Make sure we have not expired
-		if (!signerCheckTimer()) {
-			return false;
-		}
-
-		_signing_verification_ongoing = false;
-
 		if (msg.data[msg.getLength()] != SIGNING_IDENTIFIER) {
 			SIGN_DEBUG(PSTR("!SGN:BND:VER,IDENT=%" PRIu8 "\n"), msg.data[msg.getLength()]);
 			return false;
@@ -369,7 +349,11 @@ static void signerAtsha204AHmac(uint8_t *dest, const uint8_t *nonce, const uint8
 	_signing_buffer[21 + 64] = 0x23;
 	//_signing_buffer[22 + 64] = 0x00; // SN[0]
 	//_signing_buffer[23 + 64] = 0x00; // SN[1]
+#if defined(MY_CRYPTO_SHA256HMAC_KEYED)
+	SHA256HMACKeyed(dest, &_signing_hmac_keyed, _signing_buffer, 88);
+#else
 	SHA256HMAC(dest, _signing_hmac_key, 32, _signing_buffer, 88);
+#endif
 }
 
 #endif //MY_SIGNING_SOFT
@@ -58,6 +58,16 @@ extern MyMessage _msgTmp;	// outgoing message
 static routingTable_t _transportRoutingTable;		//!< routing table
 static uint32_t _lastRoutingTableSave;			//!< last routing table dump
 #endif
+#if defined(MY_ROUTING_TABLE_METADATA_ENABLED)
+static routeInfo_t _transportRouteInfo[SIZE_ROUTES];	//!< routing table metadata
+#endif
+#if defined(MY_TRANSPORT_ROUTE_FAILOVER_ENABLED)
+static uint8_t _transportRouteAlt[SIZE_ROUTES][MY_TRANSPORT_ROUTE_CANDIDATES - 1];	//!< alternative next hops
+static uint8_t _transportRouteAltHops[SIZE_ROUTES][MY_TRANSPORT_ROUTE_CANDIDATES - 1];	//!< hops via alternative next hops
+#endif
+#if defined(MY_TRANSPORT_PARENT_FAILOVER_ENABLED)
+static parentCandidate_t _transportParents[MY_TRANSPORT_ROUTE_CANDIDATES];	//!< parent candidates
+#endif
 
 // regular sanity check, activated by default on GW and repeater nodes
 #if defined(MY_TRANSPORT_SANITY_CHECK)
@@ -157,6 +167,11 @@ void stParentTransition(void)
 	_transportSM.findingParentNode = true;
 	_transportConfig.distanceGW = DISTANCE_INVALID;	// Set distance to max and invalidate parent node ID
 	_transportConfig.parentNodeId = AUTO;
+#if defined(MY_TRANSPORT_PARENT_FAILOVER_ENABLED)
+	for (uint8_t i = 0; i < MY_TRANSPORT_ROUTE_CANDIDATES; i++) {
+		_transportParents[i].nodeId = AUTO;
+	}
+#endif
 	// Broadcast find parent request
 	(void)transportRouteMessage(build(_msgTmp, BROADCAST_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
 	                                  I_FIND_PARENT_REQUEST).set(""));
@@ -520,6 +535,10 @@ bool transportRouteMessage(MyMessage &message)
 	}
 
 	uint8_t route;
+#if defined(MY_TRANSPORT_ROUTE_FAILOVER_ENABLED) && !defined(MY_TRANSPORT_ASYNC_SEND)
+	uint8_t candidates[MY_TRANSPORT_ROUTE_CANDIDATES];
+	uint8_t candidateCount = 0;
+#endif
 
 	if (destination == GATEWAY_ADDRESS) {
 		route = _transportConfig.parentNodeId;		// message to GW always routes via parent
@@ -544,6 +563,20 @@ bool transportRouteMessage(MyMessage &message)
 			route = destination;
 #endif
 		}
+#if defined(MY_TRANSPORT_ROUTE_FAILOVER_ENABLED)
+		else {
+			// start with the best scoring next hop, never fail over to the hop we received it from
+			const uint8_t previousHop = (message.getSender() == _transportConfig.nodeId) ? AUTO :
+			                            message.getLast();
+#if defined(MY_TRANSPORT_ASYNC_SEND)
+			uint8_t candidates[MY_TRANSPORT_ROUTE_CANDIDATES];
+			(void)transportGetRouteCandidates(destination, candidates, previousHop);
+#else
+			candidateCount = transportGetRouteCandidates(destination, candidates, previousHop);
+#endif
+			route = candidates[0];
+		}
+#endif
 #else
 		if (destination > GATEWAY_ADDRESS && destination < BROADCAST_ADDRESS) {
 			// node2node traffic: assume node is in vincinity. If transmission fails, hand over to parent
@@ -557,24 +590,35 @@ bool transportRouteMessage(MyMessage &message)
 #endif
 	}
 	// send message
-	const bool result = transportSendWrite(route, message);
+	bool result = transportSendWrite(route, message);
+#if defined(MY_TRANSPORT_ROUTE_FAILOVER_ENABLED) && !defined(MY_TRANSPORT_ASYNC_SEND)
+	// retry on the next-best hops
+	for (uint8_t i = 1; !result && i < candidateCount; i++) {
+		route = candidates[i];
+		TRANSPORT_DEBUG(PSTR("!TSF:RTE:FOVR,DST=%" PRIu8 ",R=%" PRIu8 "\n"), destination, route);
+		result = transportSendWrite(route, message);
+	}
+#endif
 #if !defined(MY_GATEWAY_FEATURE)
 	// update counter
 	if (route == _transportConfig.parentNodeId) {
-
+#if defined(MY_TRANSPORT_ASYNC_SEND)
+		// queued frames are counted when completed, see transportSendComplete()
 		if (!result) {
-			setIndication(INDICATION_ERR_TX);
-			_transportSM.failedUplinkTransmissions++;
-		} else {
-			_transportSM.failedUplinkTransmissions = 0u;
-#if defined(MY_SIGNAL_REPORT_ENABLED)
-			// update uplink quality monitor
-			const int16_t signalStrengthRSSI = transportGetSignalReport(SR_TX_RSSI);
-			_transportSM.uplinkQualityRSSI = static_cast<transportRSSI_t>((1 - UPLINK_QUALITY_WEIGHT) *
-			                                 _transportSM.uplinkQualityRSSI
-			                                 + (UPLINK_QUALITY_WEIGHT * transportRSSItoInternal(signalStrengthRSSI)));
-#endif
+			transportUpdateUplink(false);
 		}
+#else
+		transportUpdateUplink(result);
+#if defined(MY_TRANSPORT_PARENT_FAILOVER_ENABLED)
+		// failover switched parent, retry immediately
+		for (uint8_t i = 1; !result && route != _transportConfig.parentNodeId &&
+		        i < MY_TRANSPORT_ROUTE_CANDIDATES; i++) {
+			route = _transportConfig.parentNodeId;
+			result = transportSendWrite(route, message);
+			transportUpdateUplink(result);
+		}
+#endif
+#endif
 	}
 #else
 	if(!result) {
@@ -585,6 +629,64 @@ bool transportRouteMessage(MyMessage &message)
 	return result;
 }
 
+#if !defined(MY_GATEWAY_FEATURE)
+void transportUpdateUplink(const bool success)
+{
+#if defined(MY_TRANSPORT_PARENT_FAILOVER_ENABLED)
+	for (uint8_t i = 0; i < MY_TRANSPORT_ROUTE_CANDIDATES; i++) {
+		parentCandidate_t *candidate = &_transportParents[i];
+		if (candidate->nodeId == _transportConfig.parentNodeId) {
+			if (success) {
+				candidate->failures = 0;
+				const int16_t RSSI = transportHALGetSendingRSSI();
+				if (RSSI != INVALID_RSSI) {
+					candidate->RSSI = RSSI;
+				}
+			} else if (candidate->failures < UINT8_MAX) {
+				candidate->failures++;
+			}
+		}
+	}
+#endif
+	if (!success) {
+		setIndication(INDICATION_ERR_TX);
+		_transportSM.failedUplinkTransmissions++;
+#if defined(MY_TRANSPORT_PARENT_FAILOVER_ENABLED)
+		(void)transportParentFailover();
+#endif
+	} else {
+		_transportSM.failedUplinkTransmissions = 0u;
+#if defined(MY_SIGNAL_REPORT_ENABLED)
+		// update uplink quality monitor
+		const int16_t signalStrengthRSSI = transportGetSignalReport(SR_TX_RSSI);
+		_transportSM.uplinkQualityRSSI = static_cast<transportRSSI_t>((1 - UPLINK_QUALITY_WEIGHT) *
+		                                 _transportSM.uplinkQualityRSSI
+		                                 + (UPLINK_QUALITY_WEIGHT * transportRSSItoInternal(signalStrengthRSSI)));
+#endif
+	}
+}
+#endif
+
+#if defined(MY_TRANSPORT_ASYNC_SEND)
+void transportSendComplete(const uint8_t to, const bool success)
+{
+	TRANSPORT_DEBUG(PSTR("%sTSF:SND:DONE,TO=%" PRIu8 ",ST=%s\n"), (success ? "" : "!"), to,
+	                (success ? "OK" : "NACK"));
+	if (to != BROADCAST_ADDRESS) {
+		transportUpdateLink(to, success);
+	}
+#if !defined(MY_GATEWAY_FEATURE)
+	if (to == _transportConfig.parentNodeId) {
+		transportUpdateUplink(success);
+	}
+#else
+	if (!success) {
+		setIndication(INDICATION_ERR_TX);
+	}
+#endif
+}
+#endif
+
 bool transportSendRoute(MyMessage &message)
 {
 	bool result = false;
@@ -676,6 +778,11 @@ void transportProcessMessage(void)
 		return;
 	}
 
+#if defined(MY_TRANSPORT_ROUTE_FAILOVER_ENABLED)
+	// link quality of the neighbor that sent this frame
+	_transportRouteInfo[last].linkRSSI = transportHALGetReceivingRSSI();
+#endif
+
 	// update routing table if msg not from parent
 #if defined(MY_REPEATER_FEATURE)
 #if !defined(MY_GATEWAY_FEATURE)
@@ -688,6 +795,15 @@ void transportProcessMessage(void)
 		if (sender != _transportConfig.nodeId)
 		{
 			transportSetRoute(sender, last);
+			// direct child: one hop, PING/PONG to this node: hops counted on the way
+			uint8_t hops = INVALID_HOPS;
+			if (sender == last) {
+				hops = 1u;
+			} else if (command == C_INTERNAL && (type == I_PING || type == I_PONG) &&
+			           destination == _transportConfig.nodeId) {
+				hops = _msg.getByte();
+			}
+			transportSetRouteInfo(sender, hops, transportHALGetReceivingRSSI());
 		}
 	}
 #endif // MY_REPEATER_FEATURE
@@ -736,6 +852,9 @@ void transportProcessMessage(void)
 						// Reply to a I_FIND_PARENT_REQUEST message. Check if the distance is shorter than we already have.
 						uint8_t distance = _msg.getByte();
 						if (isValidDistance(distance)) {
+#if defined(MY_TRANSPORT_PARENT_FAILOVER_ENABLED)
+							transportAddParentCandidate(sender, distance, transportHALGetReceivingRSSI());
+#endif
 							distance++;	// Distance to gateway is one more for us w.r.t. parent
 							// update settings if distance shorter or preferred parent found
 							if (((isValidDistance(distance) && distance < _transportConfig.distanceGW) || (!_autoFindParent &&
@@ -811,6 +930,11 @@ void transportProcessMessage(void)
 				if(firmwareOTAUpdateProcess()) {
 					return; // OTA FW update processing indicated no further action needed
 				}
+#endif
+#if defined(MY_OTA_FIRMWARE_SERVER_ENABLED)
+				if (firmwareServerProcess()) {
+					return; // firmware request served by gateway, no further processing required
+				}
 #endif
 			}
 		} else {
@@ -937,11 +1061,11 @@ void transportInvokeSanityCheck(void)
 	}
 }
 
-void transportProcessFIFO(void)
+bool transportProcessHousekeeping(void)
 {
 	if (!_transportSM.transportActive) {
 		// transport not active, no further processing required
-		return;
+		return false;
 	}
 
 #if defined(MY_TRANSPORT_SANITY_CHECK)
@@ -950,17 +1074,40 @@ void transportProcessFIFO(void)
 		transportInvokeSanityCheck();
 	}
 #endif
-
-	uint8_t _processedMessages = MAX_SUBSEQ_MSGS;
-	// process all msgs in FIFO or counter exit
-	while (transportHALDataAvailable() && _processedMessages--) {
-		transportProcessMessage();
-	}
 #if defined(MY_OTA_FIRMWARE_FEATURE)
 	if (isTransportReady()) {
 		// only process if transport ok
 		firmwareOTAUpdateRequest();
 	}
+#endif
+	return true;
+}
+
+bool transportProcessNextMessage(void)
+{
+	if (!_transportSM.transportActive || !transportHALDataAvailable()) {
+		return false;
+	}
+	transportProcessMessage();
+	return true;
+}
+
+void transportProcessFIFO(void)
+{
+	if (!transportProcessHousekeeping()) {
+		return;
+	}
+
+	uint8_t _processedMessages = MAX_SUBSEQ_MSGS;
+	// process all msgs in FIFO or counter exit
+	while (_processedMessages && transportProcessNextMessage()) {
+		_processedMessages--;
+	}
+#if defined(__linux__)
+	if (!_processedMessages) {
+		// counter exit, do not block the main loop while messages are left in FIFO
+		EventLoop.wakeup();
+	}
 #endif
 }
 
@@ -968,13 +1115,28 @@ bool transportSendWrite(const uint8_t to, MyMessage &message)
 {
 	message.setLast(_transportConfig.nodeId); // Update last
 
+	// messages waiting for a nonce are signed and sent when the nonce arrives
+	const signerQueueResult_t queued = signerQueueMsg(to, message);
+	if (queued == SIGN_QUEUE_QUEUED) {
+		return true;
+	}
+	if (queued == SIGN_QUEUE_FULL) {
+		TRANSPORT_DEBUG(PSTR("!TSF:MSG:SIGN FAIL\n"));
+		setIndication(INDICATION_ERR_SIGN);
+		return false;
+	}
+
 	// sign message if required
 	if (!signerSignMsg(message)) {
 		TRANSPORT_DEBUG(PSTR("!TSF:MSG:SIGN FAIL\n"));
 		setIndication(INDICATION_ERR_SIGN);
 		return false;
 	}
+	return transportSendFrame(to, message);
+}
 
+bool transportSendFrame(const uint8_t to, MyMessage &message)
+{
 	// msg length changes if signed
 	const uint8_t totalMsgLength = HEADER_SIZE + ( message.getSigned() ? MAX_PAYLOAD_SIZE :
 	                               message.getLength() );
@@ -983,6 +1145,11 @@ bool transportSendWrite(const uint8_t to, MyMessage &message)
 	setIndication(INDICATION_TX);
 	const bool result = transportHALSend(to, &message, totalMsgLength,
 	                                     noACK);
+#if !defined(MY_TRANSPORT_ASYNC_SEND)
+	if (!noACK) {
+		transportUpdateLink(to, result);
+	}
+#endif
 
 	TRANSPORT_DEBUG(PSTR("%sTSF:MSG:SEND,%" PRIu8 "-%" PRIu8 "-%" PRIu8 "-%" PRIu8 ",s=%" PRIu8 ",c=%"
 	                     PRIu8 ",t=%" PRIu8 ",pt=%" PRIu8 ",l=%" PRIu8 ",sg=%" PRIu8 ",ft=%" PRIu8 ",st=%s:%s\n"),
@@ -1032,6 +1199,20 @@ void transportLoadRoutingTable(void)
 {
 #if defined(MY_RAM_ROUTING_TABLE_ENABLED)
 	hwReadConfigBlock((void*)&_transportRoutingTable.route, (void*)EEPROM_ROUTES_ADDRESS, SIZE_ROUTES);
+	(void)memset((void *)_transportRoutingTable.dirty, 0, sizeof(_transportRoutingTable.dirty));
+#if defined(MY_ROUTING_TABLE_METADATA_ENABLED)
+	for (uint16_t i = 0; i < SIZE_ROUTES; i++) {
+		_transportRouteInfo[i].lastSeen = 0;
+		_transportRouteInfo[i].RSSI = INVALID_RSSI;
+		_transportRouteInfo[i].linkRSSI = INVALID_RSSI;
+		_transportRouteInfo[i].hops = INVALID_HOPS;
+		_transportRouteInfo[i].txFailures = 0;
+	}
+#endif
+#if defined(MY_TRANSPORT_ROUTE_FAILOVER_ENABLED)
+	(void)memset((void *)_transportRouteAlt, AUTO, sizeof(_transportRouteAlt));
+	(void)memset((void *)_transportRouteAltHops, INVALID_HOPS, sizeof(_transportRouteAltHops));
+#endif
 	TRANSPORT_DEBUG(PSTR("TSF:LRT:OK\n"));	//  load routing table
 #endif
 }
@@ -1039,15 +1220,64 @@ void transportLoadRoutingTable(void)
 void transportSaveRoutingTable(void)
 {
 #if defined(MY_RAM_ROUTING_TABLE_ENABLED)
-	hwWriteConfigBlock((void*)&_transportRoutingTable.route, (void*)EEPROM_ROUTES_ADDRESS, SIZE_ROUTES);
-	TRANSPORT_DEBUG(PSTR("TSF:SRT:OK\n"));	//  save routing table
+	// write the span from first to last changed route in one block, i.e. one flash commit on ESP8266/ESP32
+	uint16_t first = SIZE_ROUTES;
+	uint16_t last = 0;
+	uint16_t changed = 0;
+	for (uint16_t i = 0; i < SIZE_ROUTES; i++) {
+		if (_transportRoutingTable.dirty[i >> 3] & (1u << (i & 7))) {
+			if (first == SIZE_ROUTES) {
+				first = i;
+			}
+			last = i;
+			changed++;
+		}
+	}
+	if (changed) {
+		hwWriteConfigBlock((void *)&_transportRoutingTable.route[first],
+		                   (void *)(uintptr_t)(EEPROM_ROUTES_ADDRESS + first), last - first + 1);
+		(void)memset((void *)_transportRoutingTable.dirty, 0, sizeof(_transportRoutingTable.dirty));
+	}
+	TRANSPORT_DEBUG(PSTR("TSF:SRT:OK,N=%" PRIu16 "\n"), changed);	//  save routing table
 #endif
 }
 
 void transportSetRoute(const uint8_t node, const uint8_t route)
 {
 #if defined(MY_RAM_ROUTING_TABLE_ENABLED)
-	_transportRoutingTable.route[node] = route;
+	if (_transportRoutingTable.route[node] != route) {
+#if defined(MY_TRANSPORT_ROUTE_FAILOVER_ENABLED)
+		// previous route becomes the first alternative, a cleared route drops all alternatives
+		uint8_t *alternatives = _transportRouteAlt[node];
+		uint8_t *alternativeHops = _transportRouteAltHops[node];
+		uint8_t list[MY_TRANSPORT_ROUTE_CANDIDATES - 1];
+		uint8_t listHops[MY_TRANSPORT_ROUTE_CANDIDATES - 1];
+		uint8_t count = 0;
+		for (uint8_t i = 0; i < MY_TRANSPORT_ROUTE_CANDIDATES && route != AUTO; i++) {
+			const uint8_t alternative = i ? alternatives[i - 1] : _transportRoutingTable.route[node];
+			bool keep = (alternative != AUTO && alternative != route);
+			for (uint8_t j = 0; j < count && keep; j++) {
+				keep = (list[j] != alternative);
+			}
+			if (keep && count < MY_TRANSPORT_ROUTE_CANDIDATES - 1) {
+				listHops[count] = i ? alternativeHops[i - 1] : _transportRouteInfo[node].hops;
+				list[count++] = alternative;
+			}
+		}
+		while (count < MY_TRANSPORT_ROUTE_CANDIDATES - 1) {
+			listHops[count] = INVALID_HOPS;
+			list[count++] = AUTO;
+		}
+		(void)memcpy((void *)alternatives, (const void *)list, sizeof(list));
+		(void)memcpy((void *)alternativeHops, (const void *)listHops, sizeof(listHops));
+#endif
+		_transportRoutingTable.route[node] = route;
+		_transportRoutingTable.dirty[node >> 3] |= (1u << (node & 7));
+#if defined(MY_ROUTING_TABLE_METADATA_ENABLED)
+		// hops via the old route no longer apply
+		_transportRouteInfo[node].hops = INVALID_HOPS;
+#endif
+	}
 #else
 	hwWriteConfig(EEPROM_ROUTES_ADDRESS + node, route);
 #endif
@@ -1064,6 +1294,177 @@ uint8_t transportGetRoute(const uint8_t node)
 	return result;
 }
 
+void transportSetRouteInfo(const uint8_t node, const uint8_t hops, const int16_t RSSI)
+{
+#if defined(MY_ROUTING_TABLE_METADATA_ENABLED)
+	routeInfo_t *info = &_transportRouteInfo[node];
+	info->lastSeen = hwMillis();
+	info->RSSI = RSSI;
+	if (hops != INVALID_HOPS) {
+		info->hops = hops;
+	}
+#else
+	(void)node;
+	(void)hops;
+	(void)RSSI;
+#endif
+}
+
+bool transportGetRouteInfo(const uint8_t node, routeInfo_t *info)
+{
+#if defined(MY_ROUTING_TABLE_METADATA_ENABLED)
+	*info = _transportRouteInfo[node];
+	return info->lastSeen != 0;
+#else
+	(void)node;
+	(void)info;
+	return false;
+#endif
+}
+
+int16_t transportScoreLink(const int16_t RSSI, const uint8_t failures)
+{
+	// links without RSSI (e.g. RF24, RS485) are ranked by failures only
+	const int16_t score = (RSSI == INVALID_RSSI) ? 0 : RSSI;
+	return score - (int16_t)failures * MY_TRANSPORT_ROUTE_FAILURE_PENALTY;
+}
+
+void transportUpdateLink(const uint8_t node, const bool success)
+{
+#if defined(MY_TRANSPORT_ROUTE_FAILOVER_ENABLED)
+	routeInfo_t *info = &_transportRouteInfo[node];
+	if (success) {
+		info->txFailures = 0;
+		const int16_t RSSI = transportHALGetSendingRSSI();
+		if (RSSI != INVALID_RSSI) {
+			info->linkRSSI = RSSI;
+		}
+	} else if (info->txFailures < UINT8_MAX) {
+		info->txFailures++;
+	}
+#else
+	(void)node;
+	(void)success;
+#endif
+}
+
+uint8_t transportGetRouteCandidates(const uint8_t node, uint8_t *candidates, const uint8_t exclude)
+{
+	uint8_t count = 0;
+	const uint8_t route = transportGetRoute(node);
+	if (route != AUTO) {
+		candidates[count++] = route;
+	}
+#if defined(MY_TRANSPORT_ROUTE_FAILOVER_ENABLED)
+	// our distance to node: shortest known route
+	uint8_t distance = _transportRouteInfo[node].hops;
+	for (uint8_t i = 0; i < MY_TRANSPORT_ROUTE_CANDIDATES - 1; i++) {
+		if (_transportRouteAltHops[node][i] < distance) {
+			distance = _transportRouteAltHops[node][i];
+		}
+	}
+	for (uint8_t i = 0; i < MY_TRANSPORT_ROUTE_CANDIDATES - 1; i++) {
+		const uint8_t alternative = _transportRouteAlt[node][i];
+		if (alternative == AUTO) {
+			break;
+		}
+		// loop free only: never back to the previous hop, and the alternative itself must be
+		// closer to node than we are, i.e. hops via alternative - 1 < distance
+		const uint8_t hops = _transportRouteAltHops[node][i];
+		if (alternative == exclude || hops == INVALID_HOPS || hops > distance) {
+			continue;
+		}
+		// insertion sort by score, stable: the current route wins ties
+		const int16_t score = transportScoreLink(_transportRouteInfo[alternative].linkRSSI,
+		                      _transportRouteInfo[alternative].txFailures);
+		uint8_t pos = count;
+		while (pos > 0 && score > transportScoreLink(_transportRouteInfo[candidates[pos - 1]].linkRSSI,
+		        _transportRouteInfo[candidates[pos - 1]].txFailures)) {
+			candidates[pos] = candidates[pos - 1];
+			pos--;
+		}
+		candidates[pos] = alternative;
+		count++;
+	}
+#endif
+	return count;
+}
+
+void transportAddParentCandidate(const uint8_t nodeId, const uint8_t distance, const int16_t RSSI)
+{
+#if defined(MY_TRANSPORT_PARENT_FAILOVER_ENABLED)
+	uint8_t index = MY_TRANSPORT_ROUTE_CANDIDATES;
+	for (uint8_t i = 0; i < MY_TRANSPORT_ROUTE_CANDIDATES; i++) {
+		if (_transportParents[i].nodeId == nodeId) {
+			index = i;
+			break;
+		}
+		if (_transportParents[i].nodeId == AUTO) {
+			index = i;
+		}
+	}
+	if (index == MY_TRANSPORT_ROUTE_CANDIDATES) {
+		// list full, replace the worst candidate if the new one is closer or stronger
+		index = 0;
+		for (uint8_t i = 1; i < MY_TRANSPORT_ROUTE_CANDIDATES; i++) {
+			if (_transportParents[i].distance > _transportParents[index].distance ||
+			        (_transportParents[i].distance == _transportParents[index].distance &&
+			         _transportParents[i].RSSI < _transportParents[index].RSSI)) {
+				index = i;
+			}
+		}
+		if (distance > _transportParents[index].distance || (distance == _transportParents[index].distance &&
+		        RSSI <= _transportParents[index].RSSI)) {
+			return;
+		}
+	}
+	_transportParents[index].nodeId = nodeId;
+	_transportParents[index].distance = distance;
+	_transportParents[index].RSSI = RSSI;
+	_transportParents[index].failures = 0;
+#else
+	(void)nodeId;
+	(void)distance;
+	(void)RSSI;
+#endif
+}
+
+bool transportParentFailover(void)
+{
+#if defined(MY_TRANSPORT_PARENT_FAILOVER_ENABLED)
+	// the current parent, if not a candidate, is replaced by any candidate
+	int16_t parentScore = INT16_MIN;
+	uint8_t best = MY_TRANSPORT_ROUTE_CANDIDATES;
+	int16_t bestScore = INT16_MIN;
+	for (uint8_t i = 0; i < MY_TRANSPORT_ROUTE_CANDIDATES; i++) {
+		const parentCandidate_t *candidate = &_transportParents[i];
+		if (candidate->nodeId == AUTO) {
+			continue;
+		}
+		const int16_t score = transportScoreLink(candidate->RSSI, candidate->failures);
+		if (candidate->nodeId == _transportConfig.parentNodeId) {
+			parentScore = score;
+		} else if (candidate->distance < _transportConfig.distanceGW && score > bestScore) {
+			// only candidates not further from GW than the current parent, prevents loops
+			best = i;
+			bestScore = score;
+		}
+	}
+	if (best == MY_TRANSPORT_ROUTE_CANDIDATES || bestScore <= parentScore) {
+		return false;
+	}
+	_transportConfig.parentNodeId = _transportParents[best].nodeId;
+	_transportConfig.distanceGW = _transportParents[best].distance + 1;
+	// failedUplinkTransmissions is reset by the first successful transmission, a new parent
+	// search still starts after MY_TRANSPORT_MAX_TX_FAILURES if all candidates fail
+	TRANSPORT_DEBUG(PSTR("!TSF:RTE:FOVR,PAR=%" PRIu8 ",D=%" PRIu8 "\n"), _transportConfig.parentNodeId,
+	                _transportConfig.distanceGW);	// parent failover
+	return true;
+#else
+	return false;
+#endif
+}
+
 void transportReportRoutingTable(void)
 {
 #if defined(MY_REPEATER_FEATURE)
@@ -1071,6 +1472,13 @@ void transportReportRoutingTable(void)
 		const uint8_t route = transportGetRoute(cnt);
 		if (route != BROADCAST_ADDRESS) {
 			TRANSPORT_DEBUG(PSTR("TSF:RRT:ROUTE N=%" PRIu8 ",R=%" PRIu8 "\n"), cnt, route);
+#if defined(MY_ROUTING_TABLE_METADATA_ENABLED)
+			routeInfo_t info;
+			if (transportGetRouteInfo(cnt, &info)) {
+				TRANSPORT_DEBUG(PSTR("TSF:RRT:INFO N=%" PRIu8 ",A=%" PRIu32 ",H=%" PRIu8 ",RSSI=%" PRIi16 "\n"), cnt,
+				                (hwMillis() - info.lastSeen) / 1000, info.hops, info.RSSI);
+			}
+#endif
 			uint8_t outBuf[2] = { (uint8_t)cnt,route };
 			(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL, I_DEBUG).set(outBuf,
 			                 2));
@@ -1115,6 +1523,9 @@ int16_t transportGetSignalReport(const signalReport_t signalReport)
 	case SR_UPLINK_QUALITY:
 		result = transportInternalToRSSI(_transportSM.uplinkQualityRSSI);
 		break;
+	case SR_RX_LOST:
+		result = transportHALGetRxLost();
+		break;
 	default:
 		result = 0;
 		break;
@@ -1159,6 +1570,10 @@ int16_t transportSignalReport(const char command)
 		// Uplink quality
 		reportCommand = SR_UPLINK_QUALITY;
 		break;
+	case 'L':
+		// Frames lost, RX message buffer full
+		reportCommand = SR_RX_LOST;
+		break;
 	default:
 		reportCommand = SR_NOT_DEFINED;
 		break;
@@ -115,13 +115,17 @@
 * |!| TSF | SAN   | FAIL											| Sanity check failed, attempt to re-initialize radio
 * | | TSF | CRT   | OK												| Clearing routing table successful
 * | | TSF | LRT   | OK												| Loading routing table successful
-* | | TSF | SRT   | OK												| Saving routing table successful
+* | | TSF | SRT   | OK,N=%%d										| Saving routing table successful, changed routes written (N)
 * |!| TSF | RTE   | FPAR ACTIVE								| Finding parent active, message not sent
 * |!| TSF | RTE   | DST %%d UNKNOWN						| Routing for destination (DST) unknown, send message to parent
 * | | TSF | RTE   | N2N OK										| Node-to-node communication succeeded
 * |!| TSF | RTE   | N2N FAIL									| Node-to-node communication failed, handing over to parent for re-routing
+* |!| TSF | RTE   | FOVR,DST=%%d,R=%%d					| Transmission failed, retry to destination (DST) via next-best route (R)
+* |!| TSF | RTE   | FOVR,PAR=%%d,D=%%d					| Uplink transmission failed, switched to parent candidate (PAR) with distance to GW (D)
 * | | TSF | RRT   | ROUTE N=%%d,R=%%d					| Routing table, messages to node (N) are routed via node (R)
+* | | TSF | RRT   | INFO N=%%d,A=%%lu,H=%%d,RSSI=%%d	| Routing table metadata, node (N), seconds since last message (A), hops (H), RSSI of last hop
 * |!| TSF | SND   | TNR												| Transport not ready, message cannot be sent
+* | | TSF | SND   | DONE,TO=%%d,ST=%%s					| Queued frame to (TO) completed, status OK or NACK (ST)
 * | | TSF | TDI   | TSL												| Set transport to sleep
 * | | TSF | TDI   | TPD												| Power down transport
 * | | TSF | TRI   | TRI												| Reinitialise transport
@@ -312,11 +316,33 @@ typedef struct {
 #endif
 } transportSM_t;
 
+/**
+* @brief Routing table metadata of a node
+*/
+typedef struct {
+	uint32_t lastSeen;			//!< hwMillis() of last message received from node
+	int16_t RSSI;				//!< RSSI of last hop, INVALID_RSSI if not available
+	int16_t linkRSSI;			//!< RSSI of the link to node as neighbor (received frames, ACKs), INVALID_RSSI if unknown
+	uint8_t hops;				//!< Hops to node, INVALID_HOPS if unknown
+	uint8_t txFailures;			//!< Consecutive failed transmissions to node as next hop
+} routeInfo_t;
+
+/**
+* @brief Parent candidate, see @ref MY_TRANSPORT_MULTIPATH_FEATURE
+*/
+typedef struct {
+	uint8_t nodeId;				//!< Node ID of candidate, AUTO if unused
+	uint8_t distance;			//!< Distance of candidate to GW
+	int16_t RSSI;				//!< RSSI of the link to candidate
+	uint8_t failures;			//!< Consecutive failed transmissions to candidate
+} parentCandidate_t;
+
 /**
 * @brief RAM routing table
 */
 typedef struct {
 	uint8_t route[SIZE_ROUTES];	//!< route for node
+	uint8_t dirty[SIZE_ROUTES / 8];	//!< Bitmap of routes changed since last save
 } routingTable_t;
 
 // PRIVATE functions
@@ -388,7 +414,17 @@ uint32_t transportTimeInState(void);
 */
 void transportInvokeSanityCheck(void);
 /**
-* @brief Process all pending messages in RX FIFO
+* @brief Run the periodic transport tasks (sanity check, OTA firmware request)
+* @return true if transport is active and messages can be processed
+*/
+bool transportProcessHousekeeping(void);
+/**
+* @brief Process the next pending message in RX FIFO
+* @return true if a message was processed
+*/
+bool transportProcessNextMessage(void);
+/**
+* @brief Process pending messages in RX FIFO (max. @ref MAX_SUBSEQ_MSGS)
 */
 void transportProcessFIFO(void);
 /**
@@ -438,6 +474,28 @@ bool transportSendRoute(MyMessage &message);
 */
 bool transportSendWrite(const uint8_t to, MyMessage &message);
 /**
+* @brief Send message to recipient without signing it
+* @param to Recipient of message
+* @param message Message, signed if required
+* @return true if message sent successfully
+*/
+bool transportSendFrame(const uint8_t to, MyMessage &message);
+#if !defined(MY_GATEWAY_FEATURE)
+/**
+* @brief Update failed uplink transmission counter and uplink quality after sending to the parent
+* @param success true if the transmission succeeded
+*/
+void transportUpdateUplink(const bool success);
+#endif
+#if defined(MY_TRANSPORT_ASYNC_SEND)
+/**
+* @brief Result of a frame queued by transportHALSend(), reported by the radio driver
+* @param to Recipient of the frame
+* @param success true if the frame was acknowledged (or sent, if no ACK was requested)
+*/
+void transportSendComplete(const uint8_t to, const bool success);
+#endif
+/**
 * @brief Check uplink to GW, includes flooding control
 * @param force to override flood control timer
 * @return true if uplink ok
@@ -516,6 +574,57 @@ void transportSetRoute(const uint8_t node, const uint8_t route);
 */
 uint8_t transportGetRoute(const uint8_t node);
 /**
+* @brief Update routing table metadata of node, see @ref MY_ROUTING_TABLE_METADATA_ENABLED
+* @param node
+* @param hops hops to node, INVALID_HOPS to keep known hops
+* @param RSSI RSSI of last hop
+*/
+void transportSetRouteInfo(const uint8_t node, const uint8_t hops, const int16_t RSSI);
+/**
+* @brief Update link statistics of a next hop, see @ref MY_TRANSPORT_MULTIPATH_FEATURE
+* @param node next hop
+* @param success true if transmission was acknowledged
+*/
+void transportUpdateLink(const uint8_t node, const bool success);
+/**
+* @brief Score of a next hop: link RSSI minus @ref MY_TRANSPORT_ROUTE_FAILURE_PENALTY per failure
+* @param RSSI link RSSI, INVALID_RSSI if unknown
+* @param failures consecutive failed transmissions
+* @return score, higher is better
+*/
+int16_t transportScoreLink(const int16_t RSSI, const uint8_t failures);
+/**
+* @brief Remember a node that answered a find parent request, see @ref MY_TRANSPORT_MULTIPATH_FEATURE
+* @param nodeId candidate
+* @param distance distance of candidate to GW
+* @param RSSI RSSI of the response
+*/
+void transportAddParentCandidate(const uint8_t nodeId, const uint8_t distance, const int16_t RSSI);
+/**
+* @brief Switch to the best scoring parent candidate, if better than the current parent
+* @return true if parent changed
+*/
+bool transportParentFailover(void);
+/**
+* @brief Next hops to node, best scoring first, see @ref MY_TRANSPORT_MULTIPATH_FEATURE
+*
+* Besides the current route, only alternatives with known hops that are closer to node than
+* this node are returned.
+* @param node destination
+* @param candidates buffer for at least @ref MY_TRANSPORT_ROUTE_CANDIDATES next hops
+* @param exclude alternative not to return, i.e. the node the message was received from
+* @return number of next hops
+*/
+uint8_t transportGetRouteCandidates(const uint8_t node, uint8_t *candidates,
+                                    const uint8_t exclude);
+/**
+* @brief Load routing table metadata of node
+* @param node
+* @param info metadata of node
+* @return true if metadata available, i.e. node seen since start and metadata enabled
+*/
+bool transportGetRouteInfo(const uint8_t node, routeInfo_t *info);
+/**
 * @brief Reports content of routing table
 */
 void transportReportRoutingTable(void);
@@ -558,7 +667,8 @@ void transportReInitialise(void);
 * P = TX powerlevel in %
 * T = TX powerlevel in dBm
 * U = Uplink quality (via ACK from parent node), avg. RSSI
-* @return Signal report (if report is not available, INVALID_RSSI, INVALID_SNR, INVALID_PERCENT, or INVALID_LEVEL is sent instead)
+* L = Frames lost due to a full RX message buffer, see @ref MY_RX_MESSAGE_BUFFER_FEATURE
+* @return Signal report (if report is not available, INVALID_RSSI, INVALID_SNR, INVALID_PERCENT, INVALID_LEVEL, or INVALID_COUNT is sent instead)
 */
 int16_t transportSignalReport(const char command) __attribute__((unused));
 
@@ -27,6 +27,150 @@
 #ifndef CircularBuffer_h
 #define CircularBuffer_h
 
+#if defined(__linux__)
+/**
+ * The circular buffer class, lock-free variant for Linux.
+ * Pass the datatype to be stored in the buffer as template parameter.
+ *
+ * Same interface as the generic implementation, but restricted to one producer
+ * (getFront/pushFront) and one consumer (getBack/popBack/clear), e.g. an interrupt
+ * thread and the main loop. Front and back indices are owned by one side each and
+ * published with release/acquire atomics, so no critical section is needed.
+ * Indices run over twice the size to tell a full buffer from an empty one.
+ */
+template <class T> class CircularBuffer
+{
+public:
+	/**
+	 * Constructor
+	 * @param buffer   Preallocated buffer of at least size records.
+	 * @param size     Number of records available in the buffer.
+	 */
+	CircularBuffer(T* buffer, const uint8_t size )
+		: m_size(size), m_buff(buffer), m_front(0), m_back(0)
+	{
+	}
+
+	/**
+	  * Clear all entries in the circular buffer (consumer side).
+	  */
+	void clear(void)
+	{
+		__atomic_store_n(&m_back, __atomic_load_n(&m_front, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+	}
+
+	/**
+	 * Test if the circular buffer is empty.
+	 * @return True, when empty.
+	 */
+	inline bool empty(void) const
+	{
+		return !available();
+	}
+
+	/**
+	 * Test if the circular buffer is full.
+	 * @return True, when full.
+	 */
+	inline bool full(void) const
+	{
+		return available() == m_size;
+	}
+
+	/**
+	 * Return the number of records stored in the buffer.
+	 * @return number of records.
+	 */
+	inline uint8_t available(void) const
+	{
+		const uint16_t front = __atomic_load_n(&m_front, __ATOMIC_ACQUIRE);
+		const uint16_t back = __atomic_load_n(&m_back, __ATOMIC_ACQUIRE);
+		return static_cast<uint8_t>((front + 2 * m_size - back) % (2 * m_size));
+	}
+
+	/**
+	 * Aquire unused record on front of the buffer, for writing.
+	 * After filling the record, it has to be pushed to actually
+	 * add it to the buffer.
+	 * @return Pointer to record, or NULL when buffer is full.
+	 */
+	T* getFront(void) const
+	{
+		if (!full()) {
+			return get(__atomic_load_n(&m_front, __ATOMIC_RELAXED) % m_size);
+		}
+		return static_cast<T*>(NULL);
+	}
+
+	/**
+	 * Push record to front of the buffer.
+	 * @param record   Record to push. If record was aquired previously (using getFront) its
+	 *                 data will not be copied as it is already present in the buffer.
+	 * @return True, when record was pushed successfully.
+	 */
+	bool pushFront(T* record)
+	{
+		if (full()) {
+			return false;
+		}
+		const uint16_t front = __atomic_load_n(&m_front, __ATOMIC_RELAXED);
+		T* f = get(front % m_size);
+		if (f != record) {
+			*f = *record;
+		}
+		// publish the record to the consumer
+		__atomic_store_n(&m_front, (uint16_t)((front + 1) % (2 * m_size)), __ATOMIC_RELEASE);
+		return true;
+	}
+
+	/**
+	 * Aquire record on back of the buffer, for reading.
+	 * After reading the record, it has to be pop'ed to actually
+	 * remove it from the buffer.
+	 * @return Pointer to record, or NULL when buffer is empty.
+	 */
+	T* getBack(void) const
+	{
+		if (!empty()) {
+			return get(__atomic_load_n(&m_back, __ATOMIC_RELAXED) % m_size);
+		}
+		return static_cast<T*>(NULL);
+	}
+
+	/**
+	 * Remove record from back of the buffer.
+	 * @return True, when record was pop'ed successfully.
+	 */
+	bool popBack(void)
+	{
+		if (empty()) {
+			return false;
+		}
+		const uint16_t back = __atomic_load_n(&m_back, __ATOMIC_RELAXED);
+		// hand the record back to the producer
+		__atomic_store_n(&m_back, (uint16_t)((back + 1) % (2 * m_size)), __ATOMIC_RELEASE);
+		return true;
+	}
+
+protected:
+	/**
+	 * Internal getter for records.
+	 * @param idx   Record index in buffer.
+	 * @return Ptr to record.
+	 */
+	inline T * get(const uint8_t idx) const
+	{
+		return &(m_buff[idx]);
+	}
+
+	const uint8_t      m_size;     //!< Total number of records that can be stored in the buffer.
+	T* const           m_buff;     //!< Ptr to buffer holding all records.
+	uint16_t           m_front;    //!< Producer index (0..2*size-1) of front element (not pushed yet).
+	uint16_t           m_back;     //!< Consumer index (0..2*size-1) of last used record.
+};
+
+#else /* Else part of __linux__ */
+
 /**
  * The circular buffer class.
  * Pass the datatype to be stored in the buffer as template parameter.
@@ -194,4 +338,6 @@ protected:
 	volatile uint8_t   m_fill;     //!< Amount of records currently pushed.
 };
 
+#endif /* End of __linux__ */
+
 #endif // CircularBuffer_h
@@ -102,6 +102,21 @@ public:
 		(void)address;
 	};
 	/// dummy function for SPI flash compatibility
+	void writeBufferBegin(uint32_t addr, uint32_t len)
+	{
+		(void)addr;
+		(void)len;
+	};
+	/// SPI flash compatibility, EEPROM writes are not buffered
+	void writeBuffered(uint32_t addr, const void* buf, uint16_t len)
+	{
+		writeBytes(addr, buf, len);
+	};
+	/// dummy function for SPI flash compatibility
+	void writeBufferProcess() {};
+	/// dummy function for SPI flash compatibility
+	void writeBufferFlush() {};
+	/// dummy function for SPI flash compatibility
 	void sleep() {};
 	/// dummy function for SPI flash compatibility
 	void wakeup() {};
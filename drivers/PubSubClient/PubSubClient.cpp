@@ -16,6 +16,9 @@ PubSubClient::PubSubClient()
 	setCallback(NULL);
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -27,6 +30,9 @@ PubSubClient::PubSubClient(Client& client)
 	this->stream = NULL;
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -39,6 +45,9 @@ PubSubClient::PubSubClient(IPAddress addr, uint16_t port, Client& client)
 	this->stream = NULL;
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -50,6 +59,9 @@ PubSubClient::PubSubClient(IPAddress addr, uint16_t port, Client& client, Stream
 	setStream(stream);
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -62,6 +74,9 @@ PubSubClient::PubSubClient(IPAddress addr, uint16_t port, MQTT_CALLBACK_SIGNATUR
 	this->stream = NULL;
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -75,6 +90,9 @@ PubSubClient::PubSubClient(IPAddress addr, uint16_t port, MQTT_CALLBACK_SIGNATUR
 	setStream(stream);
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -87,6 +105,9 @@ PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, Client& client)
 	this->stream = NULL;
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -98,6 +119,9 @@ PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, Client& client, Stream& s
 	setStream(stream);
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -110,6 +134,9 @@ PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, MQTT_CALLBACK_SIGNATURE,
 	this->stream = NULL;
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -123,6 +150,9 @@ PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, MQTT_CALLBACK_SIGNATURE,
 	setStream(stream);
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -135,6 +165,9 @@ PubSubClient::PubSubClient(const char* domain, uint16_t port, Client& client)
 	this->stream = NULL;
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -146,6 +179,9 @@ PubSubClient::PubSubClient(const char* domain, uint16_t port, Client& client, St
 	setStream(stream);
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -159,6 +195,9 @@ PubSubClient::PubSubClient(const char* domain, uint16_t port, MQTT_CALLBACK_SIGN
 	this->stream = NULL;
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -172,6 +211,9 @@ PubSubClient::PubSubClient(const char* domain, uint16_t port, MQTT_CALLBACK_SIGN
 	setStream(stream);
 	this->bufferSize = 0;
 	setBufferSize(MQTT_MAX_PACKET_SIZE);
+	this->batchBuffer = NULL;
+	this->batchBufferSize = 0;
+	this->batchLength = 0;
 	setKeepAlive(MQTT_KEEPALIVE);
 	setSocketTimeout(MQTT_SOCKET_TIMEOUT);
 }
@@ -179,6 +221,7 @@ PubSubClient::PubSubClient(const char* domain, uint16_t port, MQTT_CALLBACK_SIGN
 PubSubClient::~PubSubClient()
 {
 	free(this->buffer);
+	free(this->batchBuffer);
 }
 
 bool PubSubClient::connect(const char *id)
@@ -209,6 +252,8 @@ bool PubSubClient::connect(const char *id, const char *user, const char *pass,
 {
 	if (!connected()) {
 		int result = 0;
+		// Drop packets batched for a previous connection
+		this->batchLength = 0;
 
 
 		if(_client->connected()) {
@@ -516,6 +561,9 @@ bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned i
 		if (retained) {
 			header |= 1;
 		}
+		if (this->batchBufferSize) {
+			return writeBatch(header,this->buffer,length-MQTT_MAX_HEADER_SIZE);
+		}
 		return write(header,this->buffer,length-MQTT_MAX_HEADER_SIZE);
 	}
 	return false;
@@ -540,7 +588,7 @@ bool PubSubClient::publish_P(const char* topic, const uint8_t* payload, unsigned
 	unsigned int len;
 	unsigned int expectedLength;
 
-	if (!connected()) {
+	if (!connected() || !flushBatch()) {
 		return false;
 	}
 
@@ -579,7 +627,7 @@ bool PubSubClient::publish_P(const char* topic, const uint8_t* payload, unsigned
 
 bool PubSubClient::beginPublish(const char* topic, unsigned int plength, bool retained)
 {
-	if (connected()) {
+	if (connected() && flushBatch()) {
 		// Send the header and variable length field
 		uint16_t length = MQTT_MAX_HEADER_SIZE;
 		length = writeString(topic,this->buffer,length);
@@ -638,9 +686,63 @@ size_t PubSubClient::buildHeader(uint8_t header, uint8_t* buf, uint16_t length)
 	return llen+1; // Full header size is variable length bit plus the 1-byte fixed header
 }
 
+bool PubSubClient::writeBatch(uint8_t header, uint8_t* buf, uint16_t length)
+{
+	uint8_t hlen = buildHeader(header, buf, length);
+	uint16_t packetLength = hlen+length;
+	if (this->batchLength+packetLength > this->batchBufferSize) {
+		// No room left, send what is collected so far
+		if (!flushBatch()) {
+			return false;
+		}
+		if (packetLength > this->batchBufferSize) {
+			// Larger than the batch buffer, send it on its own
+			return write(header, buf, length);
+		}
+	}
+	memcpy(this->batchBuffer+this->batchLength, buf+(MQTT_MAX_HEADER_SIZE-hlen), packetLength);
+	this->batchLength += packetLength;
+	return true;
+}
+
+bool PubSubClient::flushBatch()
+{
+	if (this->batchLength == 0) {
+		return true;
+	}
+	uint16_t length = this->batchLength;
+	this->batchLength = 0;
+	if (!connected()) {
+		return false;
+	}
+	uint16_t rc;
+#ifdef MQTT_MAX_TRANSFER_SIZE
+	uint8_t* writeBuf = this->batchBuffer;
+	uint16_t bytesRemaining = length;
+	uint8_t bytesToWrite;
+	bool result = true;
+	while((bytesRemaining > 0) && result) {
+		bytesToWrite = (bytesRemaining > MQTT_MAX_TRANSFER_SIZE)?MQTT_MAX_TRANSFER_SIZE:bytesRemaining;
+		rc = _client->write(writeBuf,bytesToWrite);
+		result = (rc == bytesToWrite);
+		bytesRemaining -= rc;
+		writeBuf += rc;
+	}
+	lastOutActivity = millis();
+	return result;
+#else
+	rc = _client->write(this->batchBuffer,length);
+	lastOutActivity = millis();
+	return (rc == length);
+#endif
+}
+
 bool PubSubClient::write(uint8_t header, uint8_t* buf, uint16_t length)
 {
 	uint16_t rc;
+	if (!flushBatch()) {
+		return false;
+	}
 	uint8_t hlen = buildHeader(header, buf, length);
 
 #ifdef MQTT_MAX_TRANSFER_SIZE
@@ -723,6 +825,7 @@ bool PubSubClient::unsubscribe(const char* topic)
 
 void PubSubClient::disconnect()
 {
+	(void)flushBatch();
 	this->buffer[0] = MQTTDISCONNECT;
 	this->buffer[1] = 0;
 	_client->write(this->buffer,2);
@@ -835,6 +938,26 @@ uint16_t PubSubClient::getBufferSize()
 {
 	return this->bufferSize;
 }
+
+bool PubSubClient::setBatchBufferSize(uint16_t size)
+{
+	if (!flushBatch()) {
+		return false;
+	}
+	if (size == 0) {
+		free(this->batchBuffer);
+		this->batchBuffer = NULL;
+		this->batchBufferSize = 0;
+		return true;
+	}
+	uint8_t* newBuffer = (uint8_t*)realloc(this->batchBuffer, size);
+	if (newBuffer == NULL) {
+		return false;
+	}
+	this->batchBuffer = newBuffer;
+	this->batchBufferSize = size;
+	return true;
+}
 PubSubClient& PubSubClient::setKeepAlive(uint16_t keepAlive)
 {
 	this->keepAlive = keepAlive;
@@ -103,6 +103,8 @@ private:
 	bool readByte(uint8_t * result);
 	bool readByte(uint8_t * result, uint16_t * index);
 	bool write(uint8_t header, uint8_t* buf, uint16_t length);
+	// Append a packet built in buf to the batch buffer, flushing it first if full
+	bool writeBatch(uint8_t header, uint8_t* buf, uint16_t length);
 	uint16_t writeString(const char* string, uint8_t* buf, uint16_t pos);
 	// Build up the header ready to send
 	// Returns the size of the header
@@ -114,6 +116,9 @@ private:
 	uint16_t port;
 	Stream* stream;
 	int _state;
+	uint8_t* batchBuffer;
+	uint16_t batchBufferSize;
+	uint16_t batchLength;
 public:
 	PubSubClient(); //!< PubSubClient
 	PubSubClient(Client& client); //!< PubSubClient
@@ -146,6 +151,14 @@ public:
 
 	bool setBufferSize(uint16_t size); //!< setBufferSize
 	uint16_t getBufferSize(); //!< getBufferSize
+	// Enable batched publishing with a batch buffer of size bytes, 0 disables batching.
+	// While enabled, publish() collects the packets in the batch buffer and they are sent
+	// with a single client write by flushBatch(), or when the batch buffer is full.
+	// Any other packet sent to the broker flushes the batch first to keep the order.
+	bool setBatchBufferSize(uint16_t size); //!< setBatchBufferSize
+	// Send all packets collected in the batch buffer
+	// Returns true if the batch was empty or sent successfully, false if there was an error
+	bool flushBatch(); //!< flushBatch
 
 	bool connect(const char* id); //!< connect
 	bool connect(const char* id, const char* user, const char* pass); //!< connect
@@ -55,6 +55,13 @@ SPIFlash::SPIFlash(uint8_t slaveSelectPin, uint16_t jedecID)
 {
 	_slaveSelectPin = slaveSelectPin;
 	_jedecID = jedecID;
+	// no buffered write region, read functions check the write buffer
+	_eraseStart = 0;
+	_eraseEnd = 0;
+#ifndef MY_SPIFLASH_DISABLE_WRITE_BUFFER
+	_writeStart = 0;
+	_writeEnd = 0;
+#endif
 }
 
 /// Select the flash chip
@@ -166,6 +173,7 @@ uint8_t SPIFlash::readByte(uint32_t addr)
 	SPI.transfer(addr);
 	uint8_t result = SPI.transfer(0);
 	unselect();
+	mergeWriteBuffer(addr, &result, 1);
 	return result;
 }
 
@@ -181,6 +189,7 @@ void SPIFlash::readBytes(uint32_t addr, void* buf, uint16_t len)
 		((uint8_t*) buf)[i] = SPI.transfer(0);
 	}
 	unselect();
+	mergeWriteBuffer(addr, (uint8_t*) buf, len);
 }
 
 /// Send a command to the flash chip, pass TRUE for isWrite when its a write command
@@ -356,6 +365,151 @@ void SPIFlash::blockErase64K(uint32_t addr)
 	unselect();
 }
 
+/// start buffered writes to [addr, addr + len), previously buffered data is discarded
+/// The sectors of the region (max 32) are erased on demand before the first page is programmed,
+/// data outside the region but within its first or last sector is lost.
+void SPIFlash::writeBufferBegin(uint32_t addr, uint32_t len)
+{
+	_eraseStart = addr & ~(SPIFLASH_SECTORSIZE - 1);
+	_eraseEnd = addr + len;
+	if (_eraseEnd - _eraseStart > 32 * SPIFLASH_SECTORSIZE) {
+		_eraseEnd = _eraseStart + 32 * SPIFLASH_SECTORSIZE;
+	}
+	_erasedSectors = 0;
+	_writePage = 0xFFFFFFFFul;
+	_writeDescending = true;
+#ifndef MY_SPIFLASH_DISABLE_WRITE_BUFFER
+	_writeStart = 0;
+	_writeEnd = 0;
+#endif
+}
+
+/// write multiple bytes to the region set by writeBufferBegin()
+/// Bytes are collected per page, a page is programmed once complete or when data for another page
+/// arrives. Programming is not waited for, the next command waits if the chip is still busy.
+/// Data not yet programmed is returned by readByte() and readBytes(), call writeBufferFlush() when done.
+void SPIFlash::writeBuffered(uint32_t addr, const void* buf, uint16_t len)
+{
+	const uint8_t* data = (const uint8_t*) buf;
+	while (len > 0) {
+		uint32_t start = addr;
+		if (_writeDescending) {
+			// upper page first, a write spanning two pages then completes the current page
+			const uint32_t last = (addr + len - 1) & ~(uint32_t)(SPIFLASH_PAGESIZE - 1);
+			if (last > addr) {
+				start = last;
+			}
+		}
+		const uint32_t page = start & ~(uint32_t)(SPIFLASH_PAGESIZE - 1);
+		const uint16_t offset = start - page;
+		const uint16_t remaining = addr + len - start;
+		const uint16_t n = (remaining <= SPIFLASH_PAGESIZE - offset) ? remaining : SPIFLASH_PAGESIZE -
+		                   offset;
+		if (page != _writePage) {
+			writeBufferFlush();
+			if (_writePage != 0xFFFFFFFFul) {
+				_writeDescending = page < _writePage;
+			}
+			_writePage = page;
+			// erase before buffering, reads merging the buffer then see erased flash
+			(void)eraseSector(page);
+#ifndef MY_SPIFLASH_DISABLE_WRITE_BUFFER
+			memset(_writeBuffer, 0xFF, SPIFLASH_PAGESIZE);
+			_writeStart = offset;
+			_writeEnd = offset;
+#endif
+		}
+#ifdef MY_SPIFLASH_DISABLE_WRITE_BUFFER
+		writeBytes(start, &data[start - addr], n);
+#else
+		memcpy(&_writeBuffer[offset], &data[start - addr], n);
+		if (_writeStart >= _writeEnd || offset < _writeStart) {
+			_writeStart = offset;
+		}
+		if (offset + n > _writeEnd) {
+			_writeEnd = offset + n;
+		}
+		if (_writeStart == 0 && _writeEnd == SPIFLASH_PAGESIZE) {
+			// page complete
+			writeBufferFlush();
+		}
+#endif
+		if (start == addr) {
+			addr += n;
+			data += n;
+		}
+		len -= n;
+	}
+}
+
+/// erase the next sector ahead of the write cursor while the chip is idle
+/// Non-blocking, call regularly during buffered writes so erasing overlaps with receiving data.
+void SPIFlash::writeBufferProcess()
+{
+	if (_writePage == 0xFFFFFFFFul) {
+		return;
+	}
+	const uint32_t next = _writeDescending ? _writePage - SPIFLASH_SECTORSIZE : _writePage +
+	                      SPIFLASH_SECTORSIZE;
+	if (next < _eraseStart || next >= _eraseEnd ||
+	        (_erasedSectors & (1ul << ((next - _eraseStart) / SPIFLASH_SECTORSIZE)))) {
+		return;
+	}
+	if (!busy()) {
+		(void)eraseSector(next);
+	}
+}
+
+/// program bytes still held in the page buffer
+/// Programming is not waited for, use busy() to wait for completion.
+void SPIFlash::writeBufferFlush()
+{
+#ifndef MY_SPIFLASH_DISABLE_WRITE_BUFFER
+	if (_writeStart < _writeEnd) {
+		writeBytes(_writePage + _writeStart, &_writeBuffer[_writeStart], _writeEnd - _writeStart);
+		_writeStart = 0;
+		_writeEnd = 0;
+	}
+#endif
+}
+
+/// erase the sector containing addr, if it belongs to the buffered write region and was not erased yet
+bool SPIFlash::eraseSector(uint32_t addr)
+{
+	if (addr < _eraseStart || addr >= _eraseEnd) {
+		return false;
+	}
+	const uint8_t sector = (addr - _eraseStart) / SPIFLASH_SECTORSIZE;
+	if (_erasedSectors & (1ul << sector)) {
+		return false;
+	}
+	_erasedSectors |= (1ul << sector);
+	blockErase4K(_eraseStart + sector * SPIFLASH_SECTORSIZE);
+	return true;
+}
+
+/// merge bytes not yet programmed into data read from flash
+/// Unwritten buffer bytes are 0xFF, AND-ing gives the content the flash will have once programmed.
+void SPIFlash::mergeWriteBuffer(uint32_t addr, uint8_t* buf, uint16_t len)
+{
+#ifdef MY_SPIFLASH_DISABLE_WRITE_BUFFER
+	(void)addr;
+	(void)buf;
+	(void)len;
+#else
+	if (_writeStart >= _writeEnd || addr >= _writePage + _writeEnd ||
+	        addr + len <= _writePage + _writeStart) {
+		return;
+	}
+	for (uint16_t i = 0; i < len; ++i) {
+		const uint32_t offset = addr + i - _writePage;
+		if (offset >= _writeStart && offset < _writeEnd) {
+			buf[i] &= _writeBuffer[offset];
+		}
+	}
+#endif
+}
+
 void SPIFlash::sleep()
 {
 	command(SPIFLASH_SLEEP);
@@ -145,6 +145,14 @@
 #define SPIFLASH_MACREAD          0x4B        //!< read unique ID number (MAC)
 #endif
 
+#ifndef SPIFLASH_PAGESIZE
+#define SPIFLASH_PAGESIZE         256         //!< page size, max bytes per page program
+#endif
+
+#ifndef SPIFLASH_SECTORSIZE
+#define SPIFLASH_SECTORSIZE       4096ul      //!< sector size, see #SPIFLASH_BLOCKERASE_4K
+#endif
+
 ///
 /// @def MY_SPIFLASH_SST25TYPE
 /// @brief If set AAI Word Programming is used to support SST25 Family SPI Flash.
@@ -157,6 +165,33 @@
 #define MY_SPIFLASH_SST25TYPE
 #endif
 
+///
+/// @def MY_SPIFLASH_DISABLE_WRITE_BUFFER
+/// @brief If set, writeBuffered() programs the data directly instead of collecting it in a page buffer.
+///
+/// By default writeBuffered() collects data in a #SPIFLASH_PAGESIZE bytes RAM buffer and programs
+/// complete pages. Set this define to save the RAM, sectors are still erased on demand.<BR>
+/// Set by default on AVR, where the buffer would take an eighth of the RAM of an ATmega328P.
+/// Define #MY_SPIFLASH_ENABLE_WRITE_BUFFER to use the buffer there.
+///
+#ifdef DOXYGEN
+#define MY_SPIFLASH_DISABLE_WRITE_BUFFER
+#endif
+
+///
+/// @def MY_SPIFLASH_ENABLE_WRITE_BUFFER
+/// @brief If set, the page buffer of writeBuffered() is also used on AVR.
+///
+/// @see MY_SPIFLASH_DISABLE_WRITE_BUFFER
+///
+#ifdef DOXYGEN
+#define MY_SPIFLASH_ENABLE_WRITE_BUFFER
+#endif
+
+#if defined(ARDUINO_ARCH_AVR) && !defined(MY_SPIFLASH_ENABLE_WRITE_BUFFER) && !defined(MY_SPIFLASH_DISABLE_WRITE_BUFFER)
+#define MY_SPIFLASH_DISABLE_WRITE_BUFFER
+#endif
+
 /** SPIFlash class */
 class SPIFlash
 {
@@ -177,6 +212,12 @@ public:
 	void blockErase4K(uint32_t address); //!< erase a 4Kbyte block
 	void blockErase32K(uint32_t address); //!< erase a 32Kbyte block
 	void blockErase64K(uint32_t addr); //!< erase a 64Kbyte block
+	void writeBufferBegin(uint32_t addr,
+	                      uint32_t len); //!< start buffered writes to a region (max 32 sectors), its sectors are erased on demand
+	void writeBuffered(uint32_t addr, const void* buf,
+	                   uint16_t len); //!< buffer bytes, complete pages are programmed without waiting for completion
+	void writeBufferProcess(); //!< non-blocking, erases the next sector ahead of the write cursor while the chip is idle
+	void writeBufferFlush(); //!< program remaining buffered bytes, use busy() to wait for completion
 	uint16_t readDeviceId(); //!< Get the manufacturer and device ID bytes (as a short word)
 	uint8_t* readUniqueId(); //!< Get the 64 bit unique identifier, stores it in @ref UNIQUEID[8]
 
@@ -186,12 +227,25 @@ public:
 protected:
 	void select(); //!< select
 	void unselect(); //!< unselect
+	bool eraseSector(uint32_t addr); //!< erase sector of the buffered write region containing addr, if not yet erased
+	void mergeWriteBuffer(uint32_t addr, uint8_t* buf,
+	                      uint16_t len); //!< merge bytes not yet programmed into data read from flash
 	uint8_t _slaveSelectPin; //!< Slave select pin
 	uint16_t _jedecID; //!< JEDEC ID
 	uint8_t _SPCR; //!< SPCR
 	uint8_t _SPSR; //!< SPSR
 #ifdef SPI_HAS_TRANSACTION
 	SPISettings _settings;
+#endif
+	uint32_t _eraseStart; //!< first sector of the buffered write region
+	uint32_t _eraseEnd; //!< end of the buffered write region
+	uint32_t _erasedSectors; //!< erased sectors of the buffered write region, bit n = sector n
+	uint32_t _writePage; //!< address of the page currently buffered
+	bool _writeDescending; //!< buffered writes move to lower addresses
+#ifndef MY_SPIFLASH_DISABLE_WRITE_BUFFER
+	uint16_t _writeStart; //!< first buffered byte within page
+	uint16_t _writeEnd; //!< end of buffered bytes within page, buffer empty if <= _writeStart
+	uint8_t _writeBuffer[SPIFLASH_PAGESIZE]; //!< page buffer, bytes not written are 0xFF
 #endif
 };
 
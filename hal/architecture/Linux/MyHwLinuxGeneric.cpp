@@ -24,6 +24,11 @@ static FILE *randomFp = NULL;
 
 bool hwInit(void)
 {
+	if (!EventLoop.begin()) {
+		logError("Failed to create the event loop.\n");
+		exit(1);
+	}
+
 	MY_SERIALDEVICE.begin(MY_BAUD_RATE);
 #ifdef MY_GATEWAY_SERIAL
 #ifdef MY_LINUX_SERIAL_GROUPNAME
@@ -34,7 +39,7 @@ bool hwInit(void)
 #endif
 #endif
 
-	if (eeprom.init(conf.eeprom_file, conf.eeprom_size) != 0) {
+	if (eeprom.init(conf.eeprom_file, conf.eeprom_size, conf.eeprom_sync_interval) != 0) {
 		exit(1);
 	}
 
@@ -61,6 +66,11 @@ void hwWriteConfig(const int addr, uint8_t value)
 	eeprom.writeByte(addr, value);
 }
 
+void hwFlushConfig(void)
+{
+	(void)eeprom.flush();
+}
+
 void hwRandomNumberInit(void)
 {
 	uint32_t seed=0;
@@ -32,6 +32,7 @@
 #include <syscall.h>
 #include <unistd.h>
 #include "SoftEeprom.h"
+#include "EventLoop.h"
 #include "log.h"
 #include "config.h"
 
@@ -65,6 +66,7 @@ inline void hwReadConfigBlock(void *buf, void *addr, size_t length);
 inline void hwWriteConfigBlock(void *buf, void *addr, size_t length);
 inline uint8_t hwReadConfig(const int addr);
 inline void hwWriteConfig(const int addr, uint8_t value);
+void hwFlushConfig(void);
 inline void hwRandomNumberInit(void);
 ssize_t hwGetentropy(void *__buffer, size_t __length);
 #define MY_HW_HAS_GETENTROPY
@@ -85,9 +87,10 @@ static __inline__ void __hwUnlock(const  uint8_t *__s)
 	(void)__s;
 }
 
-static __inline__ void __hwLock()
+static __inline__ uint8_t __hwLock()
 {
 	pthread_mutex_lock(&hw_mutex);
+	return 1;
 }
 #endif
 
@@ -95,7 +98,7 @@ static __inline__ void __hwLock()
 #define ATOMIC_BLOCK_CLEANUP
 #elif defined(MY_RF24_IRQ_PIN)
 #define ATOMIC_BLOCK_CLEANUP uint8_t __atomic_loop \
-	__attribute__((__cleanup__( __hwUnlock ))) = 1
+	__attribute__((__cleanup__( __hwUnlock ))) = __hwLock()
 #else
 #define ATOMIC_BLOCK_CLEANUP
 #endif	/* DOXYGEN */
@@ -103,7 +106,7 @@ static __inline__ void __hwLock()
 #if defined(DOXYGEN)
 #define ATOMIC_BLOCK
 #elif defined(MY_RF24_IRQ_PIN)
-#define ATOMIC_BLOCK for ( ATOMIC_BLOCK_CLEANUP, __hwLock(); \
+#define ATOMIC_BLOCK for ( ATOMIC_BLOCK_CLEANUP; \
                            __atomic_loop ; __atomic_loop = 0 )
 #else
 #define ATOMIC_BLOCK
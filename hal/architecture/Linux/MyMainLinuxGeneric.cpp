@@ -31,14 +31,32 @@
 #include "config.h"
 #include "MySensorsCore.h"
 
+// SIGINT or SIGTERM received, the gateway shuts down from the main loop
+static volatile sig_atomic_t exitSignal = 0;
+
 void handle_sigint(int sig)
 {
-	if (sig == SIGINT) {
+	if (sig != SIGINT && sig != SIGTERM) {
+		return;
+	}
+	if (exitSignal) {
+		// second signal, the main loop did not get to shut down (e.g. blocked in a long wait())
+		_exit(EXIT_FAILURE);
+	}
+	// only async-signal-safe calls here, the EEPROM flush may block on a lock held by the
+	// interrupted code and runs in shutdown_on_signal() instead
+	const int savedErrno = errno;
+	exitSignal = sig;
+	EventLoop.wakeup();
+	errno = savedErrno;
+}
+
+static void shutdown_on_signal(void)
+{
+	if (exitSignal == SIGINT) {
 		logNotice("Received SIGINT\n\n");
-	} else if (sig == SIGTERM) {
-		logNotice("Received SIGTERM\n\n");
 	} else {
-		return;
+		logNotice("Received SIGTERM\n\n");
 	}
 
 #ifdef MY_RF24_IRQ_PIN
@@ -49,9 +67,15 @@ void handle_sigint(int sig)
 	MY_SERIALDEVICE.end();
 #endif
 
-	logClose();
+#if defined(MY_SENSOR_NETWORK)
+	// write routes changed since the last save interval
+	transportSaveRoutingTable();
+#endif
+
+	// write EEPROM changes still waiting for the sync interval
+	hwFlushConfig();
 
-	exit(EXIT_SUCCESS);
+	logClose();
 }
 
 static int daemonize(void)
@@ -444,6 +468,16 @@ int main(int argc, char *argv[])
 	logInfo("Starting gateway...\n");
 	logInfo("Protocol version - %s\n", MYSENSORS_LIBRARY_VERSION);
 
+#if defined(MY_OTA_FIRMWARE_SERVER_ENABLED)
+	if (conf.firmware_dir) {
+		(void)firmwareServerInit(conf.firmware_dir);
+	}
+#elif defined(MY_TRANSPORT_ENCRYPTION_CCM)
+	if (conf.firmware_dir) {
+		logError("firmware_dir ignored, OTA firmware blocks do not fit into MY_ENCRYPTION_CCM frames of this radio\n");
+	}
+#endif
+
 	_begin(); // Startup MySensors library
 
 	// EEPROM is initialized within _begin()
@@ -478,11 +512,12 @@ int main(int argc, char *argv[])
 		free(config_file);
 	}
 
-	for (;;) {
+	while (!exitSignal) {
 		_process();  // Process incoming data
 		if (loop) {
 			loop(); // Call sketch loop
 		}
 	}
-	return 0;
+	shutdown_on_signal();
+	return EXIT_SUCCESS;
 }
@@ -24,7 +24,8 @@
 #include <stdlib.h>
 #include "log.h"
 
-static pthread_mutex_t spiMutex = PTHREAD_MUTEX_INITIALIZER;
+// recursive, the radio drivers keep the lock over several transactions while queueing
+static pthread_mutex_t spiMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
 
 // Declare a single default instance
 SPIBCMClass SPIBCM = SPIBCMClass();
@@ -27,6 +27,7 @@
 #include "BCM.h"
 
 #define SPI_HAS_TRANSACTION
+#define SPI_HAS_QUEUED_TRANSFER
 
 #define SPI_CLOCK_BASE 256000000
 
@@ -183,6 +184,21 @@ public:
 	 * @param len Buffer length.
 	 */
 	inline static void transfern(char* buf, uint32_t len);
+	/**
+	 * @brief Queue a transfer.
+	 *
+	 * The BCM driver accesses the SPI registers directly without a syscall per
+	 * transfer, the data is therefore sent immediately.
+	 *
+	 * @param tbuf Sending buffer.
+	 * @param rbuf Receive buffer, NULL to discard received data.
+	 * @param len Buffer length.
+	 */
+	inline static void queueTransfer(const uint8_t* tbuf, uint8_t* rbuf, uint32_t len);
+	/**
+	 * @brief Send all queued transfers, nothing to do for the BCM driver.
+	 */
+	inline static void transferQueued();
 	/**
 	 * @brief Start SPI operations.
 	 */
@@ -257,6 +273,19 @@ void SPIBCMClass::transfern(char* buf, uint32_t len)
 	transfernb(buf, buf, len);
 }
 
+void SPIBCMClass::queueTransfer(const uint8_t* tbuf, uint8_t* rbuf, uint32_t len)
+{
+	if (rbuf == NULL) {
+		bcm2835_spi_writenb((const char *)tbuf, len);
+	} else {
+		bcm2835_spi_transfernb((char *)tbuf, (char *)rbuf, len);
+	}
+}
+
+void SPIBCMClass::transferQueued()
+{
+}
+
 extern SPIBCMClass SPIBCM;
 
 #endif
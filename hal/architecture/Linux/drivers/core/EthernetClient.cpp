@@ -32,6 +32,7 @@
 #include <netinet/tcp.h>
 #include <errno.h>
 #include "log.h"
+#include "EventLoop.h"
 
 EthernetClient::EthernetClient() : _sock(-1)
 {
@@ -100,6 +101,7 @@ int EthernetClient::connect(const char* host, uint16_t port)
 	void *addr = &(((struct sockaddr_in*)p->ai_addr)->sin_addr);
 	inet_ntop(p->ai_family, addr, s, sizeof s);
 	logDebug("connected to %s\n", s);
+	EventLoop.add(_sock);
 
 	freeaddrinfo(servinfo); // all done with this structure
 	if (use_bind) {
@@ -231,6 +233,7 @@ void EthernetClient::stop()
 	         1000000);
 
 	// free up the socket descriptor
+	EventLoop.remove(_sock);
 	::close(_sock);
 	_sock = -1;
 }
@@ -282,6 +285,7 @@ uint8_t EthernetClient::connected()
 void EthernetClient::close()
 {
 	if (_sock != -1) {
+		EventLoop.remove(_sock);
 		::close(_sock);
 		_sock = -1;
 	}
@@ -30,6 +30,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include "log.h"
+#include "EventLoop.h"
 #include "EthernetClient.h"
 
 EthernetServer::EthernetServer(uint16_t port, uint16_t max_clients) : port(port),
@@ -52,6 +53,7 @@ void EthernetServer::begin(IPAddress address)
 	char portstr[6];
 
 	if (sockfd != -1) {
+		EventLoop.remove(sockfd);
 		close(sockfd);
 		sockfd = -1;
 	}
@@ -104,6 +106,7 @@ void EthernetServer::begin(IPAddress address)
 	freeaddrinfo(servinfo);
 
 	fcntl(sockfd, F_SETFL, O_NONBLOCK);
+	EventLoop.add(sockfd);
 
 	struct sockaddr_in *ipv4 = (struct sockaddr_in *)p->ai_addr;
 	void *addr = &(ipv4->sin_addr);
@@ -204,6 +207,7 @@ void EthernetServer::_accept()
 
 	new_clients.push_back(new_fd);
 	clients.push_back(new_fd);
+	EventLoop.add(new_fd);
 
 	void *addr = &(((struct sockaddr_in*)&client_addr)->sin_addr);
 	inet_ntop(client_addr.ss_family, addr, ipstr, sizeof ipstr);
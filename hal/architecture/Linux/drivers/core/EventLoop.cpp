@@ -0,0 +1,261 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include "EventLoop.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include "log.h"
+
+// Declare a single default instance
+EventLoopClass EventLoop = EventLoopClass();
+
+EventLoopClass::EventLoopClass() : epfd(-1), infd(-1), evfd(-1), tmfd(-1), armed(false),
+	inputPaused(false)
+{
+	deadline.tv_sec = 0;
+	deadline.tv_nsec = 0;
+	for (int i = 0; i < EVENTLOOP_MAX_HANDLERS; i++) {
+		handlerFds[i] = -1;
+		handlers[i] = NULL;
+	}
+}
+
+EventLoopClass::~EventLoopClass()
+{
+	if (tmfd != -1) {
+		close(tmfd);
+	}
+	if (evfd != -1) {
+		close(evfd);
+	}
+	if (infd != -1) {
+		close(infd);
+	}
+	if (epfd != -1) {
+		close(epfd);
+	}
+}
+
+bool EventLoopClass::begin()
+{
+	if (epfd != -1) {
+		return true;
+	}
+
+	if ((epfd = epoll_create1(EPOLL_CLOEXEC)) == -1) {
+		logError("epoll_create1: %s\n", strerror(errno));
+		return false;
+	}
+	// input descriptors are kept in a nested epoll instance, so they can be paused at once
+	if ((infd = epoll_create1(EPOLL_CLOEXEC)) == -1) {
+		logError("epoll_create1: %s\n", strerror(errno));
+		return false;
+	}
+	if ((evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1) {
+		logError("eventfd: %s\n", strerror(errno));
+		return false;
+	}
+	if ((tmfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) == -1) {
+		logError("timerfd_create: %s\n", strerror(errno));
+		return false;
+	}
+
+	return watch(epfd, evfd) && watch(epfd, tmfd) && watch(epfd, infd);
+}
+
+bool EventLoopClass::watch(int set, int fd)
+{
+	struct epoll_event ev;
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	if (epoll_ctl(set, EPOLL_CTL_ADD, fd, &ev) == -1 && errno != EEXIST) {
+		logError("epoll_ctl: %s\n", strerror(errno));
+		return false;
+	}
+
+	return true;
+}
+
+bool EventLoopClass::add(int fd)
+{
+	if (fd == -1 || !begin()) {
+		return false;
+	}
+
+	return watch(infd, fd);
+}
+
+bool EventLoopClass::add(int fd, EventLoopHandler handler)
+{
+	int slot = -1;
+
+	for (int i = 0; i < EVENTLOOP_MAX_HANDLERS; i++) {
+		if (handlerFds[i] == fd) {
+			slot = i;
+			break;
+		}
+		if (slot == -1 && handlerFds[i] == -1) {
+			slot = i;
+		}
+	}
+	if (slot == -1) {
+		logError("EventLoop: no free handler slot for fd %d\n", fd);
+		return false;
+	}
+	if (fd == -1 || !begin() || !watch(epfd, fd)) {
+		return false;
+	}
+	handlerFds[slot] = fd;
+	handlers[slot] = handler;
+
+	return true;
+}
+
+void EventLoopClass::remove(int fd)
+{
+	if (fd != -1 && epfd != -1) {
+		// ENOENT if the fd was never added to a set, nothing to do then
+		(void)epoll_ctl(epfd, EPOLL_CTL_DEL, fd, NULL);
+		(void)epoll_ctl(infd, EPOLL_CTL_DEL, fd, NULL);
+	}
+	for (int i = 0; i < EVENTLOOP_MAX_HANDLERS; i++) {
+		if (handlerFds[i] == fd) {
+			handlerFds[i] = -1;
+			handlers[i] = NULL;
+		}
+	}
+}
+
+void EventLoopClass::wakeup()
+{
+	const uint64_t one = 1;
+
+	// EAGAIN means the counter is saturated, the loop is going to wake up anyway
+	if (evfd != -1 && write(evfd, &one, sizeof(one)) == -1 && errno != EAGAIN) {
+		logError("eventfd write: %s\n", strerror(errno));
+	}
+}
+
+void EventLoopClass::pauseInput(bool pause)
+{
+	struct epoll_event ev;
+
+	if (pause == inputPaused || epfd == -1) {
+		return;
+	}
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = pause ? 0 : EPOLLIN;
+	ev.data.fd = infd;
+	if (epoll_ctl(epfd, EPOLL_CTL_MOD, infd, &ev) == -1) {
+		logError("epoll_ctl: %s\n", strerror(errno));
+		return;
+	}
+	inputPaused = pause;
+}
+
+void EventLoopClass::setTimeout(uint32_t ms)
+{
+	struct timespec now, expire;
+	struct itimerspec its;
+
+	if (tmfd == -1) {
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	expire.tv_sec = now.tv_sec + ms / 1000;
+	expire.tv_nsec = now.tv_nsec + (ms % 1000) * 1000000L;
+	if (expire.tv_nsec >= 1000000000L) {
+		expire.tv_sec++;
+		expire.tv_nsec -= 1000000000L;
+	}
+
+	// Keep the armed timer if it is still pending and expires earlier
+	if (armed && (deadline.tv_sec > now.tv_sec ||
+	              (deadline.tv_sec == now.tv_sec && deadline.tv_nsec > now.tv_nsec)) &&
+	        (deadline.tv_sec < expire.tv_sec ||
+	         (deadline.tv_sec == expire.tv_sec && deadline.tv_nsec <= expire.tv_nsec))) {
+		return;
+	}
+
+	memset(&its, 0, sizeof(its));
+	its.it_value = expire;
+	if (timerfd_settime(tmfd, TFD_TIMER_ABSTIME, &its, NULL) == -1) {
+		logError("timerfd_settime: %s\n", strerror(errno));
+		armed = false;
+		return;
+	}
+	deadline = expire;
+	armed = true;
+}
+
+int EventLoopClass::wait(uint32_t ms)
+{
+	struct epoll_event events[EVENTLOOP_MAX_EVENTS];
+	uint64_t value;
+	int n;
+
+	if (!begin()) {
+		usleep(ms * 1000);
+		return -1;
+	}
+
+	setTimeout(ms);
+
+	do {
+		n = epoll_wait(epfd, events, EVENTLOOP_MAX_EVENTS, -1);
+	} while (n == -1 && errno == EINTR);
+
+	if (n == -1) {
+		logError("epoll_wait: %s\n", strerror(errno));
+		return -1;
+	}
+
+	// Clear the internal descriptors and run the handlers,
+	// data on the others is consumed by their owners
+	for (int i = 0; i < n; i++) {
+		const int fd = events[i].data.fd;
+		if (fd == evfd) {
+			if (read(evfd, &value, sizeof(value)) == -1 && errno != EAGAIN) {
+				logError("eventfd read: %s\n", strerror(errno));
+			}
+		} else if (fd == tmfd) {
+			if (read(tmfd, &value, sizeof(value)) == -1 && errno != EAGAIN) {
+				logError("timerfd read: %s\n", strerror(errno));
+			}
+			armed = false;
+		} else {
+			for (int j = 0; j < EVENTLOOP_MAX_HANDLERS; j++) {
+				if (handlerFds[j] == fd && handlers[j] != NULL) {
+					handlers[j](fd);
+					break;
+				}
+			}
+		}
+	}
+
+	return n;
+}
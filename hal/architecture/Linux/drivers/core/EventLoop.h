@@ -0,0 +1,133 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#ifndef EventLoop_h
+#define EventLoop_h
+
+#include <stdint.h>
+#include <time.h>
+
+#define EVENTLOOP_MAX_EVENTS 16 //!< Maximum number of events handled per wait() call.
+#define EVENTLOOP_MAX_HANDLERS 8 //!< Maximum number of file descriptors with a handler.
+
+/**
+ * @brief Function called by wait() when its file descriptor is readable.
+ */
+typedef void (*EventLoopHandler)(int fd);
+
+/**
+ * @brief Event loop based on epoll.
+ *
+ * Blocks the main loop until a registered file descriptor is readable, another thread
+ * (e.g. a radio interrupt handler) calls wakeup() or a requested timeout expires.
+ */
+class EventLoopClass
+{
+
+public:
+	/**
+	 * @brief EventLoopClass constructor.
+	 */
+	EventLoopClass();
+	/**
+	 * @brief EventLoopClass destructor.
+	 */
+	~EventLoopClass();
+	/**
+	 * @brief Creates the epoll instance, the wakeup eventfd and the timerfd.
+	 *
+	 * Calling it more than once has no effect.
+	 *
+	 * @return @c true if SUCCESS, else @c false.
+	 */
+	bool begin();
+	/**
+	 * @brief Watch a file descriptor for incoming data.
+	 *
+	 * @param fd file descriptor.
+	 * @return @c true if SUCCESS, else @c false.
+	 */
+	bool add(int fd);
+	/**
+	 * @brief Watch a file descriptor and call handler from wait() when it is readable.
+	 *
+	 * The handler runs in the thread calling wait() and must consume the data.
+	 *
+	 * @param fd file descriptor.
+	 * @param handler function to call.
+	 * @return @c true if SUCCESS, else @c false.
+	 */
+	bool add(int fd, EventLoopHandler handler);
+	/**
+	 * @brief Stop watching a file descriptor.
+	 *
+	 * @param fd file descriptor.
+	 */
+	void remove(int fd);
+	/**
+	 * @brief Stop or resume waking up wait() for data on the descriptors added without handler.
+	 *
+	 * Used while their input is deliberately left unread, wait() would return at once otherwise.
+	 * Descriptors with a handler, wakeup() and timeouts are not affected.
+	 *
+	 * @param pause @c true to stop, @c false to resume.
+	 */
+	void pauseInput(bool pause);
+	/**
+	 * @brief Wake up a blocked wait() call. Safe to call from any thread.
+	 */
+	void wakeup();
+	/**
+	 * @brief Make sure the next wait() call returns within the given time.
+	 *
+	 * @param ms timeout in milliseconds.
+	 */
+	void setTimeout(uint32_t ms);
+	/**
+	 * @brief Block until there is work to do.
+	 *
+	 * @param ms maximum time to block in milliseconds.
+	 * @return the number of events received, -1 if FAILURE.
+	 */
+	int wait(uint32_t ms);
+
+private:
+	/**
+	 * @brief Add a file descriptor to an epoll instance.
+	 *
+	 * @param set epoll instance.
+	 * @param fd file descriptor.
+	 * @return @c true if SUCCESS, else @c false.
+	 */
+	bool watch(int set, int fd);
+
+	int epfd; //!< @brief epoll instance.
+	int infd; //!< @brief nested epoll instance of the descriptors added without handler.
+	int evfd; //!< @brief eventfd used by wakeup().
+	int tmfd; //!< @brief timerfd used by setTimeout().
+	bool armed; //!< @brief @c true if tmfd is armed.
+	bool inputPaused; //!< @brief @c true if infd is not watched, see pauseInput().
+	struct timespec deadline; //!< @brief Expiration time of tmfd.
+	int handlerFds[EVENTLOOP_MAX_HANDLERS]; //!< @brief File descriptors with a handler, -1 if unused.
+	EventLoopHandler handlers[EVENTLOOP_MAX_HANDLERS]; //!< @brief Handlers of handlerFds.
+};
+
+extern EventLoopClass EventLoop;
+
+#endif
@@ -0,0 +1,390 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <errno.h>
+#include <string>
+#include <algorithm>
+#include "log.h"
+#include "FirmwareCache.h"
+
+#define FIRMWARE_CACHE_BLOCK_SIZE	16u
+#define FIRMWARE_CACHE_MAX_SIZE		(0xFFFFul * FIRMWARE_CACHE_BLOCK_SIZE)
+
+// delta patch format, see MyOTAFirmwareUpdate.h
+#define FIRMWARE_DELTA_MAGIC		0x444Du
+#define FIRMWARE_DELTA_OP_LITERAL	0x7Fu
+#define FIRMWARE_DELTA_OP_COPY		0x80u
+#define FIRMWARE_DELTA_OP_FILL		0x81u
+#define FIRMWARE_DELTA_OP_END		0xFFu
+#define FIRMWARE_DELTA_MIN_MATCH	8u		// shorter copies and fills are sent as literals
+#define FIRMWARE_DELTA_MAX_LENGTH	0xFFFFu
+#define FIRMWARE_DELTA_MAX_CANDIDATES	256u	// source positions compared per target position
+
+int FirmwareCache::load(const char *directory)
+{
+	DIR *dir = opendir(directory);
+	if (!dir) {
+		logError("Failed to open firmware directory %s: %s\n", directory, strerror(errno));
+		return -1;
+	}
+
+	clear();
+
+	struct dirent *entry;
+	while ((entry = readdir(dir)) != NULL) {
+		unsigned int type, version;
+		char extension[5];
+		int length;
+		if (sscanf(entry->d_name, "%u_%u.%4s%n", &type, &version, extension, &length) != 3 ||
+		        entry->d_name[length] != 0 || type > 0xFFFF || version > 0xFFFF) {
+			continue;
+		}
+
+		std::string path = std::string(directory) + "/" + entry->d_name;
+		FirmwareImage image;
+		int ret;
+		if (!strcmp(extension, "hex")) {
+			ret = readHex(path.c_str(), image.data);
+		} else if (!strcmp(extension, "bin")) {
+			ret = readBinary(path.c_str(), image.data);
+		} else {
+			continue;
+		}
+		if (ret != 0) {
+			logError("Ignoring firmware image %s\n", path.c_str());
+			continue;
+		}
+		if (find(type, version)) {
+			logWarning("Duplicate firmware image %s ignored\n", path.c_str());
+			continue;
+		}
+
+		// pad to whole blocks, unused flash reads as 0xFF
+		const size_t padding = (FIRMWARE_CACHE_BLOCK_SIZE - image.data.size() % FIRMWARE_CACHE_BLOCK_SIZE) %
+		                       FIRMWARE_CACHE_BLOCK_SIZE;
+		image.data.insert(image.data.end(), padding, 0xFF);
+		image.type = type;
+		image.version = version;
+		image.crc = crc16(image.data);
+		_images.push_back(image);
+		logInfo("Firmware T=%u,V=%u loaded: %zu bytes, CRC=%04X\n", type, version, image.data.size(),
+		        image.crc);
+	}
+	closedir(dir);
+
+	return (int)_images.size();
+}
+
+void FirmwareCache::clear()
+{
+	_deltas.clear();
+	_images.clear();
+}
+
+size_t FirmwareCache::size() const
+{
+	return _images.size();
+}
+
+const FirmwareImage *FirmwareCache::find(uint16_t type, uint16_t version) const
+{
+	for (size_t i = 0; i < _images.size(); i++) {
+		if (_images[i].type == type && _images[i].version == version) {
+			return &_images[i];
+		}
+	}
+	return NULL;
+}
+
+const FirmwareImage *FirmwareCache::latest(uint16_t type) const
+{
+	const FirmwareImage *image = NULL;
+	for (size_t i = 0; i < _images.size(); i++) {
+		if (_images[i].type == type && (!image || _images[i].version > image->version)) {
+			image = &_images[i];
+		}
+	}
+	return image;
+}
+
+const std::vector<uint8_t> *FirmwareCache::delta(const FirmwareImage *from, const FirmwareImage *to)
+{
+	const std::pair<const FirmwareImage *, const FirmwareImage *> key(from, to);
+	std::map<std::pair<const FirmwareImage *, const FirmwareImage *>, std::vector<uint8_t> >::iterator it =
+	    _deltas.find(key);
+	if (it == _deltas.end()) {
+		std::vector<uint8_t> patch;
+		makeDelta(*from, *to, patch);
+		if (patch.size() >= to->data.size()) {
+			patch.clear();
+		} else {
+			logInfo("Delta T=%u,V=%u->V=%u generated: %zu bytes\n", to->type, from->version, to->version,
+			        patch.size());
+		}
+		it = _deltas.insert(std::make_pair(key, patch)).first;
+	}
+	return it->second.empty() ? NULL : &it->second;
+}
+
+void FirmwareCache::makeDelta(const FirmwareImage &from, const FirmwareImage &to,
+                              std::vector<uint8_t> &patch)
+{
+	const std::vector<uint8_t> &source = from.data;
+	const std::vector<uint8_t> &target = to.data;
+
+	// index source positions by their first 4 bytes
+	std::map<uint32_t, std::vector<uint32_t> > index;
+	for (size_t i = 0; i + 4 <= source.size(); i++) {
+		const uint32_t key = (uint32_t)source[i] | (uint32_t)source[i + 1] << 8 |
+		                     (uint32_t)source[i + 2] << 16 | (uint32_t)source[i + 3] << 24;
+		std::vector<uint32_t> &positions = index[key];
+		if (positions.size() < FIRMWARE_DELTA_MAX_CANDIDATES) {
+			positions.push_back(i);
+		}
+	}
+
+	patch.clear();
+	patch.push_back(FIRMWARE_DELTA_MAGIC & 0xFF);
+	patch.push_back(FIRMWARE_DELTA_MAGIC >> 8);
+	patch.push_back(from.crc & 0xFF);
+	patch.push_back(from.crc >> 8);
+
+	std::vector<uint8_t> literal;
+	size_t expected = 0;	// source position following the last copy
+	size_t pos = 0;
+	while (pos < target.size()) {
+		const size_t limit = std::min(target.size() - pos, (size_t)FIRMWARE_DELTA_MAX_LENGTH);
+
+		size_t run = 1;
+		while (run < limit && target[pos + run] == target[pos]) {
+			run++;
+		}
+
+		size_t bestLength = 0;
+		size_t bestSource = 0;
+		std::vector<uint32_t> candidates;
+		if (expected < source.size()) {
+			candidates.push_back(expected);
+		}
+		if (limit >= 4) {
+			const uint32_t key = (uint32_t)target[pos] | (uint32_t)target[pos + 1] << 8 |
+			                     (uint32_t)target[pos + 2] << 16 | (uint32_t)target[pos + 3] << 24;
+			std::map<uint32_t, std::vector<uint32_t> >::const_iterator it = index.find(key);
+			if (it != index.end()) {
+				candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+			}
+		}
+		for (size_t c = 0; c < candidates.size(); c++) {
+			const size_t start = candidates[c];
+			size_t length = 0;
+			while (length < limit && start + length < source.size() &&
+			        source[start + length] == target[pos + length]) {
+				length++;
+			}
+			if (length > bestLength) {
+				bestLength = length;
+				bestSource = start;
+			}
+		}
+		if (bestSource + bestLength > 0xFFFFFFu) {
+			bestLength = 0;
+		}
+
+		uint8_t op = FIRMWARE_DELTA_OP_END;
+		size_t length = 0;
+		if (run >= FIRMWARE_DELTA_MIN_MATCH && run >= bestLength) {
+			op = FIRMWARE_DELTA_OP_FILL;
+			length = run;
+		} else if (bestLength >= FIRMWARE_DELTA_MIN_MATCH) {
+			op = FIRMWARE_DELTA_OP_COPY;
+			length = bestLength;
+		}
+
+		if (op == FIRMWARE_DELTA_OP_END) {
+			// changed byte, keep source in step for in-place modifications
+			literal.push_back(target[pos++]);
+			expected++;
+		}
+		if (!literal.empty() && (op != FIRMWARE_DELTA_OP_END || literal.size() > FIRMWARE_DELTA_OP_LITERAL ||
+		                         pos == target.size())) {
+			patch.push_back((uint8_t)(literal.size() - 1));
+			patch.insert(patch.end(), literal.begin(), literal.end());
+			literal.clear();
+		}
+		if (op != FIRMWARE_DELTA_OP_END) {
+			patch.push_back(op);
+			patch.push_back(length & 0xFF);
+			patch.push_back(length >> 8);
+			if (op == FIRMWARE_DELTA_OP_COPY) {
+				patch.push_back(bestSource & 0xFF);
+				patch.push_back((bestSource >> 8) & 0xFF);
+				patch.push_back(bestSource >> 16);
+				expected = bestSource + length;
+			} else {
+				patch.push_back(target[pos]);
+			}
+			pos += length;
+		}
+	}
+
+	// end marker, padded to whole blocks
+	do {
+		patch.push_back(FIRMWARE_DELTA_OP_END);
+	} while (patch.size() % FIRMWARE_CACHE_BLOCK_SIZE);
+}
+
+int FirmwareCache::readHex(const char *fileName, std::vector<uint8_t> &data)
+{
+	FILE *file = fopen(fileName, "r");
+	if (!file) {
+		logError("Failed to open %s: %s\n", fileName, strerror(errno));
+		return -1;
+	}
+
+	// image starts at the lowest address found in the file
+	std::vector<uint8_t> image;
+	uint32_t base = UINT32_MAX;
+	uint32_t offset = 0;
+	unsigned int line = 0;
+	bool eof = false;
+	char buf[600];
+
+	while (!eof && fgets(buf, sizeof(buf), file)) {
+		line++;
+		if (buf[0] != ':') {
+			continue;
+		}
+		uint8_t record[256 + 5];
+		size_t len = 0;
+		for (const char *p = &buf[1]; len < sizeof(record); p += 2) {
+			char byte[3] = { p[0], p[0] ? p[1] : (char)0, 0 };
+			char *end;
+			record[len] = (uint8_t)strtoul(byte, &end, 16);
+			if (end != &byte[2]) {
+				break;
+			}
+			len++;
+		}
+		uint8_t checksum = 0;
+		for (size_t i = 0; i < len; i++) {
+			checksum += record[i];
+		}
+		if (len < 5 || len != (size_t)record[0] + 5 || checksum) {
+			logError("%s:%u: invalid Intel HEX record\n", fileName, line);
+			fclose(file);
+			return -1;
+		}
+
+		const uint8_t count = record[0];
+		const uint32_t address = offset + ((uint32_t)record[1] << 8 | record[2]);
+		const uint8_t *payload = &record[4];
+		switch (record[3]) {
+		case 0x00:	// data
+			if (!count) {
+				break;
+			}
+			if (base == UINT32_MAX) {
+				base = address;
+			} else if (address < base) {
+				image.insert(image.begin(), base - address, 0xFF);
+				base = address;
+			}
+			if (address + count - base > FIRMWARE_CACHE_MAX_SIZE) {
+				logError("%s:%u: image exceeds %lu bytes\n", fileName, line, FIRMWARE_CACHE_MAX_SIZE);
+				fclose(file);
+				return -1;
+			}
+			if (image.size() < address + count - base) {
+				image.resize(address + count - base, 0xFF);
+			}
+			memcpy(&image[address - base], payload, count);
+			break;
+		case 0x01:	// end of file
+			eof = true;
+			break;
+		case 0x02:	// extended segment address
+			offset = ((uint32_t)payload[0] << 8 | payload[1]) << 4;
+			break;
+		case 0x04:	// extended linear address
+			offset = ((uint32_t)payload[0] << 8 | payload[1]) << 16;
+			break;
+		default:	// start address records
+			break;
+		}
+	}
+	fclose(file);
+
+	if (image.empty()) {
+		logError("%s: no data records\n", fileName);
+		return -1;
+	}
+	data.swap(image);
+	return 0;
+}
+
+int FirmwareCache::readBinary(const char *fileName, std::vector<uint8_t> &data)
+{
+	FILE *file = fopen(fileName, "rb");
+	if (!file) {
+		logError("Failed to open %s: %s\n", fileName, strerror(errno));
+		return -1;
+	}
+
+	std::vector<uint8_t> image;
+	uint8_t buf[4096];
+	size_t len;
+	while ((len = fread(buf, 1, sizeof(buf), file)) > 0) {
+		image.insert(image.end(), buf, buf + len);
+		if (image.size() > FIRMWARE_CACHE_MAX_SIZE) {
+			logError("%s: image exceeds %lu bytes\n", fileName, FIRMWARE_CACHE_MAX_SIZE);
+			fclose(file);
+			return -1;
+		}
+	}
+	fclose(file);
+
+	if (image.empty()) {
+		logError("%s: empty image\n", fileName);
+		return -1;
+	}
+	data.swap(image);
+	return 0;
+}
+
+uint16_t FirmwareCache::crc16(const std::vector<uint8_t> &data)
+{
+	// same CRC16 (poly 0xA001, init 0xFFFF) as the node uses to verify the image
+	uint16_t crc = ~0;
+	for (size_t i = 0; i < data.size(); i++) {
+		crc ^= data[i];
+		for (uint8_t j = 0; j < 8; j++) {
+			if (crc & 1) {
+				crc = (crc >> 1) ^ 0xA001;
+			} else {
+				crc = (crc >> 1);
+			}
+		}
+	}
+	return crc;
+}
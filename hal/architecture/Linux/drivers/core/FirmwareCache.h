@@ -0,0 +1,110 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/**
+* In-memory cache of firmware images served to nodes by the gateway.
+* Images are loaded from a directory, padded to whole firmware blocks and
+* their CRC is computed once at load time.
+*/
+
+#ifndef FirmwareCache_h
+#define FirmwareCache_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <map>
+#include <utility>
+
+/**
+ * @brief Cached firmware image
+ */
+struct FirmwareImage {
+	uint16_t type; //!< @brief firmware type.
+	uint16_t version; //!< @brief firmware version.
+	uint16_t crc; //!< @brief CRC16 of the padded image.
+	std::vector<uint8_t> data; //!< @brief image data, padded with 0xFF to a multiple of 16 bytes.
+};
+
+/**
+ * FirmwareCache class
+ */
+class FirmwareCache
+{
+
+public:
+	/**
+	 * @brief Loads all firmware images from a directory.
+	 *
+	 * File names must follow the pattern TYPE_VERSION.hex (Intel HEX) or
+	 * TYPE_VERSION.bin (raw binary), type and version in decimal.
+	 * Previously loaded images are discarded.
+	 *
+	 * @param directory path to the firmware directory.
+	 * @return number of images loaded or -1 if the directory cannot be read.
+	 */
+	int load(const char *directory);
+	/**
+	 * @brief Discards all cached images.
+	 */
+	void clear();
+	/**
+	 * @brief Returns the number of cached images.
+	 */
+	size_t size() const;
+	/**
+	 * @brief Finds an image.
+	 *
+	 * @param type firmware type.
+	 * @param version firmware version.
+	 * @return the image or NULL if not cached.
+	 */
+	const FirmwareImage *find(uint16_t type, uint16_t version) const;
+	/**
+	 * @brief Finds the image with the highest version of a firmware type.
+	 *
+	 * @param type firmware type.
+	 * @return the image or NULL if no image of this type is cached.
+	 */
+	const FirmwareImage *latest(uint16_t type) const;
+	/**
+	 * @brief Returns the delta patch that turns one cached image into another.
+	 *
+	 * Patches are generated on first use and kept until the cache is cleared. The
+	 * patch format is described in MyOTAFirmwareUpdate.h, patches are padded with
+	 * end markers to a multiple of 16 bytes.
+	 *
+	 * @param from image running on the node.
+	 * @param to new image.
+	 * @return the patch or NULL if it is not smaller than the new image.
+	 */
+	const std::vector<uint8_t> *delta(const FirmwareImage *from, const FirmwareImage *to);
+
+private:
+	std::vector<FirmwareImage> _images; //!< @brief cached images.
+	std::map<std::pair<const FirmwareImage *, const FirmwareImage *>, std::vector<uint8_t> >
+	_deltas; //!< @brief generated patches, empty if not worth it.
+
+	static int readHex(const char *fileName, std::vector<uint8_t> &data);
+	static int readBinary(const char *fileName, std::vector<uint8_t> &data);
+	static uint16_t crc16(const std::vector<uint8_t> &data);
+	static void makeDelta(const FirmwareImage &from, const FirmwareImage &to, std::vector<uint8_t> &patch);
+};
+
+#endif
@@ -24,11 +24,220 @@
 #include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
+#if defined(LINUX_GPIO_CHARDEV)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#endif
 #include "log.h"
 
 // Declare a single default instance
 GPIOClass GPIO = GPIOClass();
 
+#if defined(LINUX_GPIO_CHARDEV)
+
+#define GPIO_CONSUMER "mysgw"	//!< Label of the requested lines
+
+// exportedPins values
+#define GPIO_LINE_FREE 0	//!< Line not requested
+#define GPIO_LINE_INPUT 1	//!< Line requested as input
+#define GPIO_LINE_OUTPUT 2	//!< Line requested as output
+
+GPIOClass::GPIOClass()
+{
+	openChips();
+}
+
+GPIOClass::GPIOClass(const GPIOClass& other)
+{
+	// Line handles can not be shared, start with a fresh set
+	(void)other;
+	openChips();
+}
+
+GPIOClass::~GPIOClass()
+{
+	// The kernel releases the lines when their descriptors are closed
+	for (int i = 0; i < lastPinNum + 1; ++i) {
+		if (lineFds[i] != -1) {
+			close(lineFds[i]);
+		}
+	}
+	for (int i = 0; i < GPIO_MAX_CHIPS; ++i) {
+		if (chipFds[i] != -1) {
+			close(chipFds[i]);
+		}
+	}
+
+	delete [] exportedPins;
+	delete [] lineFds;
+}
+
+void GPIOClass::openChips()
+{
+	struct gpiochip_info info;
+	char file[32];
+
+	lastPinNum = -1;
+	for (int i = 0; i < GPIO_MAX_CHIPS; ++i) {
+		chipFds[i] = -1;
+		chipBases[i] = 0;
+		chipLines[i] = 0;
+	}
+
+	for (int i = 0; i < GPIO_MAX_CHIPS; ++i) {
+		snprintf(file, sizeof(file), "/dev/gpiochip%d", i);
+		int fd = open(file, O_RDWR | O_CLOEXEC);
+		if (fd == -1) {
+			break;
+		}
+		if (ioctl(fd, GPIO_GET_CHIPINFO_IOCTL, &info) == -1) {
+			logError("Could not get info of %s: %s\n", file, strerror(errno));
+			close(fd);
+			break;
+		}
+		chipFds[i] = fd;
+		chipBases[i] = lastPinNum + 1;
+		chipLines[i] = info.lines;
+		lastPinNum += info.lines;
+	}
+
+	if (lastPinNum < 0) {
+		logError("Could not open /dev/gpiochip0");
+		exit(1);
+	}
+
+	exportedPins = new uint8_t[lastPinNum + 1];
+	lineFds = new int[lastPinNum + 1];
+	for (int i = 0; i < lastPinNum + 1; ++i) {
+		exportedPins[i] = GPIO_LINE_FREE;
+		lineFds[i] = -1;
+	}
+}
+
+int GPIOClass::configureLine(uint8_t pin, uint64_t flags)
+{
+	if (pin > lastPinNum) {
+		return -1;
+	}
+
+	if (lineFds[pin] != -1) {
+		struct gpio_v2_line_config config;
+		memset(&config, 0, sizeof(config));
+		config.flags = flags;
+		if (ioctl(lineFds[pin], GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) == -1) {
+			logError("Could not configure pin %u: %s\n", pin, strerror(errno));
+			return -1;
+		}
+		return lineFds[pin];
+	}
+
+	for (int i = 0; i < GPIO_MAX_CHIPS && chipFds[i] != -1; ++i) {
+		if (pin < chipBases[i] || pin >= chipBases[i] + chipLines[i]) {
+			continue;
+		}
+		struct gpio_v2_line_request request;
+		memset(&request, 0, sizeof(request));
+		request.offsets[0] = pin - chipBases[i];
+		request.num_lines = 1;
+		strncpy(request.consumer, GPIO_CONSUMER, sizeof(request.consumer) - 1);
+		request.config.flags = flags;
+		if (ioctl(chipFds[i], GPIO_V2_GET_LINE_IOCTL, &request) == -1) {
+			logError("Could not request pin %u: %s\n", pin, strerror(errno));
+			return -1;
+		}
+		lineFds[pin] = request.fd;
+		return request.fd;
+	}
+	return -1;
+}
+
+void GPIOClass::pinMode(uint8_t pin, uint8_t mode)
+{
+	if (mode == INPUT) {
+		if (configureLine(pin, GPIO_V2_LINE_FLAG_INPUT) != -1) {
+			exportedPins[pin] = GPIO_LINE_INPUT;
+		}
+	} else {
+		if (configureLine(pin, GPIO_V2_LINE_FLAG_OUTPUT) != -1) {
+			exportedPins[pin] = GPIO_LINE_OUTPUT;
+		}
+	}
+}
+
+void GPIOClass::digitalWrite(uint8_t pin, uint8_t value)
+{
+	struct gpio_v2_line_values values;
+
+	if (pin > lastPinNum) {
+		return;
+	}
+	if (exportedPins[pin] != GPIO_LINE_OUTPUT) {
+		pinMode(pin, OUTPUT);
+		if (exportedPins[pin] != GPIO_LINE_OUTPUT) {
+			return;
+		}
+	}
+
+	values.bits = value == 0 ? 0 : 1;
+	values.mask = 1;
+	if (ioctl(lineFds[pin], GPIO_V2_LINE_SET_VALUES_IOCTL, &values) == -1) {
+		logError("digitalWrite: failed to write pin %u: %s\n", pin, strerror(errno));
+	}
+}
+
+uint8_t GPIOClass::digitalRead(uint8_t pin)
+{
+	struct gpio_v2_line_values values;
+
+	if (pin > lastPinNum) {
+		return 0;
+	}
+	if (exportedPins[pin] == GPIO_LINE_FREE) {
+		pinMode(pin, INPUT);
+		if (exportedPins[pin] == GPIO_LINE_FREE) {
+			return 0;
+		}
+	}
+
+	values.bits = 0;
+	values.mask = 1;
+	if (ioctl(lineFds[pin], GPIO_V2_LINE_GET_VALUES_IOCTL, &values) == -1) {
+		logError("digitalRead: failed to read pin %u: %s\n", pin, strerror(errno));
+		return 0;
+	}
+	return values.bits & 1;
+}
+
+int GPIOClass::requestEdgeEvents(uint8_t pin, bool rising, bool falling)
+{
+	uint64_t flags = GPIO_V2_LINE_FLAG_INPUT;
+
+	if (rising) {
+		flags |= GPIO_V2_LINE_FLAG_EDGE_RISING;
+	}
+	if (falling) {
+		flags |= GPIO_V2_LINE_FLAG_EDGE_FALLING;
+	}
+	const int fd = configureLine(pin, flags);
+	if (fd != -1) {
+		exportedPins[pin] = GPIO_LINE_INPUT;
+	}
+	return fd;
+}
+
+GPIOClass& GPIOClass::operator=(const GPIOClass& other)
+{
+	if (this != &other) {
+		this->~GPIOClass();
+		openChips();
+	}
+	return *this;
+}
+
+#else /* Else part of LINUX_GPIO_CHARDEV */
+
 GPIOClass::GPIOClass()
 {
 	FILE *f;
@@ -192,11 +401,6 @@ uint8_t GPIOClass::digitalRead(uint8_t pin)
 	return i;
 }
 
-uint8_t GPIOClass::digitalPinToInterrupt(uint8_t pin)
-{
-	return pin;
-}
-
 GPIOClass& GPIOClass::operator=(const GPIOClass& other)
 {
 	if (this != &other) {
@@ -209,3 +413,10 @@ GPIOClass& GPIOClass::operator=(const GPIOClass& other)
 	}
 	return *this;
 }
+
+#endif /* End of LINUX_GPIO_CHARDEV */
+
+uint8_t GPIOClass::digitalPinToInterrupt(uint8_t pin)
+{
+	return pin;
+}
@@ -28,8 +28,17 @@
 #define LOW 0
 #define HIGH 1
 
+#if defined(LINUX_GPIO_CHARDEV)
+#define GPIO_MAX_CHIPS 8 //!< Maximum number of /dev/gpiochipN devices used.
+#endif
+
 /**
  * @brief GPIO class
+ *
+ * Uses the GPIO character device (/dev/gpiochipN) if LINUX_GPIO_CHARDEV is defined, the
+ * sysfs interface (/sys/class/gpio) otherwise. With the character device, pin numbers
+ * are assigned chip after chip in the order of N, so on single-chip boards the pin
+ * number is the line offset.
  */
 class GPIOClass
 {
@@ -75,6 +84,19 @@ public:
 	 * @return The same parameter pin number.
 	 */
 	uint8_t digitalPinToInterrupt(uint8_t pin);
+#if defined(LINUX_GPIO_CHARDEV)
+	/**
+	 * @brief Configures the pin as input and enables edge detection.
+	 *
+	 * Edge events are read from the returned line file descriptor as struct gpio_v2_line_event.
+	 *
+	 * @param pin The number of the pin.
+	 * @param rising Report rising edges.
+	 * @param falling Report falling edges.
+	 * @return line file descriptor, -1 if FAILURE.
+	 */
+	int requestEdgeEvents(uint8_t pin, bool rising, bool falling);
+#endif
 	/**
 	 * @brief Overloaded assign operator.
 	 *
@@ -84,6 +106,24 @@ public:
 private:
 	int lastPinNum; //!< @brief Highest pin number supported.
 	uint8_t *exportedPins; //!< @brief Array with information of which pins were exported.
+#if defined(LINUX_GPIO_CHARDEV)
+	/**
+	 * @brief Requests the line of a pin or changes its configuration.
+	 *
+	 * @param pin The number of the pin.
+	 * @param flags GPIO_V2_LINE_FLAG_* flags.
+	 * @return line file descriptor, -1 if FAILURE.
+	 */
+	int configureLine(uint8_t pin, uint64_t flags);
+	/**
+	 * @brief Opens the gpiochip devices and computes the pin numbering.
+	 */
+	void openChips();
+	int chipFds[GPIO_MAX_CHIPS]; //!< @brief gpiochip file descriptors, -1 if unused.
+	int chipBases[GPIO_MAX_CHIPS]; //!< @brief Pin number of the first line of each chip.
+	int chipLines[GPIO_MAX_CHIPS]; //!< @brief Number of lines of each chip.
+	int *lineFds; //!< @brief Line file descriptor of each pin, -1 if not requested.
+#endif
 };
 
 extern GPIOClass GPIO;
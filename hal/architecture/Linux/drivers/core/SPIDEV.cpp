@@ -41,9 +41,12 @@ uint8_t SPIDEVClass::mode = SPI_MODE0;
 uint32_t SPIDEVClass::speed = SPI_CLOCK_BASE;
 uint8_t SPIDEVClass::bit_order = MSBFIRST;
 struct spi_ioc_transfer SPIDEVClass::tr = {0,0,0,0,0,8,0,0,0,0};	// 8 bits_per_word, 0 cs_change
+struct spi_ioc_transfer SPIDEVClass::queue[SPI_MAX_QUEUED_TRANSFERS];
+uint8_t SPIDEVClass::queueLength = 0;
 
 SPIDEVClass::SPIDEVClass()
 {
+	pthread_mutexattr_init(&attr);
 	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
 	pthread_mutex_init(&spiMutex, &attr);
 }
@@ -210,6 +213,51 @@ void SPIDEVClass::transfern(char* buf, uint32_t len)
 	transfernb(buf, buf, len);
 }
 
+void SPIDEVClass::queueTransfer(const uint8_t* tbuf, uint8_t* rbuf, uint32_t len)
+{
+	// the lock is held until transferQueued(), no other thread may interleave segments
+	pthread_mutex_lock(&spiMutex);
+
+	if (queueLength == SPI_MAX_QUEUED_TRANSFERS) {
+		transferQueued();
+	}
+
+	struct spi_ioc_transfer *segment = &queue[queueLength++];
+	memset(segment, 0, sizeof(*segment));
+	segment->tx_buf = (unsigned long)tbuf;
+	segment->rx_buf = (unsigned long)rbuf;
+	segment->len = len;
+	segment->speed_hz = speed;
+	segment->bits_per_word = 8;
+}
+
+void SPIDEVClass::transferQueued()
+{
+	int ret;
+
+	pthread_mutex_lock(&spiMutex);
+
+	const uint8_t count = queueLength;
+	if (count) {
+		// toggle chip select between segments, the last one releases it as usual
+		for (uint8_t i = 0; i < count - 1; i++) {
+			queue[i].cs_change = 1;
+		}
+
+		ret = ioctl(fd, SPI_IOC_MESSAGE(count), queue);
+		if (ret < 1) {
+			logError("Can't send spi message.\n");
+			abort();
+		}
+		queueLength = 0;
+	}
+
+	// release the locks taken by queueTransfer()
+	for (uint8_t i = 0; i <= count; i++) {
+		pthread_mutex_unlock(&spiMutex);
+	}
+}
+
 void SPIDEVClass::beginTransaction(SPISettings settings)
 {
 	int ret;
@@ -27,6 +27,11 @@
 #include <linux/spi/spidev.h>
 
 #define SPI_HAS_TRANSACTION
+#define SPI_HAS_QUEUED_TRANSFER
+
+#ifndef SPI_MAX_QUEUED_TRANSFERS
+#define SPI_MAX_QUEUED_TRANSFERS 8 //!< Maximum number of segments sent in one SPI message
+#endif
 
 #define MSBFIRST 0
 #define LSBFIRST SPI_LSB_FIRST
@@ -172,6 +177,22 @@ public:
 	* @param len Length of the data
 	*/
 	static void transfern(char* buf, uint32_t len);
+	/**
+	* @brief Queue a transfer, sent with the next transferQueued()
+	*
+	* Each queued transfer is framed by its own chip select cycle, but all of them
+	* are handed to the kernel in a single SPI message. Buffers must stay valid
+	* until transferQueued() returns. A full queue is sent before queueing.
+	*
+	* @param tbuf Transmit buffer
+	* @param rbuf Receive buffer, NULL to discard received data
+	* @param len Length of the data
+	*/
+	static void queueTransfer(const uint8_t* tbuf, uint8_t* rbuf, uint32_t len);
+	/**
+	* @brief Send all queued transfers in one SPI message
+	*/
+	static void transferQueued();
 	/**
 	 * @brief Start SPI transaction.
 	 *
@@ -203,6 +224,8 @@ private:
 	static uint32_t speed; //!< @brief SPI speed.
 	static uint8_t bit_order; //!< @brief SPI bit order.
 	static struct spi_ioc_transfer tr; //!< @brief Auxiliar struct for data transfer.
+	static struct spi_ioc_transfer queue[SPI_MAX_QUEUED_TRANSFERS]; //!< @brief Queued transfers.
+	static uint8_t queueLength; //!< @brief Number of queued transfers.
 
 	static void init();
 };
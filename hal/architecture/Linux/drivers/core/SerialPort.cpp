@@ -29,11 +29,13 @@
 #include <errno.h>
 #include <sys/stat.h>
 #include "log.h"
+#include "EventLoop.h"
 #include "SerialPort.h"
 
 SerialPort::SerialPort(const char *port, bool isPty) : serialPort(std::string(port)), isPty(isPty)
 {
 	sd = -1;
+	ptySlaveSd = -1;
 }
 
 void SerialPort::begin(int bauds)
@@ -67,6 +69,12 @@ bool SerialPort::open(int bauds)
 			return false;
 		}
 
+		// without an open slave the master keeps signaling a hangup once the controller disconnects
+		if ((ptySlaveSd = ::open(ptsname(sd), O_RDWR | O_NOCTTY)) == -1) {
+			logError("Couldn't open the PTY slave: %s\n", strerror(errno));
+			return false;
+		}
+
 		/* create a symlink with predictable name to the PTY device */
 		unlink(serialPort.c_str());	// remove the symlink if it already exists
 		if (symlink(ptsname(sd), serialPort.c_str()) != 0) {
@@ -175,6 +183,8 @@ bool SerialPort::open(int bauds)
 
 	usleep(10000);
 
+	EventLoop.add(sd);
+
 	return true;
 }
 
@@ -238,6 +248,18 @@ int SerialPort::read()
 	return -1;
 }
 
+int SerialPort::read(uint8_t *buffer, size_t size)
+{
+	int ret = ::read(sd, buffer, size);
+	if (ret < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			return 0;
+		}
+		logError("Serial - read failed: %s\n", strerror(errno));
+	}
+	return ret;
+}
+
 size_t SerialPort::write(uint8_t b)
 {
 	int ret = ::write(sd, &b, 1);
@@ -277,7 +299,12 @@ void SerialPort::flush()
 
 void SerialPort::end()
 {
+	EventLoop.remove(sd);
 	close(sd);
+	if (ptySlaveSd != -1) {
+		close(ptySlaveSd);
+		ptySlaveSd = -1;
+	}
 
 	if (isPty) {
 		unlink(serialPort.c_str());	// remove the symlink
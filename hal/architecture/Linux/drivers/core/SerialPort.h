@@ -33,6 +33,7 @@ class SerialPort : public Stream
 
 private:
 	int sd; //!< @brief file descriptor number.
+	int ptySlaveSd; //!< @brief pty slave kept open, so the master does not hang up when the controller disconnects.
 	std::string serialPort;	//!< @brief tty name.
 	bool isPty; //!< @brief true if serial is pseudo terminal.
 
@@ -78,6 +79,14 @@ public:
 	*/
 	int read();
 	/**
+	* @brief Reads up to size bytes of incoming serial data with a single system call.
+	*
+	* @param buffer to store the data in.
+	* @param size of the buffer.
+	* @return number of bytes read, 0 if no data is available or -1 on error.
+	*/
+	int read(uint8_t *buffer, size_t size);
+	/**
 	* @brief Writes a single byte to the serial port.
 	*
 	* @param b byte to write.
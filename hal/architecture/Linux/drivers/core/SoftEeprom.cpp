@@ -23,15 +23,25 @@
 #include <sys/stat.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
 #include "log.h"
 #include "SoftEeprom.h"
 
-SoftEeprom::SoftEeprom() : _length(0), _fileName(NULL), _values(NULL)
+SoftEeprom::SoftEeprom() : _length(0), _fileName(NULL), _values(NULL), _syncInterval(0),
+	_generation(0), _writtenGeneration(0), _dirty(false), _stop(false), _threadRunning(false)
 {
+	initLocks();
 }
 
-SoftEeprom::SoftEeprom(const SoftEeprom& other)
+SoftEeprom::SoftEeprom(const SoftEeprom& other) : _syncInterval(other._syncInterval),
+	_generation(0), _writtenGeneration(0), _dirty(false), _stop(false), _threadRunning(false)
 {
+	initLocks();
+
 	_fileName = strdup(other._fileName);
 
 	_length = other._length;
@@ -44,9 +54,19 @@ SoftEeprom::SoftEeprom(const SoftEeprom& other)
 SoftEeprom::~SoftEeprom()
 {
 	destroy();
+	pthread_cond_destroy(&_cond);
+	pthread_mutex_destroy(&_fileMutex);
+	pthread_mutex_destroy(&_mutex);
 }
 
-int SoftEeprom::init(const char *fileName, size_t length)
+void SoftEeprom::initLocks()
+{
+	pthread_mutex_init(&_mutex, NULL);
+	pthread_mutex_init(&_fileMutex, NULL);
+	pthread_cond_init(&_cond, NULL);
+}
+
+int SoftEeprom::init(const char *fileName, size_t length, unsigned int syncInterval)
 {
 	struct stat fileInfo;
 
@@ -60,21 +80,19 @@ int SoftEeprom::init(const char *fileName, size_t length)
 
 	_length = length;
 	_values = new uint8_t[_length];
+	_syncInterval = syncInterval;
 
 	if (stat(_fileName, &fileInfo) != 0) {
 		//File does not exist.  Create it.
 		logInfo("EEPROM file %s does not exist, creating new file.\n", _fileName);
-		std::ofstream myFile(_fileName, std::ios::out | std::ios::binary);
-		if (!myFile) {
-			logError("Unable to create config file %s.\n", _fileName);
-			return -1;
-		}
 		// Fill the eeprom with 1s
 		for (size_t i = 0; i < _length; ++i) {
 			_values[i] = 0xFF;
 		}
-		myFile.write((const char*)_values, _length);
-		myFile.close();
+		if (writeSnapshot(_values) != 0) {
+			logError("Unable to create config file %s.\n", _fileName);
+			return -1;
+		}
 	} else if (fileInfo.st_size < 0 || (size_t)fileInfo.st_size != _length) {
 		logError("EEPROM file %s is not the correct size of %zu.  Please remove the file and a new one will be created.\n",
 		         _fileName, _length);
@@ -96,6 +114,9 @@ int SoftEeprom::init(const char *fileName, size_t length)
 
 void SoftEeprom::destroy()
 {
+	stopThread();
+	(void)flush();
+
 	if (_values) {
 		delete[] _values;
 		_values = NULL;
@@ -117,7 +138,9 @@ void SoftEeprom::readBlock(void* buf, void* addr, size_t length)
 	}
 
 	if (offs + length <= _length) {
+		pthread_mutex_lock(&_mutex);
 		memcpy(buf, _values+offs, length);
+		pthread_mutex_unlock(&_mutex);
 	}
 }
 
@@ -131,20 +154,37 @@ void SoftEeprom::writeBlock(void* buf, void* addr, size_t length)
 	}
 
 	if (offs + length <= _length) {
+		pthread_mutex_lock(&_mutex);
 		if (memcmp(_values+offs, buf, length) == 0) {
+			pthread_mutex_unlock(&_mutex);
 			return;
 		}
 
 		memcpy(_values+offs, buf, length);
+		_dirty = true;
 
-		std::ofstream myFile(_fileName, std::ios::out | std::ios::in | std::ios::binary);
-		if (!myFile) {
-			logError("Unable to write config to file %s.\n", _fileName);
-			return;
+		if (_syncInterval && !_threadRunning) {
+			// termination signals are handled by the main thread, which flushes the changes
+			sigset_t mask, oldMask;
+			sigemptyset(&mask);
+			sigaddset(&mask, SIGINT);
+			sigaddset(&mask, SIGTERM);
+			pthread_sigmask(SIG_BLOCK, &mask, &oldMask);
+			_stop = false;
+			if (pthread_create(&_thread, NULL, syncThread, this) == 0) {
+				_threadRunning = true;
+			} else {
+				logError("Unable to create EEPROM sync thread, writing changes immediately.\n");
+				_syncInterval = 0;
+			}
+			pthread_sigmask(SIG_SETMASK, &oldMask, NULL);
+		}
+		pthread_cond_signal(&_cond);
+		pthread_mutex_unlock(&_mutex);
+
+		if (!_syncInterval) {
+			(void)flush();
 		}
-		myFile.seekp(offs);
-		myFile.write((const char*)buf, length);
-		myFile.close();
 	}
 }
 
@@ -163,15 +203,152 @@ void SoftEeprom::writeByte(int addr, uint8_t value)
 	}
 }
 
+int SoftEeprom::flush()
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&_mutex);
+	if (!_dirty || !_values) {
+		pthread_mutex_unlock(&_mutex);
+		return 0;
+	}
+	// write a copy, writers are not blocked by file I/O
+	uint8_t *snapshot = new uint8_t[_length];
+	memcpy(snapshot, _values, _length);
+	const uint32_t generation = ++_generation;
+	_dirty = false;
+	pthread_mutex_unlock(&_mutex);
+
+	pthread_mutex_lock(&_fileMutex);
+	// a concurrent flush may already have written newer values
+	if ((int32_t)(generation - _writtenGeneration) > 0) {
+		if (writeSnapshot(snapshot) == 0) {
+			_writtenGeneration = generation;
+		} else {
+			ret = -1;
+		}
+	}
+	pthread_mutex_unlock(&_fileMutex);
+	delete[] snapshot;
+
+	if (ret != 0) {
+		logError("Unable to write config to file %s.\n", _fileName);
+		pthread_mutex_lock(&_mutex);
+		_dirty = true;
+		pthread_mutex_unlock(&_mutex);
+	}
+
+	return ret;
+}
+
+int SoftEeprom::writeSnapshot(const uint8_t *values)
+{
+	const size_t nameLength = strlen(_fileName);
+	char *tmpName = new char[nameLength + 5];
+	memcpy(tmpName, _fileName, nameLength);
+	memcpy(tmpName + nameLength, ".tmp", 5);
+
+	int fd = open(tmpName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+	if (fd < 0) {
+		logError("%s: %s\n", tmpName, strerror(errno));
+		delete[] tmpName;
+		return -1;
+	}
+
+	size_t written = 0;
+	while (written < _length) {
+		const ssize_t ret = write(fd, values + written, _length - written);
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		}
+		if (ret <= 0) {
+			break;
+		}
+		written += ret;
+	}
+	if (written != _length || fsync(fd) != 0) {
+		logError("%s: %s\n", tmpName, strerror(errno));
+		close(fd);
+		unlink(tmpName);
+		delete[] tmpName;
+		return -1;
+	}
+	close(fd);
+
+	// readers see either the old or the new file, never a partial write
+	if (rename(tmpName, _fileName) != 0) {
+		logError("%s: %s\n", _fileName, strerror(errno));
+		unlink(tmpName);
+		delete[] tmpName;
+		return -1;
+	}
+	delete[] tmpName;
+
+	// persist the rename
+	char *dirName = strdup(_fileName);
+	if (dirName) {
+		fd = open(dirname(dirName), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (fd >= 0) {
+			(void)fsync(fd);
+			close(fd);
+		}
+		free(dirName);
+	}
+
+	return 0;
+}
+
+void *SoftEeprom::syncThread(void *arg)
+{
+	SoftEeprom *eeprom = static_cast<SoftEeprom *>(arg);
+
+	pthread_mutex_lock(&eeprom->_mutex);
+	while (!eeprom->_stop) {
+		if (!eeprom->_dirty) {
+			pthread_cond_wait(&eeprom->_cond, &eeprom->_mutex);
+			continue;
+		}
+
+		// collect further changes into the same snapshot
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += eeprom->_syncInterval;
+		while (!eeprom->_stop &&
+		        pthread_cond_timedwait(&eeprom->_cond, &eeprom->_mutex, &deadline) != ETIMEDOUT);
+
+		pthread_mutex_unlock(&eeprom->_mutex);
+		(void)eeprom->flush();
+		pthread_mutex_lock(&eeprom->_mutex);
+	}
+	pthread_mutex_unlock(&eeprom->_mutex);
+
+	return NULL;
+}
+
+void SoftEeprom::stopThread()
+{
+	pthread_mutex_lock(&_mutex);
+	if (!_threadRunning) {
+		pthread_mutex_unlock(&_mutex);
+		return;
+	}
+	_stop = true;
+	pthread_cond_signal(&_cond);
+	pthread_mutex_unlock(&_mutex);
+
+	pthread_join(_thread, NULL);
+	_threadRunning = false;
+}
+
 SoftEeprom& SoftEeprom::operator=(const SoftEeprom& other)
 {
 	if (this != &other) {
-		delete[] _values;
-		free(_fileName);
+		destroy();
 
 		_fileName = strdup(other._fileName);
 
 		_length = other._length;
+		_syncInterval = other._syncInterval;
 		_values = new uint8_t[_length];
 		for (size_t i = 0; i < _length; ++i) {
 			_values[i] = other._values[i];
@@ -20,12 +20,16 @@
 /**
 * This a software emulation of EEPROM that uses a file for data storage.
 * A copy of the eeprom values are also held in memory for faster reading.
+* Writes only change the memory copy, a background thread collects them and
+* replaces the file with a new snapshot after the sync interval.
 */
 
 #ifndef SoftEeprom_h
 #define SoftEeprom_h
 
 #include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
 
 /**
  * SoftEeprom class
@@ -51,9 +55,11 @@ public:
 	 *
 	 * @param fileName filepath where the data is saved.
 	 * @param length eeprom size in bytes.
+	 * @param syncInterval seconds changes are collected before writing the file,
+	 * 0 writes the file on every change.
 	 * @return 0 if SUCCESS or -1 if FAILURE.
 	 */
-	int init(const char *fileName, size_t length);
+	int init(const char *fileName, size_t length, unsigned int syncInterval = 0);
 	/**
 	 * @brief Clear all allocated memory variables.
 	 *
@@ -89,6 +95,14 @@ public:
 	 * @param value to write.
 	 */
 	void writeByte(int addr, uint8_t value);
+	/**
+	 * @brief Write pending changes to the eeprom file.
+	 *
+	 * The file is replaced atomically, it holds either the old or the new values.
+	 *
+	 * @return 0 if SUCCESS or -1 if FAILURE.
+	 */
+	int flush();
 	/**
 	 * @brief Overloaded assign operator.
 	 *
@@ -99,6 +113,21 @@ private:
 	size_t _length; //!< @brief Eeprom max size.
 	char *_fileName; //!< @brief file where the eeprom values are stored.
 	uint8_t *_values; //!< @brief copy of the eeprom values held in memory for a faster reading.
+	unsigned int _syncInterval; //!< @brief seconds changes are collected before writing the file.
+	uint32_t _generation; //!< @brief number of snapshots taken.
+	uint32_t _writtenGeneration; //!< @brief snapshot currently in the file.
+	bool _dirty; //!< @brief values changed since the last snapshot.
+	bool _stop; //!< @brief request the sync thread to exit.
+	bool _threadRunning; //!< @brief sync thread started.
+	pthread_t _thread; //!< @brief sync thread.
+	pthread_mutex_t _mutex; //!< @brief guards the values and flags.
+	pthread_mutex_t _fileMutex; //!< @brief serializes snapshot writers.
+	pthread_cond_t _cond; //!< @brief signals new changes or stop to the sync thread.
+
+	void initLocks();
+	void stopThread();
+	int writeSnapshot(const uint8_t *values);
+	static void *syncThread(void *arg);
 };
 
 #endif
@@ -18,7 +18,11 @@
  */
 
 #include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/ioctl.h>
 #include "StdInOutStream.h"
+#include "EventLoop.h"
 
 void StdInOutStream::begin(int baud)
 {
@@ -27,12 +31,32 @@ void StdInOutStream::begin(int baud)
 
 int StdInOutStream::available()
 {
-	return 1;
+	static bool watched = false;
+	int count = 0;
+
+	if (!watched) {
+		// someone reads stdin, wake the main loop on input instead of waiting for its timeout
+		watched = true;
+		(void)EventLoop.add(STDIN_FILENO);
+	}
+	if (ioctl(STDIN_FILENO, FIONREAD, &count) < 0) {
+		return 0;
+	}
+	if (count == 0) {
+		struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+		if (poll(&pfd, 1, 0) > 0) {
+			// readable without data: end of input, stop waking the main loop
+			EventLoop.remove(STDIN_FILENO);
+		}
+	}
+	return count;
 }
 
 int StdInOutStream::read()
 {
-	return getchar();
+	unsigned char c;
+	// bypass stdio buffering, available() only sees data not yet read from the fd
+	return ::read(STDIN_FILENO, &c, 1) == 1 ? c : -1;
 }
 
 size_t StdInOutStream::write(uint8_t b)
@@ -40,6 +64,11 @@ size_t StdInOutStream::write(uint8_t b)
 	return (size_t)::printf("%c", b);
 }
 
+size_t StdInOutStream::write(const uint8_t *buffer, size_t size)
+{
+	return ::fwrite(buffer, 1, size, stdout);
+}
+
 int StdInOutStream::peek()
 {
 	return -1;
@@ -39,15 +39,17 @@ public:
 	 */
 	void begin(int baud);
 	/**
-	 * @brief This function does nothing.
+	 * @brief Get the number of bytes available for reading from stdin.
+	 *
+	 * The first call registers stdin with the EventLoop, so input wakes up the main loop.
 	 *
-	 * @return always returns 1.
+	 * @return number of bytes that can be read without blocking.
 	 */
 	int available();
 	/**
-	 * @brief Reads 1 key pressed from the keyboard.
+	 * @brief Reads 1 byte from stdin.
 	 *
-	 * @return key character pressed cast to an int.
+	 * @return byte read cast to an int, -1 if error or end of input.
 	 */
 	int read();
 	/**
@@ -57,6 +59,14 @@ public:
 	 * @return -1 if error else, number of bytes written.
 	 */
 	size_t write(uint8_t b);
+	/**
+	 * @brief Writes a buffer to stdout.
+	 *
+	 * @param buffer to write.
+	 * @param size of the buffer.
+	 * @return number of bytes written.
+	 */
+	size_t write(const uint8_t *buffer, size_t size);
 	/**
 	 * @brief Not supported.
 	 *
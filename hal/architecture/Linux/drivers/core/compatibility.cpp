@@ -25,7 +25,11 @@
 // For millis()
 static unsigned long millis_at_start = 0;
 
-void yield(void) {}
+void yield(void)
+{
+	// busy waits on an interrupt flag, e.g. a radio waiting for TX done, need the handlers to run
+	interruptsPoll();
+}
 
 unsigned long millis(void)
 {
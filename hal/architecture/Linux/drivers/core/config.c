@@ -55,9 +55,11 @@ int config_parse(const char *config_file)
 	conf.syslog = 0;
 	conf.eeprom_file = NULL;
 	conf.eeprom_size = 0;
+	conf.eeprom_sync_interval = 10;
 	conf.soft_hmac_key = NULL;
 	conf.soft_serial_key = NULL;
 	conf.aes_key = NULL;
+	conf.firmware_dir = NULL;
 
 	while (fgets(buf, 1024, fptr)) {
 		if (buf[0] != '#' && buf[0] != 10 && buf[0] != 13) {
@@ -148,6 +150,17 @@ int config_parse(const char *config_file)
 						return -1;
 					}
 				}
+			} else if (!strncmp(buf, "eeprom_sync_interval=", 21)) {
+				if (_config_parse_int(&(buf[21]), "eeprom_sync_interval", &conf.eeprom_sync_interval)) {
+					fclose(fptr);
+					return -1;
+				} else {
+					if (conf.eeprom_sync_interval < 0) {
+						logError("eeprom_sync_interval value must not be negative in configuration.\n");
+						fclose(fptr);
+						return -1;
+					}
+				}
 			} else if (!strncmp(buf, "soft_hmac_key=", 14)) {
 				if (_config_parse_string(&(buf[14]), "soft_hmac_key", &conf.soft_hmac_key)) {
 					fclose(fptr);
@@ -163,6 +176,11 @@ int config_parse(const char *config_file)
 					fclose(fptr);
 					return -1;
 				}
+			} else if (!strncmp(buf, "firmware_dir=", 13)) {
+				if (_config_parse_string(&(buf[13]), "firmware_dir", &conf.firmware_dir)) {
+					fclose(fptr);
+					return -1;
+				}
 			} else {
 				logWarning("Unknown config option \"%s\".\n", buf);
 			}
@@ -208,6 +226,9 @@ void config_cleanup(void)
 	if (conf.aes_key) {
 		free(conf.aes_key);
 	}
+	if (conf.firmware_dir) {
+		free(conf.firmware_dir);
+	}
 }
 
 int _config_create(const char *config_file)
@@ -238,6 +259,9 @@ int _config_create(const char *config_file)
 	                            "# EEPROM settings\n" \
 	                            "eeprom_file=/etc/mysensors.eeprom\n" \
 	                            "eeprom_size=1024\n" \
+	                            "# Seconds changes are collected before they are written\n" \
+	                            "# to eeprom_file, 0 writes every change immediately.\n" \
+	                            "eeprom_sync_interval=10\n" \
 	                            "\n" \
 	                            "# Software signing settings\n" \
 	                            "# Note: The gateway must have been built with signing\n" \
@@ -256,7 +280,12 @@ int _config_create(const char *config_file)
 	                            "#\n" \
 	                            "# To generate a AES key run mysgw with: --gen-aes-key\n" \
 	                            "# copy the new key in the line below and uncomment it.\n" \
-	                            "#aes_key=\n";
+	                            "#aes_key=\n" \
+	                            "\n" \
+	                            "# OTA firmware settings\n" \
+	                            "# Directory with firmware images (TYPE_VERSION.hex or\n" \
+	                            "# TYPE_VERSION.bin) the gateway serves to nodes itself.\n" \
+	                            "#firmware_dir=/etc/mysensors/firmware\n";
 
 	myFile = fopen(config_file, "w");
 	if (!myFile) {
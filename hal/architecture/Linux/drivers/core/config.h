@@ -36,9 +36,11 @@ struct config {
 	int syslog;
 	char *eeprom_file;
 	int eeprom_size;
+	int eeprom_sync_interval;
 	char *soft_hmac_key;
 	char *soft_serial_key;
 	char *aes_key;
+	char *firmware_dir;
 } conf;
 
 int config_parse(const char *config_file);
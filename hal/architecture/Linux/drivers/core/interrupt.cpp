@@ -33,16 +33,192 @@
 #include <stropts.h>
 #include <errno.h>
 #include <sched.h>
+#include <time.h>
 #include "log.h"
+#include "EventLoop.h"
+#if defined(LINUX_GPIO_CHARDEV)
+#include <linux/gpio.h>
+#include "GPIO.h"
+#endif
+
+volatile bool interruptsEnabled = true;
+static pthread_mutex_t intMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Time of the last edge per pin, nanoseconds of CLOCK_MONOTONIC
+static uint64_t edgeTimestamps[64] = {0};
+
+#if defined(LINUX_GPIO_CHARDEV)
+
+#define INTERRUPT_MAX_EVENTS 16	//!< Edge events read per handler call
+
+// Interrupt handlers, run from the main event loop
+static void (*intFuncs[64])() = {NULL};
+// Line file descriptors, owned by GPIO
+static int lineFds[64];
+// Edges that arrived while interrupts were disabled
+static bool intPending[64] = {false};
+static bool intPendingAny = false;
+// Set while a handler runs from interruptsPoll(), prevents nested dispatching
+static bool intPolling = false;
+
+static void interruptDispatch(int fd)
+{
+	struct gpio_v2_line_event events[INTERRUPT_MAX_EVENTS];
+	int gpioPin = -1;
+
+	for (int i = 0; i < 64; i++) {
+		if (intFuncs[i] != NULL && lineFds[i] == fd) {
+			gpioPin = i;
+			break;
+		}
+	}
+
+	const ssize_t len = read(fd, events, sizeof(events));
+	if (len < 0) {
+		if (errno != EAGAIN) {
+			logError("Interrupt handler error: %s\n", strerror(errno));
+		}
+		return;
+	}
+	if (gpioPin == -1) {
+		return;
+	}
+
+	for (size_t i = 0; i < (size_t)len / sizeof(events[0]); i++) {
+		pthread_mutex_lock(&intMutex);
+		// kernel timestamp of the edge
+		edgeTimestamps[gpioPin] = events[i].timestamp_ns;
+		const bool enabled = interruptsEnabled;
+		if (!enabled) {
+			intPending[gpioPin] = true;
+			intPendingAny = true;
+		}
+		pthread_mutex_unlock(&intMutex);
+		if (enabled && intFuncs[gpioPin] != NULL) {
+			intFuncs[gpioPin]();
+		}
+	}
+}
+
+void interruptsPoll(void)
+{
+	struct pollfd fds[64];
+	nfds_t count = 0;
+
+	if (intPolling) {
+		return;
+	}
+	for (int i = 0; i < 64; i++) {
+		if (intFuncs[i] != NULL) {
+			fds[count].fd = lineFds[i];
+			fds[count].events = POLLIN;
+			fds[count].revents = 0;
+			count++;
+		}
+	}
+	if (!count || poll(fds, count, 0) <= 0) {
+		return;
+	}
+	intPolling = true;
+	for (nfds_t i = 0; i < count; i++) {
+		if (fds[i].revents & POLLIN) {
+			interruptDispatch(fds[i].fd);
+		}
+	}
+	intPolling = false;
+}
+
+void attachInterrupt(uint8_t gpioPin, void (*func)(), uint8_t mode)
+{
+	bool rising, falling;
+
+	if (gpioPin >= 64) {
+		logError("attachInterrupt: Invalid pin %d\n", gpioPin);
+		return;
+	}
+
+	switch (mode) {
+	case CHANGE:
+		rising = falling = true;
+		break;
+	case FALLING:
+		rising = false;
+		falling = true;
+		break;
+	case RISING:
+		rising = true;
+		falling = false;
+		break;
+	case NONE:
+		rising = falling = false;
+		break;
+	default:
+		logError("attachInterrupt: Invalid mode\n");
+		return;
+	}
+
+	const int fd = GPIO.requestEdgeEvents(gpioPin, rising, falling);
+	if (fd == -1) {
+		logError("attachInterrupt: Unable to request edge events for pin %d\n", gpioPin);
+		exit(1);
+	}
+
+	pthread_mutex_lock(&intMutex);
+	intPending[gpioPin] = false;
+	pthread_mutex_unlock(&intMutex);
+	lineFds[gpioPin] = fd;
+	intFuncs[gpioPin] = func;
+
+	if (!EventLoop.add(fd, interruptDispatch)) {
+		logError("attachInterrupt: Unable to watch pin %d\n", gpioPin);
+		exit(1);
+	}
+}
+
+void detachInterrupt(uint8_t gpioPin)
+{
+	if (gpioPin >= 64 || intFuncs[gpioPin] == NULL) {
+		return;
+	}
+
+	EventLoop.remove(lineFds[gpioPin]);
+	intFuncs[gpioPin] = NULL;
+	// Keep the line as plain input
+	(void)GPIO.requestEdgeEvents(gpioPin, false, false);
+}
+
+void interrupts()
+{
+	bool pending;
+
+	pthread_mutex_lock(&intMutex);
+	interruptsEnabled = true;
+	pending = intPendingAny;
+	intPendingAny = false;
+	pthread_mutex_unlock(&intMutex);
+
+	if (!pending) {
+		return;
+	}
+	// Deliver the edges that arrived while interrupts were disabled
+	for (int i = 0; i < 64; i++) {
+		pthread_mutex_lock(&intMutex);
+		const bool run = intPending[i] && interruptsEnabled;
+		intPending[i] = false;
+		pthread_mutex_unlock(&intMutex);
+		if (run && intFuncs[i] != NULL) {
+			intFuncs[i]();
+		}
+	}
+}
+
+#else /* Else part of LINUX_GPIO_CHARDEV */
 
 struct ThreadArgs {
 	void (*func)();
 	int gpioPin;
 };
 
-volatile bool interruptsEnabled = true;
-static pthread_mutex_t intMutex = PTHREAD_MUTEX_INITIALIZER;
-
 static pthread_t *threadIds[64] = {NULL};
 
 // sysFds:
@@ -77,6 +253,7 @@ void *interruptHandler(void *args)
 {
 	int fd;
 	struct pollfd polls;
+	struct timespec now;
 	char c;
 	struct ThreadArgs *arguments = (struct ThreadArgs *)args;
 	int gpioPin = arguments->gpioPin;
@@ -101,6 +278,7 @@ void *interruptHandler(void *args)
 			logError("Error waiting for interrupt: %s\n", strerror(errno));
 			break;
 		}
+		clock_gettime(CLOCK_MONOTONIC, &now);
 		// Do a dummy read to clear the interrupt
 		//	A one character read appars to be enough.
 		if (lseek (fd, 0, SEEK_SET) < 0) {
@@ -113,9 +291,12 @@ void *interruptHandler(void *args)
 		}
 		// Call user function.
 		pthread_mutex_lock(&intMutex);
+		edgeTimestamps[gpioPin] = (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
 		if (interruptsEnabled) {
 			pthread_mutex_unlock(&intMutex);
 			func();
+			// let the main loop process what the handler did
+			EventLoop.wakeup();
 		} else {
 			pthread_mutex_unlock(&intMutex);
 		}
@@ -244,9 +425,28 @@ void interrupts()
 	pthread_mutex_unlock(&intMutex);
 }
 
+void interruptsPoll(void)
+{
+	// handlers run from their own threads
+}
+
+#endif /* End of LINUX_GPIO_CHARDEV */
+
 void noInterrupts()
 {
 	pthread_mutex_lock(&intMutex);
 	interruptsEnabled = false;
 	pthread_mutex_unlock(&intMutex);
 }
+
+uint64_t interruptTimestamp(uint8_t gpioPin)
+{
+	uint64_t timestamp = 0;
+
+	if (gpioPin < 64) {
+		pthread_mutex_lock(&intMutex);
+		timestamp = edgeTimestamps[gpioPin];
+		pthread_mutex_unlock(&intMutex);
+	}
+	return timestamp;
+}
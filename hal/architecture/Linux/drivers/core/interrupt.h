@@ -37,6 +37,12 @@ void attachInterrupt(uint8_t gpioPin, void(*func)(), uint8_t mode);
 void detachInterrupt(uint8_t gpioPin);
 void interrupts();
 void noInterrupts();
+// Runs the handlers of pending edges without blocking. Needed with the GPIO character device,
+// where handlers otherwise only run from EventLoop.wait(). Called from yield().
+void interruptsPoll(void);
+// Time of the last edge on gpioPin in nanoseconds of CLOCK_MONOTONIC, 0 if none yet.
+// Taken by the kernel with the GPIO character device, by the handler thread with sysfs.
+uint64_t interruptTimestamp(uint8_t gpioPin);
 
 #ifdef __cplusplus
 }
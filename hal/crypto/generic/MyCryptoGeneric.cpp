@@ -22,24 +22,47 @@
 void SHA256HMAC(uint8_t *dest, const uint8_t *key, size_t keyLength, const uint8_t *data,
                 size_t dataLength)
 {
-	SHA256HMACInit(key, keyLength);
-	SHA256HMACAdd(data, dataLength);
-	SHA256HMACResult(dest);
+	_SHA256HMACcontext_t ctx;
+	SHA256HMACInit(&ctx, key, keyLength);
+	SHA256HMACAdd(&ctx, data, dataLength);
+	SHA256HMACResult(&ctx, dest);
 }
 
-AES _aes;
+void SHA256HMACKeyed(uint8_t *dest, const _SHA256HMACcontext_t *keyed, const uint8_t *data,
+                     size_t dataLength)
+{
+	_SHA256HMACcontext_t ctx = *keyed;
+	SHA256HMACAdd(&ctx, data, dataLength);
+	SHA256HMACResult(&ctx, dest);
+}
+
+_AES128context_t _aes;
 
 void AES128CBCInit(const uint8_t *key)
 {
-	_aes.set_key((byte *)key, 16);
+	AES128Init(&_aes, key);
 }
 
 void AES128CBCEncrypt(uint8_t *iv, uint8_t *buffer, const size_t dataLength)
 {
-	_aes.cbc_encrypt((byte *)buffer, (byte *)buffer, dataLength / 16, iv);
+	for (size_t offset = 0; offset + AES128_BLOCK_LENGTH <= dataLength; offset += AES128_BLOCK_LENGTH) {
+		for (uint8_t i = 0; i < AES128_BLOCK_LENGTH; i++) {
+			iv[i] ^= buffer[offset + i];
+		}
+		AES128Encrypt(&_aes, iv, iv);
+		(void)memcpy((void *)&buffer[offset], (const void *)iv, AES128_BLOCK_LENGTH);
+	}
 }
 
 void AES128CBCDecrypt(uint8_t *iv, uint8_t *buffer, const size_t dataLength)
 {
-	_aes.cbc_decrypt((byte *)buffer, (byte *)buffer, dataLength / 16, iv);
+	uint8_t cipher[AES128_BLOCK_LENGTH];
+	for (size_t offset = 0; offset + AES128_BLOCK_LENGTH <= dataLength; offset += AES128_BLOCK_LENGTH) {
+		(void)memcpy((void *)cipher, (const void *)&buffer[offset], AES128_BLOCK_LENGTH);
+		AES128Decrypt(&_aes, cipher, &buffer[offset]);
+		for (uint8_t i = 0; i < AES128_BLOCK_LENGTH; i++) {
+			buffer[offset + i] ^= iv[i];
+		}
+		(void)memcpy((void *)iv, (const void *)cipher, AES128_BLOCK_LENGTH);
+	}
 }
@@ -21,8 +21,24 @@
 #define MyCryptoGeneric_h
 
 #include "hal/crypto/MyCryptoHAL.h"
-#include "hal/crypto/generic/drivers/AES/AES.cpp"
+#include "hal/crypto/generic/drivers/AES128/aes128.cpp"
 #include "hal/crypto/generic/drivers/SHA256/sha256.cpp"
 #include "hal/crypto/generic/drivers/HMAC_SHA256/hmac_sha256.cpp"
 
+#define MY_CRYPTO_SHA256HMAC_KEYED	//!< SHA256HMACKeyed() available
+
+/**
+* @brief SHA256 HMAC calculation with a keyed context
+*
+* Saves hashing the key for every HMAC if the caller keeps a context initialized by
+* @ref SHA256HMACInit() for its key. The returned hash size is always 32 bytes.
+*
+* @param dest Buffer to return 32-byte hash.
+* @param keyed Context after SHA256HMACInit(), not modified.
+* @param data Buffer with data to add.
+* @param dataLength Size of data buffer.
+*/
+void SHA256HMACKeyed(uint8_t *dest, const _SHA256HMACcontext_t *keyed, const uint8_t *data,
+                     size_t dataLength);
+
 #endif
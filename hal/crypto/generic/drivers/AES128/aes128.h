@@ -0,0 +1,61 @@
+/*
+* The MySensors Arduino library handles the wireless radio link and protocol
+* between your home built sensors/actuators and HA controller of choice.
+* The sensors forms a self healing radio network with optional repeaters. Each
+* repeater and gateway builds a routing tables in EEPROM which keeps track of the
+* network topology allowing messages to be routed to nodes.
+*
+* Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+* Copyright (C) 2013-2020 Sensnology AB
+* Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+*
+* Documentation: http://www.mysensors.org
+* Support Forum: http://forum.mysensors.org
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* version 2 as published by the Free Software Foundation.
+*
+*/
+
+#ifndef _AES128_H_
+#define _AES128_H_
+
+#define AES128_BLOCK_LENGTH 16	//!< AES128_BLOCK_LENGTH
+#define AES128_ROUNDS 10		//!< AES128_ROUNDS
+
+/**
+* @brief AES128 key schedule
+*
+* Round keys are stored in byte order, the decryption keys in the order of the equivalent
+* inverse cipher. The same schedule is used by the table driven and the hardware accelerated code.
+*/
+typedef struct {
+	uint8_t encryptKeys[AES128_ROUNDS + 1][AES128_BLOCK_LENGTH];	//!< encryption round keys
+	uint8_t decryptKeys[AES128_ROUNDS + 1][AES128_BLOCK_LENGTH];	//!< decryption round keys
+} _AES128context_t;
+
+/**
+* @brief Expand the key schedule
+* @param ctx context
+* @param key AES key, 16 bytes
+*/
+void AES128Init(_AES128context_t *ctx, const uint8_t *key);
+
+/**
+* @brief Encrypt one block, in and out may overlap
+* @param ctx context
+* @param in plain text, 16 bytes
+* @param out cipher text, 16 bytes
+*/
+void AES128Encrypt(const _AES128context_t *ctx, const uint8_t *in, uint8_t *out);
+
+/**
+* @brief Decrypt one block, in and out may overlap
+* @param ctx context
+* @param in cipher text, 16 bytes
+* @param out plain text, 16 bytes
+*/
+void AES128Decrypt(const _AES128context_t *ctx, const uint8_t *in, uint8_t *out);
+
+#endif
@@ -20,45 +20,44 @@
 
 #include "hmac_sha256.h"
 
-void SHA256HMACInit(const uint8_t *key, size_t keyLength)
+void SHA256HMACInit(_SHA256HMACcontext_t *ctx, const uint8_t *key, size_t keyLength)
 {
-	(void)memset((void *)&SHA256keyBuffer, 0x00, BLOCK_LENGTH);
+	uint8_t keyBuffer[BLOCK_LENGTH];
+	(void)memset((void *)keyBuffer, 0x00, BLOCK_LENGTH);
 	if (keyLength > BLOCK_LENGTH) {
 		// Hash long keys
-		SHA256Init();
-		SHA256Add(key, keyLength);
-		SHA256Result(SHA256keyBuffer);
+		SHA256Init(&ctx->inner);
+		SHA256Add(&ctx->inner, key, keyLength);
+		SHA256Result(&ctx->inner, keyBuffer);
 	} else {
 		// Block length keys are used as is
-		(void)memcpy((void *)SHA256keyBuffer, (const void *)key, keyLength);
+		(void)memcpy((void *)keyBuffer, (const void *)key, keyLength);
 	}
-	// Start inner hash
-	SHA256Init();
+	// Hash the padded keys once, both fill exactly one block
 	for (uint8_t i = 0; i < BLOCK_LENGTH; i++) {
-		SHA256Add(SHA256keyBuffer[i] ^ HMAC_IPAD);
+		keyBuffer[i] ^= HMAC_IPAD;
 	}
+	SHA256Init(&ctx->inner);
+	SHA256Add(&ctx->inner, keyBuffer, BLOCK_LENGTH);
+	for (uint8_t i = 0; i < BLOCK_LENGTH; i++) {
+		keyBuffer[i] ^= HMAC_IPAD ^ HMAC_OPAD;
+	}
+	SHA256Init(&ctx->outer);
+	SHA256Add(&ctx->outer, keyBuffer, BLOCK_LENGTH);
+	(void)memset((void *)keyBuffer, 0x00, BLOCK_LENGTH);
 }
 
-void SHA256HMACAdd(const uint8_t data)
-{
-	SHA256Add(data);
-}
-
-void SHA256HMACAdd(const uint8_t *data, size_t dataLength)
+void SHA256HMACAdd(_SHA256HMACcontext_t *ctx, const uint8_t *data, size_t dataLength)
 {
-	SHA256Add(data, dataLength);
+	SHA256Add(&ctx->inner, data, dataLength);
 }
 
-void SHA256HMACResult(uint8_t *dest)
+void SHA256HMACResult(_SHA256HMACcontext_t *ctx, uint8_t *dest)
 {
 	uint8_t innerHash[HASH_LENGTH];
 	// Complete inner hash
-	SHA256Result(innerHash);
+	SHA256Result(&ctx->inner, innerHash);
 	// Calculate outer hash
-	SHA256Init();
-	for (uint8_t i = 0; i < BLOCK_LENGTH; i++) {
-		SHA256Add(SHA256keyBuffer[i] ^ HMAC_OPAD);
-	}
-	SHA256Add(innerHash, HASH_LENGTH);
-	SHA256Result(dest);
-}
\ No newline at end of file
+	SHA256Add(&ctx->outer, innerHash, HASH_LENGTH);
+	SHA256Result(&ctx->outer, dest);
+}
@@ -24,5 +24,39 @@
 #define HMAC_IPAD 0x36	//!< HMAC_IPAD
 #define HMAC_OPAD 0x5c	//!< HMAC_OPAD
 
+/**
+* @brief SHA256 HMAC calculation context
+*
+* After @ref SHA256HMACInit() the context holds the keyed inner and outer states. Copy it
+* to calculate several HMACs with the same key without hashing the key again.
+*/
+typedef struct {
+	_SHA256context_t inner;	//!< inner hash, key ^ ipad followed by data
+	_SHA256context_t outer;	//!< outer hash, key ^ opad
+} _SHA256HMACcontext_t;
+
+/**
+* @brief Start a new HMAC calculation
+* @param ctx context
+* @param key Buffer with HMAC key.
+* @param keyLength Size of HMAC key.
+*/
+void SHA256HMACInit(_SHA256HMACcontext_t *ctx, const uint8_t *key, size_t keyLength);
+
+/**
+* @brief Add data to the HMAC
+* @param ctx context
+* @param data Buffer with data to add.
+* @param dataLength Size of data buffer.
+*/
+void SHA256HMACAdd(_SHA256HMACcontext_t *ctx, const uint8_t *data, size_t dataLength);
+
+/**
+* @brief Finish the HMAC calculation
+* @param ctx context
+* @param dest Buffer to return 32-byte HMAC.
+*/
+void SHA256HMACResult(_SHA256HMACcontext_t *ctx, uint8_t *dest);
+
 
 #endif
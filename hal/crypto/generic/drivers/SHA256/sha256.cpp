@@ -20,6 +20,17 @@
 
 #include "sha256.h"
 
+#if defined(__linux__) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA256_SHANI	//!< SHA extensions of x86 CPUs, selected at runtime
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__linux__) && defined(__ARM_NEON) &&\
+    (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define SHA256_ARMV8	//!< ARMv8 crypto extensions, selected at runtime
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#endif
+
 const uint32_t SHA256K[] PROGMEM = {
 	0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
 	0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
@@ -31,143 +42,255 @@ const uint32_t SHA256K[] PROGMEM = {
 	0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
 };
 
-const uint8_t SHA256InitState[] PROGMEM = {
-	0x67,0xe6,0x09,0x6a, // H0
-	0x85,0xae,0x67,0xbb, // H1
-	0x72,0xf3,0x6e,0x3c, // H2
-	0x3a,0xf5,0x4f,0xa5, // H3
-	0x7f,0x52,0x0e,0x51, // H4
-	0x8c,0x68,0x05,0x9b, // H5
-	0xab,0xd9,0x83,0x1f, // H6
-	0x19,0xcd,0xe0,0x5b  // H7
+const uint32_t SHA256InitState[] PROGMEM = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
 };
 
-_SHA256buffer_t SHA256buffer;
-uint8_t SHA256bufferOffset;
-_SHA256state_t SHA256state;
-uint32_t SHA256byteCount;
-uint8_t SHA256keyBuffer[BLOCK_LENGTH];
+uint32_t SHA256ror32(const uint32_t number, const uint8_t bits)
+{
+	return ((number << (32 - bits)) | (number >> bits));
+}
 
-void SHA256Init(void)
+uint32_t SHA256load32(const uint8_t *data)
 {
-	(void)memcpy_P((void *)&SHA256state.b, (const void *)&SHA256InitState, 32);
-	SHA256byteCount = 0;
-	SHA256bufferOffset = 0;
+	return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) |
+	       (uint32_t)data[3];
 }
 
-uint32_t SHA256ror32(const uint32_t number, const uint8_t bits)
+void SHA256store32(uint8_t *data, const uint32_t value)
 {
-	return ((number << (32 - bits)) | (number >> bits));
+	data[0] = (uint8_t)(value >> 24);
+	data[1] = (uint8_t)(value >> 16);
+	data[2] = (uint8_t)(value >> 8);
+	data[3] = (uint8_t)value;
 }
 
-void SHA256hashBlock(void)
+void SHA256hashBlocksGeneric(uint32_t *state, const uint8_t *data, size_t blocks)
 {
+	uint32_t w[16];
 	uint32_t a, b, c, d, e, f, g, h, t1, t2;
 
-	a = SHA256state.w[0];
-	b = SHA256state.w[1];
-	c = SHA256state.w[2];
-	d = SHA256state.w[3];
-	e = SHA256state.w[4];
-	f = SHA256state.w[5];
-	g = SHA256state.w[6];
-	h = SHA256state.w[7];
-
-	for (uint8_t i = 0; i < 64; i++) {
-		if (i >= 16) {
-			t1 = SHA256buffer.w[i & 15] + SHA256buffer.w[(i - 7) & 15];
-			t2 = SHA256buffer.w[(i - 2) & 15];
-			t1 += SHA256ror32(t2, 17) ^ SHA256ror32(t2, 19) ^ (t2 >> 10);
-			t2 = SHA256buffer.w[(i - 15) & 15];
-			t1 += SHA256ror32(t2, 7) ^ SHA256ror32(t2, 18) ^ (t2 >> 3);
-			SHA256buffer.w[i & 15] = t1;
+	while (blocks--) {
+		for (uint8_t i = 0; i < 16; i++) {
+			w[i] = SHA256load32(data + 4 * i);
+		}
+		a = state[0];
+		b = state[1];
+		c = state[2];
+		d = state[3];
+		e = state[4];
+		f = state[5];
+		g = state[6];
+		h = state[7];
+
+		for (uint8_t i = 0; i < 64; i++) {
+			if (i >= 16) {
+				t1 = w[i & 15] + w[(i - 7) & 15];
+				t2 = w[(i - 2) & 15];
+				t1 += SHA256ror32(t2, 17) ^ SHA256ror32(t2, 19) ^ (t2 >> 10);
+				t2 = w[(i - 15) & 15];
+				t1 += SHA256ror32(t2, 7) ^ SHA256ror32(t2, 18) ^ (t2 >> 3);
+				w[i & 15] = t1;
+			}
+			t1 = h;
+			t1 += SHA256ror32(e, 6) ^ SHA256ror32(e, 11) ^ SHA256ror32(e, 25); // ∑1(e)
+			t1 += g ^ (e & (g ^ f)); // Ch(e,f,g)
+			t1 += pgm_read_dword(SHA256K + i); // Ki
+			t1 += w[i & 15]; // Wi
+			t2 = SHA256ror32(a, 2) ^ SHA256ror32(a, 13) ^ SHA256ror32(a, 22); // ∑0(a)
+			t2 += ((b & c) | (a & (b | c))); // Maj(a,b,c)
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+		data += BLOCK_LENGTH;
+	}
+}
+
+#if defined(SHA256_SHANI)
+__attribute__((target("sha,sse4.1")))
+void SHA256hashBlocksSHANI(uint32_t *state, const uint8_t *data, size_t blocks)
+{
+	const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i msg[4];
+
+	// The round instructions keep the state as ABEF and CDGH
+	__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1);
+	__m128i cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B);
+	__m128i abef = _mm_alignr_epi8(tmp, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);
+
+	while (blocks--) {
+		const __m128i abefSave = abef;
+		const __m128i cdghSave = cdgh;
+		for (uint8_t i = 0; i < 4; i++) {
+			msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16 * i)), byteSwap);
+		}
+		// Four rounds per iteration, the message schedule is extended four words at a time
+		for (uint8_t i = 0; i < 16; i++) {
+			const __m128i wk = _mm_add_epi32(msg[i & 3], _mm_loadu_si128((const __m128i *)&SHA256K[4 * i]));
+			cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+			abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0E));
+			if (i < 12) {
+				tmp = _mm_add_epi32(_mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]),
+				                    _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4));
+				msg[i & 3] = _mm_sha256msg2_epu32(tmp, msg[(i + 3) & 3]);
+			}
 		}
-		t1 = h;
-		t1 += SHA256ror32(e, 6) ^ SHA256ror32(e, 11) ^ SHA256ror32(e, 25); // ∑1(e)
-		t1 += g ^ (e & (g ^ f)); // Ch(e,f,g)
-		t1 += pgm_read_dword(SHA256K + i); // Ki
-		t1 += SHA256buffer.w[i & 15]; // Wi
-		t2 = SHA256ror32(a, 2) ^ SHA256ror32(a, 13) ^ SHA256ror32(a, 22); // ∑0(a)
-		t2 += ((b & c) | (a & (b | c))); // Maj(a,b,c)
-		h = g;
-		g = f;
-		f = e;
-		e = d + t1;
-		d = c;
-		c = b;
-		b = a;
-		a = t1 + t2;
+		abef = _mm_add_epi32(abef, abefSave);
+		cdgh = _mm_add_epi32(cdgh, cdghSave);
+		data += BLOCK_LENGTH;
 	}
-	SHA256state.w[0] += a;
-	SHA256state.w[1] += b;
-	SHA256state.w[2] += c;
-	SHA256state.w[3] += d;
-	SHA256state.w[4] += e;
-	SHA256state.w[5] += f;
-	SHA256state.w[6] += g;
-	SHA256state.w[7] += h;
+
+	tmp = _mm_shuffle_epi32(abef, 0x1B);
+	cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+	_mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, cdgh, 0xF0));
+	_mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(cdgh, tmp, 8));
 }
 
-void SHA256addUncounted(const uint8_t data)
+bool SHA256hasAccel(void)
 {
-	SHA256buffer.b[SHA256bufferOffset ^ 3] = data;
-	SHA256bufferOffset++;
-	if (SHA256bufferOffset == BLOCK_LENGTH) {
-		SHA256hashBlock();
-		SHA256bufferOffset = 0;
+	uint32_t eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3)) {
+		return false;
 	}
+	return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA);
 }
+#define SHA256hashBlocksAccel SHA256hashBlocksSHANI	//!< accelerated block function
+#elif defined(SHA256_ARMV8)
+void SHA256hashBlocksARMV8(uint32_t *state, const uint8_t *data, size_t blocks)
+{
+	uint32x4_t msg[4];
+	uint32x4_t abcd = vld1q_u32(&state[0]);
+	uint32x4_t efgh = vld1q_u32(&state[4]);
 
+	while (blocks--) {
+		const uint32x4_t abcdSave = abcd;
+		const uint32x4_t efghSave = efgh;
+		for (uint8_t i = 0; i < 4; i++) {
+			msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+		}
+		// Four rounds per iteration, the message schedule is extended four words at a time
+		for (uint8_t i = 0; i < 16; i++) {
+			const uint32x4_t wk = vaddq_u32(msg[i & 3], vld1q_u32(&SHA256K[4 * i]));
+			if (i < 12) {
+				msg[i & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[i & 3], msg[(i + 1) & 3]),
+				                             msg[(i + 2) & 3], msg[(i + 3) & 3]);
+			}
+			const uint32x4_t tmp = abcd;
+			abcd = vsha256hq_u32(abcd, efgh, wk);
+			efgh = vsha256h2q_u32(efgh, tmp, wk);
+		}
+		abcd = vaddq_u32(abcd, abcdSave);
+		efgh = vaddq_u32(efgh, efghSave);
+		data += BLOCK_LENGTH;
+	}
+	vst1q_u32(&state[0], abcd);
+	vst1q_u32(&state[4], efgh);
+}
 
-void SHA256Add(const uint8_t data)
+bool SHA256hasAccel(void)
 {
-	SHA256byteCount++;
-	SHA256addUncounted(data);
+#if defined(__aarch64__)
+	return (getauxval(AT_HWCAP) & (1ul << 6)) != 0;	// HWCAP_SHA2
+#else
+	return (getauxval(AT_HWCAP2) & (1ul << 3)) != 0;	// HWCAP2_SHA2
+#endif
 }
+#define SHA256hashBlocksAccel SHA256hashBlocksARMV8	//!< accelerated block function
+#endif
+
+#if defined(SHA256hashBlocksAccel)
+void SHA256hashBlocksSelect(uint32_t *state, const uint8_t *data, size_t blocks);
+void (*SHA256hashBlocks)(uint32_t *, const uint8_t *, size_t) = SHA256hashBlocksSelect;
 
-void SHA256Add(const uint8_t *data, size_t dataLength)
+// Pick the block function on first use
+void SHA256hashBlocksSelect(uint32_t *state, const uint8_t *data, size_t blocks)
 {
-	while (dataLength--) {
-		SHA256Add(*data++);
+	SHA256hashBlocks = SHA256hasAccel() ? SHA256hashBlocksAccel : SHA256hashBlocksGeneric;
+	SHA256hashBlocks(state, data, blocks);
+}
+#else
+#define SHA256hashBlocks SHA256hashBlocksGeneric	//!< block function
+#endif
+
+void SHA256Init(_SHA256context_t *ctx)
+{
+	(void)memcpy_P((void *)ctx->state.w, (const void *)SHA256InitState, HASH_LENGTH);
+	ctx->byteCount = 0;
+	ctx->bufferOffset = 0;
+}
+
+void SHA256Add(_SHA256context_t *ctx, const uint8_t *data, size_t dataLength)
+{
+	ctx->byteCount += dataLength;
+	if (ctx->bufferOffset) {
+		// Complete the buffered block first
+		size_t length = BLOCK_LENGTH - ctx->bufferOffset;
+		if (length > dataLength) {
+			length = dataLength;
+		}
+		(void)memcpy((void *)&ctx->buffer.b[ctx->bufferOffset], (const void *)data, length);
+		ctx->bufferOffset += length;
+		data += length;
+		dataLength -= length;
+		if (ctx->bufferOffset < BLOCK_LENGTH) {
+			return;
+		}
+		SHA256hashBlocks(ctx->state.w, ctx->buffer.b, 1);
+		ctx->bufferOffset = 0;
 	}
+	// Hash complete blocks without copying them
+	const size_t blocks = dataLength / BLOCK_LENGTH;
+	if (blocks) {
+		SHA256hashBlocks(ctx->state.w, data, blocks);
+		data += blocks * BLOCK_LENGTH;
+		dataLength -= blocks * BLOCK_LENGTH;
+	}
+	(void)memcpy((void *)ctx->buffer.b, (const void *)data, dataLength);
+	ctx->bufferOffset = dataLength;
 }
 
-void SHA256Result(uint8_t *dest)
+void SHA256Result(_SHA256context_t *ctx, uint8_t *dest)
 {
 	// Pad to complete the last block
-	SHA256addUncounted(0x80);
-	while (SHA256bufferOffset != 56) {
-		SHA256addUncounted(0x00);
+	uint8_t offset = ctx->bufferOffset;
+	ctx->buffer.b[offset++] = 0x80;
+	if (offset > BLOCK_LENGTH - 8) {
+		(void)memset((void *)&ctx->buffer.b[offset], 0x00, BLOCK_LENGTH - offset);
+		SHA256hashBlocks(ctx->state.w, ctx->buffer.b, 1);
+		offset = 0;
 	}
+	(void)memset((void *)&ctx->buffer.b[offset], 0x00, BLOCK_LENGTH - 8 - offset);
+
+	// Append length in bits in the last 8 bytes
+	const uint64_t bitCount = ctx->byteCount << 3;
+	SHA256store32(&ctx->buffer.b[BLOCK_LENGTH - 8], (uint32_t)(bitCount >> 32));
+	SHA256store32(&ctx->buffer.b[BLOCK_LENGTH - 4], (uint32_t)bitCount);
+	SHA256hashBlocks(ctx->state.w, ctx->buffer.b, 1);
 
-	// Append length in the last 8 bytes
-	SHA256addUncounted(0); // We're only using 32 bit lengths
-	SHA256addUncounted(0); // But SHA-1 supports 64 bit lengths
-	SHA256addUncounted(0); // So zero pad the top bits
-	SHA256addUncounted(SHA256byteCount >> 29); // Shifting to multiply by 8
-	SHA256addUncounted(SHA256byteCount >> 21); // as SHA-1 supports bitstreams as well as
-	SHA256addUncounted(SHA256byteCount >> 13); // byte.
-	SHA256addUncounted(SHA256byteCount >> 5);
-	SHA256addUncounted(SHA256byteCount << 3);
-
-	// Swap byte order back
-	for (uint8_t i = 0; i<8; i++) {
-		uint32_t a, b;
-		a = SHA256state.w[i];
-		b = a << 24;
-		b |= (a << 8) & 0x00ff0000;
-		b |= (a >> 8) & 0x0000ff00;
-		b |= a >> 24;
-		SHA256state.w[i] = b;
+	for (uint8_t i = 0; i < 8; i++) {
+		SHA256store32(dest + 4 * i, ctx->state.w[i]);
 	}
-	(void)memcpy((void *)dest, (const void *)SHA256state.b, 32);
-	// Return pointer to hash (20 characters)
-	//return SHA256state.b;
 }
 
 void SHA256(uint8_t *dest, const uint8_t *data, size_t dataLength)
 {
-	SHA256Init();
-	SHA256Add(data, dataLength);
-	SHA256Result(dest);
+	_SHA256context_t ctx;
+	SHA256Init(&ctx);
+	SHA256Add(&ctx, data, dataLength);
+	SHA256Result(&ctx, dest);
 }
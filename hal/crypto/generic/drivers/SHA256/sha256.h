@@ -40,4 +40,37 @@ union _SHA256state_t {
 	uint32_t w[HASH_LENGTH / 4]; //!< SHA256 w
 };
 
+/**
+* @brief SHA256 calculation context
+*
+* Contexts are independent, several hashes can be calculated at the same time.
+*/
+typedef struct {
+	_SHA256state_t state;		//!< intermediate hash value
+	_SHA256buffer_t buffer;		//!< partial block not hashed yet
+	uint64_t byteCount;			//!< number of bytes added
+	uint8_t bufferOffset;		//!< number of bytes in buffer
+} _SHA256context_t;
+
+/**
+* @brief Start a new hash calculation
+* @param ctx context
+*/
+void SHA256Init(_SHA256context_t *ctx);
+
+/**
+* @brief Add data to the hash, complete blocks are hashed directly from data
+* @param ctx context
+* @param data Buffer with data to add.
+* @param dataLength Size of data buffer.
+*/
+void SHA256Add(_SHA256context_t *ctx, const uint8_t *data, size_t dataLength);
+
+/**
+* @brief Finish the hash calculation, ctx must be initialized again before reuse
+* @param ctx context
+* @param dest Buffer to return 32-byte hash.
+*/
+void SHA256Result(_SHA256context_t *ctx, uint8_t *dest);
+
 #endif
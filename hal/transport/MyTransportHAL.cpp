@@ -26,6 +26,165 @@
 #define TRANSPORT_HAL_DEBUG(x,...)	//!< debug NULL
 #endif
 
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+#include "drivers/CircularBuffer/CircularBuffer.h"
+
+/** Buffer to store received frames in. */
+static transportRxFrame_t transportRxQueueStorage[MY_RX_MESSAGE_BUFFER_SIZE];
+/** Circular buffer, which uses the transportRxQueueStorage and administers stored frames. */
+static CircularBuffer<transportRxFrame_t> transportRxQueue(transportRxQueueStorage,
+        MY_RX_MESSAGE_BUFFER_SIZE);
+
+static volatile uint8_t transportLostMessageCount = 0;
+static int16_t transportRxRSSI = INVALID_RSSI;	//!< RSSI of the frame taken from the buffer last
+static int16_t transportRxSNR = INVALID_SNR;	//!< SNR of the frame taken from the buffer last
+
+transportRxFrame_t *transportHALRxReserve(void)
+{
+	transportRxFrame_t *frame = transportRxQueue.getFront();
+	// Keep track of frames lost. Max 255, prevent wrapping.
+	if (frame == NULL && transportLostMessageCount < 255) {
+		++transportLostMessageCount;
+	}
+	return frame;
+}
+
+void transportHALRxPush(transportRxFrame_t *frame)
+{
+	// signal quality of the frame, read from the driver before the next frame overwrites it
+	frame->RSSI = transportGetReceivingRSSI();
+	frame->SNR = transportGetReceivingSNR();
+	(void)transportRxQueue.pushFront(frame);
+}
+#endif
+
+#if defined(MY_TRANSPORT_ENCRYPTION_CCM)
+#if defined(MY_RADIO_RFM95)
+#define TRANSPORT_CCM_MAX_PAYLOAD_SIZE (RFM95_MAX_PAYLOAD_LEN)	//!< Max radio payload
+#else
+#define TRANSPORT_CCM_MAX_PAYLOAD_SIZE (MAX_MESSAGE_SIZE)	//!< Max radio payload
+#endif
+#define TRANSPORT_CCM_COUNTER_OFFSET (1u)	//!< Frame counter position, follows the cleartext sender
+#define TRANSPORT_CCM_DATA_OFFSET (5u)	//!< Ciphertext position
+#define TRANSPORT_CCM_MAC_SIZE (4u)	//!< Size of the truncated MAC
+#define TRANSPORT_CCM_FLAGS_MAC (0x09u)	//!< B0 flags: no AAD, M=4, L=2 (RFC 3610)
+#define TRANSPORT_CCM_FLAGS_CTR (0x01u)	//!< A_i flags: L=2 (RFC 3610)
+
+/**
+ * @brief Last frame counter received from a node
+ */
+typedef struct {
+	uint32_t counter;	//!< last accepted frame counter
+	uint8_t sender;		//!< node id
+} transportCCMSender_t;
+
+static uint32_t _transportCCMCounter;	//!< next frame counter
+static uint32_t _transportCCMReserved;	//!< frame counter stored in EEPROM
+static transportCCMSender_t _transportCCMSenders[MY_ENCRYPTION_CCM_SENDERS];	//!< most recently heard first
+static uint8_t _transportCCMSenderCount = 0;	//!< used entries in _transportCCMSenders
+
+static void transportCCMInit(void)
+{
+	hwReadConfigBlock((void *)&_transportCCMCounter, (void *)EEPROM_RF_ENCRYPTION_COUNTER_ADDRESS,
+	                  sizeof(_transportCCMCounter));
+	if (_transportCCMCounter == 0xFFFFFFFFul) {
+		// blank EEPROM, avoid restarting a previously used counter range
+		_transportCCMCounter = (uint32_t)random(0x10000) << 16;
+	}
+	// counters below the stored value may have been used before a reset
+	_transportCCMReserved = _transportCCMCounter;
+	_transportCCMSenderCount = 0;
+}
+
+static uint32_t transportCCMNextCounter(void)
+{
+	if (_transportCCMCounter == _transportCCMReserved) {
+		_transportCCMReserved += MY_TRANSPORT_CCM_COUNTER_RESERVE;
+		hwWriteConfigBlock((void *)&_transportCCMReserved, (void *)EEPROM_RF_ENCRYPTION_COUNTER_ADDRESS,
+		                   sizeof(_transportCCMReserved));
+	}
+	return _transportCCMCounter++;
+}
+
+static void transportCCMEncryptBlock(uint8_t *block)
+{
+	// a single CBC block with zero IV is the raw block cipher
+	uint8_t IV[16] = { 0 };
+	AES128CBCEncrypt(IV, block, 16);
+}
+
+static void transportCCMSetBlock(uint8_t *block, const uint8_t flags, const uint8_t sender,
+                                 const uint32_t counter, const uint8_t value)
+{
+	// flags | nonce (sender, frame counter, zero padding) | 16 bit value
+	(void)memset((void *)block, 0, 16);
+	block[0] = flags;
+	block[1] = sender;
+	block[2] = (uint8_t)(counter >> 24);
+	block[3] = (uint8_t)(counter >> 16);
+	block[4] = (uint8_t)(counter >> 8);
+	block[5] = (uint8_t)counter;
+	block[15] = value;
+}
+
+static void transportCCMProcess(const uint8_t sender, const uint32_t counter, uint8_t *data,
+                                const uint8_t len, uint8_t *mac, const bool decrypt)
+{
+	uint8_t tag[16];
+	uint8_t keyStream[16];
+	transportCCMSetBlock(tag, TRANSPORT_CCM_FLAGS_MAC, sender, counter, len);
+	transportCCMEncryptBlock(tag);
+	for (uint8_t offset = 0; offset < len; offset += 16) {
+		const uint8_t blockLength = len - offset < 16 ? len - offset : 16;
+		transportCCMSetBlock(keyStream, TRANSPORT_CCM_FLAGS_CTR, sender, counter, offset / 16 + 1);
+		transportCCMEncryptBlock(keyStream);
+		for (uint8_t i = 0; i < blockLength; i++) {
+			// CBC-MAC is calculated over the plaintext, zero padded
+			if (decrypt) {
+				data[offset + i] ^= keyStream[i];
+				tag[i] ^= data[offset + i];
+			} else {
+				tag[i] ^= data[offset + i];
+				data[offset + i] ^= keyStream[i];
+			}
+		}
+		transportCCMEncryptBlock(tag);
+	}
+	transportCCMSetBlock(keyStream, TRANSPORT_CCM_FLAGS_CTR, sender, counter, 0);
+	transportCCMEncryptBlock(keyStream);
+	for (uint8_t i = 0; i < TRANSPORT_CCM_MAC_SIZE; i++) {
+		mac[i] = tag[i] ^ keyStream[i];
+	}
+}
+
+static bool transportCCMCheckReplay(const uint8_t sender, const uint32_t counter)
+{
+	if (sender == AUTO) {
+		// nodes without id share the sender, cannot be tracked
+		return true;
+	}
+	uint8_t index = 0;
+	while (index < _transportCCMSenderCount && _transportCCMSenders[index].sender != sender) {
+		index++;
+	}
+	if (index < _transportCCMSenderCount) {
+		if (counter <= _transportCCMSenders[index].counter) {
+			return false;
+		}
+	} else if (_transportCCMSenderCount < MY_ENCRYPTION_CCM_SENDERS) {
+		_transportCCMSenderCount++;
+	} else {
+		// drop least recently heard node
+		index--;
+	}
+	(void)memmove((void *)&_transportCCMSenders[1], (void *)&_transportCCMSenders[0],
+	              index * sizeof(transportCCMSender_t));
+	_transportCCMSenders[0].sender = sender;
+	_transportCCMSenders[0].counter = counter;
+	return true;
+}
+#endif
+
 bool transportHALInit(void)
 {
 	TRANSPORT_HAL_DEBUG(PSTR("THA:INIT\n"));
@@ -52,6 +211,9 @@ bool transportHALInit(void)
 #else
 	//set up AES-key
 	AES128CBCInit(transportPSK);
+#endif
+#if defined(MY_TRANSPORT_ENCRYPTION_CCM)
+	transportCCMInit();
 #endif
 	// Make sure it is purged from memory when set
 	(void)memset((void *)transportPSK, 0,
@@ -75,7 +237,13 @@ uint8_t transportHALGetAddress(void)
 
 bool transportHALDataAvailable(void)
 {
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+	// driver moves received frames to the buffer
+	(void)transportDataAvailable();
+	bool result = !transportRxQueue.empty();
+#else
 	bool result = transportDataAvailable();
+#endif
 #if defined(MY_DEBUG_VERBOSE_TRANSPORT_HAL)
 	if (result) {
 		TRANSPORT_HAL_DEBUG(PSTR("THA:DATA:AVAIL\n"));
@@ -91,16 +259,78 @@ bool transportHALSanityCheck(void)
 	return result;
 }
 
+static uint8_t transportHALReceiveFrame(void *data)
+{
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+	const transportRxFrame_t *frame = transportRxQueue.getBack();
+	if (frame == NULL) {
+		return 0;
+	}
+	const uint8_t length = frame->length;
+	(void)memcpy(data, (const void *)frame->data, length);
+	transportRxRSSI = frame->RSSI;
+	transportRxSNR = frame->SNR;
+	(void)transportRxQueue.popBack();
+	return length;
+#else
+	return transportReceive(data);
+#endif
+}
+
 bool transportHALReceive(MyMessage *inMsg, uint8_t *msgLength)
 {
 	// set pointer to first byte of data structure
 	uint8_t *rx_data = &inMsg->last;
-	uint8_t payloadLength = transportReceive((void *)rx_data);
+#if defined(MY_TRANSPORT_ENCRYPTION_CCM)
+	uint8_t frame[MY_TRANSPORT_MAX_FRAME_SIZE];
+	uint8_t payloadLength = transportHALReceiveFrame((void *)frame);
+#if defined(MY_DEBUG_VERBOSE_TRANSPORT_HAL)
+	hwDebugBuf2Str((const uint8_t *)frame, payloadLength);
+	TRANSPORT_HAL_DEBUG(PSTR("THA:RCV:MSG=%s\n"), hwDebugPrintStr);
+#endif
+	if (payloadLength < HEADER_SIZE + MY_TRANSPORT_CCM_OVERHEAD ||
+	        payloadLength > MY_TRANSPORT_MAX_FRAME_SIZE) {
+		setIndication(INDICATION_ERR_LENGTH);
+		TRANSPORT_HAL_DEBUG(PSTR("!THA:RCV:FRAME LEN=%" PRIu8 "\n"), payloadLength);
+		return false;
+	}
+	TRANSPORT_HAL_DEBUG(PSTR("THA:RCV:DECRYPT\n"));
+	const uint8_t sender = frame[0];
+	const uint32_t counter = (uint32_t)frame[TRANSPORT_CCM_COUNTER_OFFSET] << 24 |
+	                         (uint32_t)frame[TRANSPORT_CCM_COUNTER_OFFSET + 1] << 16 |
+	                         (uint32_t)frame[TRANSPORT_CCM_COUNTER_OFFSET + 2] << 8 |
+	                         (uint32_t)frame[TRANSPORT_CCM_COUNTER_OFFSET + 3];
+	const uint8_t dataLength = payloadLength - MY_TRANSPORT_CCM_OVERHEAD - 1;
+	uint8_t mac[TRANSPORT_CCM_MAC_SIZE];
+	transportCCMProcess(sender, counter, frame + TRANSPORT_CCM_DATA_OFFSET, dataLength, mac, true);
+	// compare in constant time
+	uint8_t macDiff = 0;
+	for (uint8_t i = 0; i < TRANSPORT_CCM_MAC_SIZE; i++) {
+		macDiff |= mac[i] ^ frame[TRANSPORT_CCM_DATA_OFFSET + dataLength + i];
+	}
+	if (macDiff) {
+		TRANSPORT_HAL_DEBUG(PSTR("!THA:RCV:MAC\n"));
+		return false;
+	}
+	if (!transportCCMCheckReplay(sender, counter)) {
+		TRANSPORT_HAL_DEBUG(PSTR("!THA:RCV:REPLAY=%" PRIu8 "\n"), sender);
+		return false;
+	}
+	rx_data[0] = sender;
+	(void)memcpy((void *)(rx_data + 1), (const void *)(frame + TRANSPORT_CCM_DATA_OFFSET), dataLength);
+	payloadLength = dataLength + 1;
+#if defined(MY_DEBUG_VERBOSE_TRANSPORT_HAL)
+	hwDebugBuf2Str((const uint8_t *)rx_data, payloadLength);
+	TRANSPORT_HAL_DEBUG(PSTR("THA:RCV:PLAIN=%s\n"), hwDebugPrintStr);
+#endif
+#else
+	uint8_t payloadLength = transportHALReceiveFrame((void *)rx_data);
 #if defined(MY_DEBUG_VERBOSE_TRANSPORT_HAL)
 	hwDebugBuf2Str((const uint8_t *)rx_data, payloadLength);
 	TRANSPORT_HAL_DEBUG(PSTR("THA:RCV:MSG=%s\n"), hwDebugPrintStr);
 #endif
-#if defined(MY_TRANSPORT_ENCRYPTION) && !defined(MY_RADIO_RFM69)
+#endif
+#if defined(MY_TRANSPORT_ENCRYPTION) && !defined(MY_RADIO_RFM69) && !defined(MY_TRANSPORT_ENCRYPTION_CCM)
 	TRANSPORT_HAL_DEBUG(PSTR("THA:RCV:DECRYPT\n"));
 	// has to be adjusted, WIP!
 	uint8_t IV[16] = { 0 };
@@ -120,7 +350,7 @@ bool transportHALReceive(MyMessage *inMsg, uint8_t *msgLength)
 		return false;
 	}
 	*msgLength = tmp.getLength();
-#if defined(MY_TRANSPORT_ENCRYPTION) && !defined(MY_RADIO_RFM69)
+#if defined(MY_TRANSPORT_ENCRYPTION) && !defined(MY_RADIO_RFM69) && !defined(MY_TRANSPORT_ENCRYPTION_CCM)
 	// payload length = a multiple of blocksize length for decrypted messages, i.e. cannot be used for payload length check
 #else
 	// Reject payloads with incorrect length
@@ -149,7 +379,31 @@ bool transportHALSend(const uint8_t nextRecipient, const MyMessage *outMsg, cons
 	TRANSPORT_HAL_DEBUG(PSTR("THA:SND:MSG=%s\n"), hwDebugPrintStr);
 #endif
 
-#if defined(MY_TRANSPORT_ENCRYPTION) && !defined(MY_RADIO_RFM69)
+#if defined(MY_TRANSPORT_ENCRYPTION_CCM)
+	const uint8_t finalLength = len + MY_TRANSPORT_CCM_OVERHEAD;
+	if (finalLength > TRANSPORT_CCM_MAX_PAYLOAD_SIZE) {
+		TRANSPORT_HAL_DEBUG(PSTR("!THA:SND:LEN=%" PRIu8 "\n"), finalLength);
+		return false;
+	}
+	TRANSPORT_HAL_DEBUG(PSTR("THA:SND:ENCRYPT\n"));
+	uint8_t tx_data[MY_TRANSPORT_MAX_FRAME_SIZE];
+	const uint32_t counter = transportCCMNextCounter();
+	// sender stays in clear, it is part of the nonce
+	tx_data[0] = outMsg->last;
+	tx_data[TRANSPORT_CCM_COUNTER_OFFSET] = (uint8_t)(counter >> 24);
+	tx_data[TRANSPORT_CCM_COUNTER_OFFSET + 1] = (uint8_t)(counter >> 16);
+	tx_data[TRANSPORT_CCM_COUNTER_OFFSET + 2] = (uint8_t)(counter >> 8);
+	tx_data[TRANSPORT_CCM_COUNTER_OFFSET + 3] = (uint8_t)counter;
+	(void)memcpy((void *)(tx_data + TRANSPORT_CCM_DATA_OFFSET), (const void *)(&outMsg->last + 1),
+	             len - 1);
+	transportCCMProcess(tx_data[0], counter, tx_data + TRANSPORT_CCM_DATA_OFFSET, len - 1,
+	                    tx_data + TRANSPORT_CCM_DATA_OFFSET + len - 1, false);
+#if defined(MY_DEBUG_VERBOSE_TRANSPORT_HAL)
+	hwDebugBuf2Str((const uint8_t *)tx_data, finalLength);
+	TRANSPORT_HAL_DEBUG(PSTR("THA:SND:CIP=%s\n"), hwDebugPrintStr);
+#endif
+
+#elif defined(MY_TRANSPORT_ENCRYPTION) && !defined(MY_RADIO_RFM69)
 	TRANSPORT_HAL_DEBUG(PSTR("THA:SND:ENCRYPT\n"));
 	uint8_t *tx_data[MAX_MESSAGE_SIZE];
 	// copy input data because it is read-only
@@ -206,7 +460,11 @@ int16_t transportHALGetSendingRSSI(void)
 
 int16_t transportHALGetReceivingRSSI(void)
 {
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+	int16_t result = transportRxRSSI;
+#else
 	int16_t result = transportGetReceivingRSSI();
+#endif
 	return result;
 }
 
@@ -218,7 +476,11 @@ int16_t transportHALGetSendingSNR(void)
 
 int16_t transportHALGetReceivingSNR(void)
 {
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+	int16_t result = transportRxSNR;
+#else
 	int16_t result = transportGetReceivingSNR();
+#endif
 	return result;
 }
 
@@ -239,3 +501,33 @@ int16_t transportHALGetTxPowerLevel(void)
 	int16_t result = transportGetTxPowerLevel();
 	return result;
 }
+
+int16_t transportHALGetRxLost(void)
+{
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+	int16_t result = transportLostMessageCount;
+#else
+	int16_t result = INVALID_COUNT;
+#endif
+	return result;
+}
+
+uint8_t transportHALGetRxPending(void)
+{
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+	uint8_t result = transportRxQueue.available();
+#else
+	uint8_t result = transportHALDataAvailable();
+#endif
+	return result;
+}
+
+uint8_t transportHALGetTxQueueFree(void)
+{
+#if defined(MY_TRANSPORT_ASYNC_SEND)
+	uint8_t result = transportGetTxQueueFree();
+#else
+	uint8_t result = UINT8_MAX;
+#endif
+	return result;
+}
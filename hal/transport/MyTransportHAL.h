@@ -29,12 +29,16 @@
  * | | THA | RCV   | MSG=%%s										| Receive message (MSG)
  * | | THA | RCV   | DECRYPT										| Decrypt received message
  * | | THA | RCV   | PLAIN=%%s									| Decrypted message (PLAIN)
+ * |!| THA | RCV   | FRAME LEN=%%d							| Encrypted frame too short or too long (LEN)
+ * |!| THA | RCV   | MAC												| %AES-CCM message authentication failed
+ * |!| THA | RCV   | REPLAY=%%d									| Replayed %AES-CCM frame from node (REPLAY)
  * |!| THA | RCV   | PVER=%%d										| Message protocol version (PVER) mismatch
  * |!| THA | RCV   | LEN=%%d,EXP=%%d						| Invalid message length (LEN), exptected length (EXP)
  * | | THA | RCV   | MSG LEN=%%d								| Length of received message (LEN)
  * | | THA | SND   | MSG=%%s										| Send message (MSG)
  * | | THA | SND   | ENCRYPT										| Encrypt message to send (%AES)
  * | | THA | SND   | CIP=%%s										| Ciphertext of encypted message (CIP)
+ * |!| THA | SND   | LEN=%%d										| Encrypted frame exceeds radio payload size (LEN)
  * | | THA | SND   | MSG LEN=%%d,RES=%%d				| Sending message with length (LEN), result (RES)
  *
  *
@@ -47,24 +51,49 @@
 #define INVALID_RSSI        ((int16_t)-256)	//!< INVALID_RSSI
 #define INVALID_PERCENT     ((int16_t)-100)	//!< INVALID_PERCENT
 #define INVALID_LEVEL       ((int16_t)-256)	//!< INVALID_LEVEL
+#define INVALID_COUNT       ((int16_t)-1)	//!< INVALID_COUNT
 
 #if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
 #if defined(MY_RADIO_NRF5_ESB)
 #error Receive message buffering not supported for NRF5 radio! Please define MY_NRF5_RX_BUFFER_SIZE
 #endif
-#if defined(MY_RADIO_RFM69)
-#error Receive message buffering not supported for RFM69!
-#endif
-#if defined(MY_RADIO_RFM95)
-#error Receive message buffering not supported for RFM95!
-#endif
-#if defined(MY_RS485)
-#error Receive message buffering not supported for RS485!
+#if defined(MY_RADIO_RFM69) && !defined(MY_RFM69_NEW_DRIVER)
+#error Receive message buffering requires the new RFM69 driver! Please define MY_RFM69_NEW_DRIVER
 #endif
 #elif defined(MY_RX_MESSAGE_BUFFER_SIZE)
 #error Receive message buffering requires message buffering feature enabled!
 #endif
 
+#if (defined(MY_RADIO_RFM95) && (MY_RFM95_TX_QUEUE_SIZE > 0)) || (defined(MY_RADIO_RFM69) && defined(MY_RFM69_NEW_DRIVER) && (MY_RFM69_TX_QUEUE_SIZE > 0))
+#define MY_TRANSPORT_ASYNC_SEND	//!< transportHALSend() queues frames, results are reported by transportSendComplete()
+#endif
+
+#if (defined(MY_RF24_ENABLE_ENCRYPTION) && defined(MY_RADIO_RF24)) || (defined(MY_NRF5_ESB_ENABLE_ENCRYPTION) && defined(MY_RADIO_NRF5_ESB)) || (defined(MY_RFM69_ENABLE_ENCRYPTION) && defined(MY_RADIO_RFM69)) || (defined(MY_RFM95_ENABLE_ENCRYPTION) && defined(MY_RADIO_RFM95))
+#define MY_TRANSPORT_ENCRYPTION //!< ïnternal flag
+#endif
+
+#if defined(MY_TRANSPORT_ENCRYPTION) && defined(MY_ENCRYPTION_CCM) && !defined(MY_RADIO_RFM69)
+#define MY_TRANSPORT_ENCRYPTION_CCM	//!< Authenticated %AES-CCM frames, see @ref MY_ENCRYPTION_CCM
+#define MY_TRANSPORT_CCM_OVERHEAD (8u)	//!< Frame counter and MAC added to each encrypted frame
+#define MY_TRANSPORT_CCM_COUNTER_RESERVE (256u)	//!< Frame counters reserved per EEPROM write
+#define MY_TRANSPORT_MAX_FRAME_SIZE (MAX_MESSAGE_SIZE + MY_TRANSPORT_CCM_OVERHEAD)	//!< Max frame size
+#else
+#define MY_TRANSPORT_MAX_FRAME_SIZE (MAX_MESSAGE_SIZE)	//!< Max frame size
+#endif
+
+#if defined(MY_TRANSPORT_ENCRYPTION_CCM) && (defined(MY_RADIO_RF24) || defined(MY_RADIO_NRF5_ESB))
+#define MY_TRANSPORT_MAX_PAYLOAD_SIZE (MAX_PAYLOAD_SIZE - MY_TRANSPORT_CCM_OVERHEAD)	//!< Max payload size that fits into a frame
+#else
+#define MY_TRANSPORT_MAX_PAYLOAD_SIZE (MAX_PAYLOAD_SIZE)	//!< Max payload size that fits into a frame
+#endif
+
+#if (MY_TRANSPORT_MAX_PAYLOAD_SIZE < MAX_PAYLOAD_SIZE) && defined(MY_SIGNING_FEATURE)
+#error MY_ENCRYPTION_CCM leaves 17 payload bytes on RF24 and nRF5, signed messages do not fit! Disable MY_ENCRYPTION_CCM or signing
+#endif
+#if (MY_TRANSPORT_MAX_PAYLOAD_SIZE < MAX_PAYLOAD_SIZE) && defined(MY_OTA_FIRMWARE_FEATURE)
+#error MY_ENCRYPTION_CCM leaves 17 payload bytes on RF24 and nRF5, OTA firmware blocks do not fit! Disable MY_ENCRYPTION_CCM or MY_OTA_FIRMWARE_FEATURE
+#endif
+
 /**
 * @brief Signal report selector
 */
@@ -76,9 +105,35 @@ typedef enum {
 	SR_TX_POWER_LEVEL,     //!< SR_TX_POWER_LEVEL
 	SR_TX_POWER_PERCENT,   //!< SR_TX_POWER_PERCENT
 	SR_UPLINK_QUALITY,     //!< SR_UPLINK_QUALITY
+	SR_RX_LOST,            //!< SR_RX_LOST
 	SR_NOT_DEFINED         //!< SR_NOT_DEFINED
 } signalReport_t;
 
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+/**
+* @brief Received frame, stored in the RX message buffer
+*/
+typedef struct {
+	uint8_t length;                            //!< Length of the frame
+	uint8_t data[MY_TRANSPORT_MAX_FRAME_SIZE]; //!< Raw frame, as received
+	int16_t RSSI;                              //!< Receiving RSSI, captured when buffered
+	int16_t SNR;                               //!< Receiving SNR, captured when buffered
+} transportRxFrame_t;
+
+/**
+* @brief Get the next free entry of the RX message buffer
+*
+* Called by the transport driver for every frame received, possibly from interrupt context.
+* The driver reads the frame into the entry and hands it over with transportHALRxPush().
+* @return Free entry, or NULL if the buffer is full. The frame is then counted as lost.
+*/
+transportRxFrame_t *transportHALRxReserve(void);
+/**
+* @brief Hand a received frame over to the transport layer
+* @param frame Entry from transportHALRxReserve(), length and data set
+*/
+void transportHALRxPush(transportRxFrame_t *frame);
+#endif
 
 /**
 * @brief Initialize transport HW
@@ -99,12 +154,15 @@ uint8_t transportHALGetAddress(void);
 * @param data message to be sent
 * @param len length of message (header + payload)
 * @param noACK do not wait for ACK
-* @return true if message sent successfully
+* @return true if message sent successfully, or queued with @ref MY_TRANSPORT_ASYNC_SEND
 */
 bool transportHALSend(const uint8_t nextRecipient, const MyMessage *outMsg, const uint8_t len,
                       const bool noACK);
 /**
 * @brief Verify if RX FIFO has pending messages
+*
+* With @ref MY_RX_MESSAGE_BUFFER_FEATURE the transport driver is serviced and
+* the RX message buffer is checked.
 * @return true if message available in RX FIFO
 */
 bool transportHALDataAvailable(void);
@@ -172,5 +230,20 @@ bool transportHALSetTxPowerPercent(const uint8_t powerPercent);
 * @return TX power in dBm
 */
 int16_t transportHALGetTxPowerLevel(void);
+/**
+* @brief transportHALGetRxLost
+* @return Received frames lost due to a full RX message buffer (max. 255), INVALID_COUNT if not buffered
+*/
+int16_t transportHALGetRxLost(void);
+/**
+* @brief transportHALGetRxPending
+* @return Received frames waiting to be processed (RX message buffer fill level, 0 or 1 if not buffered)
+*/
+uint8_t transportHALGetRxPending(void);
+/**
+* @brief transportHALGetTxQueueFree
+* @return Frames that can be sent without blocking, UINT8_MAX without @ref MY_TRANSPORT_ASYNC_SEND
+*/
+uint8_t transportHALGetTxQueueFree(void);
 
 #endif // MyTransportHAL_h
@@ -20,36 +20,17 @@
 #include "hal/transport/RF24/driver/RF24.h"
 
 #if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
-#include "drivers/CircularBuffer/CircularBuffer.h"
-
-typedef struct _transportQueuedMessage {
-	uint8_t m_len;                        // Length of the data
-	uint8_t m_data[MAX_MESSAGE_SIZE];   // The raw data
-} transportQueuedMessage;
-
-/** Buffer to store queued messages in. */
-static transportQueuedMessage transportRxQueueStorage[MY_RX_MESSAGE_BUFFER_SIZE];
-/** Circular buffer, which uses the transportRxQueueStorage and administers stored messages. */
-static CircularBuffer<transportQueuedMessage> transportRxQueue(transportRxQueueStorage,
-        MY_RX_MESSAGE_BUFFER_SIZE);
-
-static volatile uint8_t transportLostMessageCount = 0;
-
 static void transportRxCallback(void)
 {
 	// Called for each message received by radio, from interrupt context.
 	// This function _must_ call RF24_readMessage() to de-assert interrupt line!
-	if (!transportRxQueue.full()) {
-		transportQueuedMessage* msg = transportRxQueue.getFront();
-		msg->m_len = RF24_readMessage(msg->m_data);		// Read payload & clear RX_DR
-		(void)transportRxQueue.pushFront(msg);
+	transportRxFrame_t *frame = transportHALRxReserve();
+	if (frame != NULL) {
+		frame->length = RF24_readMessage(frame->data);		// Read payload & clear RX_DR
+		transportHALRxPush(frame);
 	} else {
 		// Queue is full. Discard message.
 		(void)RF24_readMessage(NULL);		// Read payload & clear RX_DR
-		// Keep track of messages lost. Max 255, prevent wrapping.
-		if (transportLostMessageCount < 255) {
-			++transportLostMessageCount;
-		}
 	}
 }
 #endif
@@ -82,7 +63,8 @@ bool transportDataAvailable(void)
 {
 #if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
 	(void)RF24_isDataAvailable;				// Prevent 'defined but not used' warning
-	return !transportRxQueue.empty();
+	// messages are buffered from interrupt context
+	return false;
 #else
 	return RF24_isDataAvailable();
 #endif
@@ -95,17 +77,8 @@ bool transportSanityCheck(void)
 
 uint8_t transportReceive(void *data)
 {
-	uint8_t len = 0;
-#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
-	transportQueuedMessage* msg = transportRxQueue.getBack();
-	if (msg) {
-		len = msg->m_len;
-		(void)memcpy(data, msg->m_data, len);
-		(void)transportRxQueue.popBack();
-	}
-#else
-	len = RF24_readMessage(data);
-#endif
+	// not used with MY_RX_MESSAGE_BUFFER_FEATURE, messages are read by transportRxCallback()
+	uint8_t len = RF24_readMessage(data);
 	return len;
 }
 
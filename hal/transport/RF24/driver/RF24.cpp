@@ -40,6 +40,10 @@ LOCAL RF24_receiveCallbackType RF24_receiveCallback = NULL;
 uint8_t RF24_spi_rxbuff[32+1] ; //SPI receive buffer (payload max 32 bytes)
 uint8_t RF24_spi_txbuff[32+1]
 ; //SPI transmit buffer (payload max 32 bytes + 1 byte for the command)
+LOCAL uint8_t RF24_spi_queuebuff[RF24_SPI_QUEUE_SIZE][32+1]; // queued register writes
+LOCAL uint8_t RF24_spi_queuelen[RF24_SPI_QUEUE_SIZE];
+LOCAL uint8_t RF24_spi_queueCount = 0;
+LOCAL uint8_t RF24_spi_queueDepth = 0; // nesting level of RF24_spiBeginQueue(), the SPI lock is held while > 0
 #endif
 
 LOCAL void RF24_csn(const bool level)
@@ -53,14 +57,81 @@ LOCAL void RF24_csn(const bool level)
 
 LOCAL void RF24_ce(const bool level)
 {
+	// queued register writes must reach the radio before TX/RX starts
+	RF24_spiEndQueue();
 	hwDigitalWrite(MY_RF24_CE_PIN, level);
 }
 
+LOCAL void RF24_spiFlushQueue(void)
+{
+#if defined(__linux__)
+	if (!RF24_spi_queueCount) {
+		return;
+	}
+	RF24_SPI.beginTransaction(SPISettings(MY_RF24_SPI_SPEED, RF24_SPI_DATA_ORDER,
+	                                      RF24_SPI_DATA_MODE));
+	for (uint8_t i = 0; i < RF24_spi_queueCount; i++) {
+		RF24_SPI.queueTransfer(RF24_spi_queuebuff[i], NULL, RF24_spi_queuelen[i]);
+	}
+	RF24_SPI.transferQueued();
+	RF24_SPI.endTransaction();
+	RF24_spi_queueCount = 0;
+#endif
+}
+
+LOCAL void RF24_spiBeginQueue(void)
+{
+#if defined(__linux__)
+	// the SPI lock is kept until RF24_spiEndQueue(), an IRQ thread cannot access the queue meanwhile
+	RF24_SPI.beginTransaction(SPISettings(MY_RF24_SPI_SPEED, RF24_SPI_DATA_ORDER,
+	                                      RF24_SPI_DATA_MODE));
+	RF24_spi_queueDepth++;
+#endif
+}
+
+LOCAL void RF24_spiEndQueue(void)
+{
+#if defined(__linux__)
+	// the queue state is only accessed while holding the SPI lock
+	RF24_SPI.beginTransaction(SPISettings(MY_RF24_SPI_SPEED, RF24_SPI_DATA_ORDER,
+	                                      RF24_SPI_DATA_MODE));
+	if (RF24_spi_queueDepth) {
+		if (!--RF24_spi_queueDepth) {
+			RF24_spiFlushQueue();
+		}
+		// release the lock taken by RF24_spiBeginQueue()
+		RF24_SPI.endTransaction();
+	}
+	RF24_SPI.endTransaction();
+#endif
+}
+
 LOCAL uint8_t RF24_spiMultiByteTransfer(const uint8_t cmd, uint8_t *buf, uint8_t len,
                                         const bool readMode)
 {
 	uint8_t status;
 	uint8_t *current = buf;
+#if defined(__linux__)
+	// the queue state is only accessed while holding the SPI lock
+	RF24_SPI.beginTransaction(SPISettings(MY_RF24_SPI_SPEED, RF24_SPI_DATA_ORDER,
+	                                      RF24_SPI_DATA_MODE));
+	if (RF24_spi_queueDepth && !readMode) {
+		if (RF24_spi_queueCount == RF24_SPI_QUEUE_SIZE) {
+			RF24_spiFlushQueue();
+		}
+		uint8_t *ptx = RF24_spi_queuebuff[RF24_spi_queueCount];
+		RF24_spi_queuelen[RF24_spi_queueCount++] = len + 1;
+		*ptx = cmd;
+		if (current != NULL) {
+			(void)memcpy(ptx + 1, current, len);
+		}
+		RF24_SPI.endTransaction();
+		return 0;
+	}
+	// keep register accesses in order
+	RF24_spiFlushQueue();
+	RF24_SPI.endTransaction();
+#endif
 #if !defined(MY_SOFTSPI) && defined(SPI_HAS_TRANSACTION)
 	RF24_SPI.beginTransaction(SPISettings(MY_RF24_SPI_SPEED, RF24_SPI_DATA_ORDER,
 	                                      RF24_SPI_DATA_MODE));
@@ -308,6 +379,8 @@ LOCAL bool RF24_sendMessage(const uint8_t recipient, const void *buf, const uint
                             const bool noACK)
 {
 	RF24_stopListening();
+	// register writes up to CE high are sent in one go
+	RF24_spiBeginQueue();
 	RF24_openWritingPipe(recipient);
 	RF24_DEBUG(PSTR("RF24:TXM:TO=%" PRIu8 ",LEN=%" PRIu8 "\n"), recipient, len); // send message
 	// flush TX FIFO
@@ -330,6 +403,8 @@ LOCAL bool RF24_sendMessage(const uint8_t recipient, const void *buf, const uint
 	RF24_ce(LOW);
 	// reset interrupts
 	const uint8_t RF24_status = RF24_setStatus(_BV(RF24_RX_DR) | _BV(RF24_TX_DS) | _BV(RF24_MAX_RT));
+	// queue until CE high in RF24_startListening()
+	RF24_spiBeginQueue();
 	// Max retries exceeded
 	if (RF24_status & _BV(RF24_MAX_RT)) {
 		// flush packet
@@ -95,6 +95,8 @@
 
 #define RF24_BROADCAST_ADDRESS	(255u)	//!< RF24_BROADCAST_ADDRESS
 
+#define RF24_SPI_QUEUE_SIZE		(5u)	//!< Register writes sent in one SPI message (Linux)
+
 // verify RF24 IRQ defs
 #if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
 #if !defined(MY_RF24_IRQ_PIN)
@@ -146,6 +148,19 @@ LOCAL void RF24_csn(const bool level);
 */
 LOCAL void RF24_ce(const bool level);
 /**
+* @brief Queue subsequent register writes until CE changes or a register is read
+*
+* On Linux the queued writes are sent in a single SPI message, the status returned
+* by queued writes is 0. The SPI lock is held until RF24_spiEndQueue(), so SPI accesses
+* of the IRQ thread wait for the queue to be sent. Calls may be nested. Nothing is queued
+* on other architectures.
+*/
+LOCAL void RF24_spiBeginQueue(void);
+/**
+* @brief Send queued register writes and stop queueing, unless nested in another queue
+*/
+LOCAL void RF24_spiEndQueue(void);
+/**
 * @brief RF24_spiMultiByteTransfer
 * @param cmd
 * @param buf
@@ -21,6 +21,22 @@
 
 #include "hal/transport/RFM69/driver/new/RFM69_new.h"
 
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+static void transportRxCallback(void)
+{
+	// Called for each packet received by the radio, from RFM69_handler().
+	// This function _must_ call RFM69_receive() to get the radio back to RX!
+	transportRxFrame_t *frame = transportHALRxReserve();
+	if (frame != NULL) {
+		frame->length = RFM69_receive(frame->data, MY_TRANSPORT_MAX_FRAME_SIZE);
+		transportHALRxPush(frame);
+	} else {
+		// Queue is full. Discard packet without ACK, the sender will retry.
+		(void)RFM69_receive(NULL, 0);
+	}
+}
+#endif
+
 bool transportInit(void)
 {
 	const bool result = RFM69_initialise(MY_RFM69_FREQUENCY);
@@ -30,6 +46,12 @@ bool transportInit(void)
 #else
 	RFM69_ATCmode(true, MY_RFM69_ATC_TARGET_RSSI_DBM);
 #endif
+#if defined(RFM69_TX_QUEUE)
+	RFM69_registerSendCallback(transportSendComplete);
+#endif
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+	RFM69_registerReceiveCallback(transportRxCallback);
+#endif
 
 #ifdef MY_RFM69_ENABLE_ENCRYPTION
 	uint8_t RFM69_psk[16];
@@ -62,6 +84,13 @@ bool transportSend(const uint8_t to, const void *data, uint8_t len, const bool n
 	return RFM69_sendWithRetry(to, data, len, noACK);
 }
 
+#if defined(RFM69_TX_QUEUE)
+uint8_t transportGetTxQueueFree(void)
+{
+	return MY_RFM69_TX_QUEUE_SIZE - RFM69_txPending();
+}
+#endif
+
 bool transportDataAvailable(void)
 {
 	RFM69_handler();
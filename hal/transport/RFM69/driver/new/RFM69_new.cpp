@@ -44,10 +44,28 @@
 rfm69_internal_t RFM69;	//!< internal variables
 volatile uint8_t RFM69_irq; //!< rfm69 irq flag
 
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+LOCAL rfm69_receiveCallbackType RFM69_receiveCallback = NULL;
+#endif
+
+#if defined(RFM69_TX_QUEUE)
+LOCAL rfm69_txEntry_t RFM69_txQueue[MY_RFM69_TX_QUEUE_SIZE];
+LOCAL uint8_t RFM69_txActive = RFM69_TX_NONE;	// slot in CSMA or TX
+LOCAL bool RFM69_txOnAir = false;	// active slot: false = CSMA, true = TX
+LOCAL uint32_t RFM69_txPhaseMS;	// start of CSMA or TX
+LOCAL uint16_t RFM69_txOrder = 0;
+LOCAL rfm69_sendCallbackType RFM69_sendCallback = NULL;
+#endif
+
 #if defined(__linux__)
 // SPI RX and TX buffers (max packet len + 1 byte for the command)
 uint8_t RFM69_spi_rxbuff[RFM69_MAX_PACKET_LEN + 1];
 uint8_t RFM69_spi_txbuff[RFM69_MAX_PACKET_LEN + 1];
+// queued register writes, sent in one SPI message
+LOCAL uint8_t RFM69_spi_queuebuff[RFM69_SPI_QUEUE_SIZE][RFM69_MAX_PACKET_LEN + 1];
+LOCAL uint8_t RFM69_spi_queuelen[RFM69_SPI_QUEUE_SIZE];
+LOCAL uint8_t RFM69_spi_queueCount = 0;
+LOCAL uint8_t RFM69_spi_queueDepth = 0; // nesting level of RFM69_spiBeginQueue(), the SPI lock is held while > 0
 #endif
 
 LOCAL void RFM69_csn(const bool level)
@@ -74,12 +92,82 @@ LOCAL void RFM69_concludeSPITransaction(void)
 #endif
 }
 
+LOCAL void RFM69_spiFlushQueue(void)
+{
+#if defined(__linux__)
+	if (!RFM69_spi_queueCount) {
+		return;
+	}
+	RFM69_prepareSPITransaction();
+	for (uint8_t i = 0; i < RFM69_spi_queueCount; i++) {
+		RFM69_SPI.queueTransfer(RFM69_spi_queuebuff[i], NULL, RFM69_spi_queuelen[i]);
+	}
+	RFM69_SPI.transferQueued();
+	RFM69_concludeSPITransaction();
+	RFM69_spi_queueCount = 0;
+#endif
+}
+
+// queue register writes until RFM69_spiEndQueue() or a register is read (Linux only)
+LOCAL void RFM69_spiBeginQueue(void)
+{
+#if defined(__linux__)
+	// the SPI lock is kept until RFM69_spiEndQueue(), an IRQ thread cannot access the queue meanwhile
+	RFM69_SPI.beginTransaction(SPISettings(MY_RFM69_SPI_SPEED, RFM69_SPI_DATA_ORDER,
+	                                       RFM69_SPI_DATA_MODE));
+	RFM69_spi_queueDepth++;
+#endif
+}
+
+LOCAL void RFM69_spiEndQueue(void)
+{
+#if defined(__linux__)
+	// the queue state is only accessed while holding the SPI lock
+	RFM69_SPI.beginTransaction(SPISettings(MY_RFM69_SPI_SPEED, RFM69_SPI_DATA_ORDER,
+	                                       RFM69_SPI_DATA_MODE));
+	if (RFM69_spi_queueDepth) {
+		if (!--RFM69_spi_queueDepth) {
+			RFM69_spiFlushQueue();
+		}
+		// release the lock taken by RFM69_spiBeginQueue()
+		RFM69_SPI.endTransaction();
+	}
+	RFM69_SPI.endTransaction();
+#endif
+}
+
 LOCAL uint8_t RFM69_spiMultiByteTransfer(const uint8_t cmd, uint8_t *buf, uint8_t len,
         const bool aReadMode)
 {
 	uint8_t status;
 	uint8_t *current = buf;
 
+#if defined(__linux__)
+	// SPI buffers hold one packet and the command byte
+	if (len > RFM69_MAX_PACKET_LEN) {
+		len = RFM69_MAX_PACKET_LEN;
+	}
+	// the queue state is only accessed while holding the SPI lock
+	RFM69_SPI.beginTransaction(SPISettings(MY_RFM69_SPI_SPEED, RFM69_SPI_DATA_ORDER,
+	                                       RFM69_SPI_DATA_MODE));
+	if (RFM69_spi_queueDepth && !aReadMode) {
+		if (RFM69_spi_queueCount == RFM69_SPI_QUEUE_SIZE) {
+			RFM69_spiFlushQueue();
+		}
+		uint8_t *ptx = RFM69_spi_queuebuff[RFM69_spi_queueCount];
+		RFM69_spi_queuelen[RFM69_spi_queueCount++] = len + 1;
+		*ptx = cmd;
+		if (current != NULL) {
+			(void)memcpy(ptx + 1, current, len);
+		}
+		RFM69_SPI.endTransaction();
+		return 0; // status is not known until the queue is sent
+	}
+	// keep register accesses in order
+	RFM69_spiFlushQueue();
+	RFM69_SPI.endTransaction();
+#endif
+
 	RFM69_prepareSPITransaction();
 	RFM69_csn(LOW);
 
@@ -278,8 +366,8 @@ LOCAL void RFM69_interruptHandling(void)
 			             RFM69.currentPacket.header.packetLen - 1);
 
 			if (RFM69.currentPacket.header.version >= RFM69_MIN_PACKET_HEADER_VERSION) {
-				RFM69.currentPacket.payloadLen = min(RFM69.currentPacket.header.packetLen - (RFM69_HEADER_LEN - 1),
-				                                     RFM69_MAX_PACKET_LEN);
+				RFM69.currentPacket.payloadLen = min((uint8_t)(RFM69.currentPacket.header.packetLen -
+				                                     (RFM69_HEADER_LEN - 1)), (uint8_t)RFM69_MAX_PACKET_LEN);
 				RFM69.ackReceived = RFM69_getACKReceived(RFM69.currentPacket.header.controlFlags);
 				RFM69.dataReceived = !RFM69.ackReceived;
 			}
@@ -312,6 +400,11 @@ LOCAL void RFM69_interruptHandling(void)
 		}
 		RFM69.currentPacket.RSSI = RFM69_readRSSI();
 		// radio remains in stdby until packet read
+#if defined(RFM69_TX_QUEUE)
+		if (RFM69.ackReceived) {
+			RFM69_txReceiveACK();
+		}
+#endif
 	} else {
 		// back to RX
 		(void)RFM69_setRadioMode(RFM69_RADIO_MODE_RX);
@@ -326,8 +419,27 @@ LOCAL void RFM69_handler(void)
 		RFM69_irq = false;
 		RFM69_interruptHandling();
 	}
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+	if (RFM69.dataReceived && RFM69_receiveCallback != NULL) {
+		RFM69_receiveCallback();
+		if (RFM69.radioMode == RFM69_RADIO_MODE_STDBY) {
+			// packet read, back to RX
+			(void)RFM69_setRadioMode(RFM69_RADIO_MODE_RX);
+		}
+	}
+#endif
+#if defined(RFM69_TX_QUEUE)
+	RFM69_txProcess();
+#endif
 }
 
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+LOCAL void RFM69_registerReceiveCallback(rfm69_receiveCallbackType cb)
+{
+	RFM69_receiveCallback = cb;
+}
+#endif
+
 LOCAL bool RFM69_available(void)
 {
 	if (RFM69.dataReceived) {
@@ -336,6 +448,11 @@ LOCAL bool RFM69_available(void)
 	} else if (RFM69.radioMode == RFM69_RADIO_MODE_TX) {
 		// still in TX
 		return false;
+#if defined(RFM69_TX_QUEUE)
+	} else if (RFM69_txActive != RFM69_TX_NONE) {
+		// queued frame in CSMA
+		return false;
+#endif
 	} else if (RFM69.radioMode != RFM69_RADIO_MODE_RX) { // adding this check speeds up loop() :)
 		// no data received and not in RX
 		(void)RFM69_setRadioMode(RFM69_RADIO_MODE_RX);
@@ -356,8 +473,8 @@ LOCAL uint8_t RFM69_receive(uint8_t *buf, const uint8_t maxBufSize)
 	}
 	// clear data flag
 	RFM69.dataReceived = false;
-	if (RFM69_getACKRequested(controlFlags) && !RFM69_getACKReceived(controlFlags)) {
-#if defined(MY_GATEWAY_FEATURE) && (F_CPU>16*1000000ul)
+	if (buf != NULL && RFM69_getACKRequested(controlFlags) && !RFM69_getACKReceived(controlFlags)) {
+#if defined(MY_GATEWAY_FEATURE) && (F_CPU>16*1000000ul) && !defined(RFM69_TX_QUEUE)
 		// delay for fast GW and slow nodes
 		delay(50);
 #endif
@@ -374,6 +491,24 @@ LOCAL bool RFM69_channelFree(void)
 	return (RSSI > RFM69_RSSItoInternal(MY_RFM69_CSMA_LIMIT_DBM));
 }
 
+LOCAL void RFM69_startTransmission(rfm69_packet_t *packet)
+{
+	// set radio to standby to load fifo
+	(void)RFM69_setRadioMode(RFM69_RADIO_MODE_STDBY);
+	// clear FIFO and flags
+	RFM69_clearFIFO();
+	// FIFO writes are sent together with the mode change to TX
+	RFM69_spiBeginQueue();
+	// write packet
+	const uint8_t finalLen = packet->payloadLen + RFM69_HEADER_LEN; // including length byte
+	(void)RFM69_burstWriteReg(RFM69_REG_FIFO, packet->data, finalLen);
+
+	// send message
+	(void)RFM69_setRadioMode(RFM69_RADIO_MODE_TX); // irq upon txsent
+	RFM69_spiEndQueue();
+}
+
+#if !defined(RFM69_TX_QUEUE)
 LOCAL bool RFM69_sendFrame(rfm69_packet_t *packet, const bool increaseSequenceCounter)
 {
 	// ensure we are in RX for correct RSSI sampling, dirty hack to enforce rx restart :)
@@ -385,23 +520,13 @@ LOCAL bool RFM69_sendFrame(rfm69_packet_t *packet, const bool increaseSequenceCo
 	        ((hwMillis() - CSMA_START_MS) < MY_RFM69_CSMA_TIMEOUT_MS)) {
 		doYield();
 	}
-	// set radio to standby to load fifo
-	(void)RFM69_setRadioMode(RFM69_RADIO_MODE_STDBY);
 	if (increaseSequenceCounter) {
 		// increase sequence counter, overflow is ok
 		RFM69.txSequenceNumber++;
 	}
-	// clear FIFO and flags
-	RFM69_clearFIFO();
 	// assign sequence number
 	packet->header.sequenceNumber = RFM69.txSequenceNumber;
-
-	// write packet
-	const uint8_t finalLen = packet->payloadLen + RFM69_HEADER_LEN; // including length byte
-	(void)RFM69_burstWriteReg(RFM69_REG_FIFO, packet->data, finalLen);
-
-	// send message
-	(void)RFM69_setRadioMode(RFM69_RADIO_MODE_TX); // irq upon txsent
+	RFM69_startTransmission(packet);
 	const uint32_t txStartMS = hwMillis();
 	while (!RFM69_irq && (hwMillis() - txStartMS < MY_RFM69_TX_TIMEOUT_MS)) {
 		doYield();
@@ -423,6 +548,7 @@ LOCAL bool RFM69_send(const uint8_t recipient, uint8_t *data, const uint8_t len,
 	packet.header.packetLen = packet.payloadLen + (RFM69_HEADER_LEN - 1); // -1 length byte
 	return RFM69_sendFrame(&packet, increaseSequenceCounter);
 }
+#endif
 
 LOCAL void RFM69_setFrequency(const uint32_t frequencyHz)
 {
@@ -497,6 +623,7 @@ LOCAL bool RFM69_setRadioMode(const rfm69_radio_mode_t newRadioMode)
 	}
 
 	uint8_t regMode;
+	RFM69_spiBeginQueue();
 
 	if (newRadioMode == RFM69_RADIO_MODE_STDBY) {
 		regMode = RFM69_OPMODE_SEQUENCER_ON | RFM69_OPMODE_LISTEN_OFF | RFM69_OPMODE_STANDBY;
@@ -523,6 +650,7 @@ LOCAL bool RFM69_setRadioMode(const rfm69_radio_mode_t newRadioMode)
 
 	// set new mode
 	RFM69_writeReg(RFM69_REG_OPMODE, regMode);
+	RFM69_spiEndQueue();
 
 	// Waking from sleep mode may take longer
 	if (RFM69.radioMode == RFM69_RADIO_MODE_SLEEP) {
@@ -553,12 +681,18 @@ LOCAL void RFM69_powerDown(void)
 
 LOCAL bool RFM69_sleep(void)
 {
+#if defined(RFM69_TX_QUEUE)
+	RFM69_txFlush();
+#endif
 	RFM69_DEBUG(PSTR("RFM69:RSL\n"));	// put radio to sleep
 	return RFM69_setRadioMode(RFM69_RADIO_MODE_SLEEP);
 }
 
 LOCAL bool RFM69_standBy(void)
 {
+#if defined(RFM69_TX_QUEUE)
+	RFM69_txFlush();
+#endif
 	RFM69_DEBUG(PSTR("RFM69:RSB\n"));	// put radio to standby
 	return RFM69_setRadioMode(RFM69_RADIO_MODE_STDBY);
 }
@@ -576,7 +710,18 @@ LOCAL void RFM69_sendACK(const uint8_t recipient, const rfm69_sequenceNumber_t s
 	rfm69_controlFlags_t flags = 0u;	// reset flags
 	RFM69_setACKReceived(flags, true);
 	RFM69_setACKRSSIReport(flags, true);
-	(void)RFM69_send(recipient, (uint8_t *)&ACK, sizeof(rfm69_ack_t), flags);
+#if defined(RFM69_TX_QUEUE)
+#if defined(MY_GATEWAY_FEATURE) && (F_CPU>16*1000000ul)
+	// delay for fast GW and slow nodes, without blocking
+	const uint16_t delayMS = 50u;
+#else
+	const uint16_t delayMS = 0u;
+#endif
+	(void)RFM69_txEnqueue(recipient, &ACK, sizeof(rfm69_ack_t), flags, sequenceNumber, delayMS);
+#else
+	// ACKs keep the sequence number, they may be sent while waiting for an ACK
+	(void)RFM69_send(recipient, (uint8_t *)&ACK, sizeof(rfm69_ack_t), flags, false);
+#endif
 }
 
 LOCAL bool RFM69_executeATC(const rfm69_RSSI_t currentRSSI, const rfm69_RSSI_t targetRSSI)
@@ -611,6 +756,17 @@ LOCAL void RFM69_ATCmode(const bool onOff, const int16_t targetRSSI)
 LOCAL bool RFM69_sendWithRetry(const uint8_t recipient, const void *buffer,
                                const uint8_t bufferSize, const bool noACK)
 {
+#if defined(RFM69_TX_QUEUE)
+	rfm69_controlFlags_t flags = 0u; // reset all flags
+	RFM69_setACKRequested(flags, !noACK);
+	RFM69_setACKRSSIReport(flags, RFM69.ATCenabled);
+	// increase sequence counter, overflow is ok
+	const bool result = RFM69_txEnqueue(recipient, buffer, bufferSize, flags,
+	                                    ++RFM69.txSequenceNumber, 0u);
+	// start right away if the radio is idle
+	RFM69_txProcess();
+	return result;
+#else
 	for (uint8_t retry = 0; retry < RFM69_RETRIES; retry++) {
 		RFM69_DEBUG(PSTR("RFM69:SWR:SEND,TO=%" PRIu8 ",SEQ=%" PRIu16 ",RETRY=%" PRIu8 "\n"), recipient,
 		            RFM69.txSequenceNumber,retry);
@@ -651,8 +807,229 @@ LOCAL bool RFM69_sendWithRetry(const uint8_t recipient, const void *buffer,
 		RFM69_DEBUG(PSTR("!RFM69:SWR:NACK\n"));
 	}
 	return false;
+#endif
+}
+
+#if defined(RFM69_TX_QUEUE)
+LOCAL void RFM69_registerSendCallback(rfm69_sendCallbackType cb)
+{
+	RFM69_sendCallback = cb;
+}
+
+LOCAL bool RFM69_txEnqueue(const uint8_t recipient, const void *data, const uint8_t len,
+                           const rfm69_controlFlags_t flags, const rfm69_sequenceNumber_t sequenceNumber,
+                           const uint16_t delayMS)
+{
+	for (uint8_t i = 0; i < MY_RFM69_TX_QUEUE_SIZE; i++) {
+		rfm69_txEntry_t *entry = &RFM69_txQueue[i];
+		if (entry->state == RFM69_TX_FREE) {
+			entry->packet.header.version = RFM69_PACKET_HEADER_VERSION;
+			entry->packet.header.sender = RFM69.address;
+			entry->packet.header.recipient = recipient;
+			entry->packet.header.controlFlags = flags;
+			entry->packet.header.sequenceNumber = sequenceNumber;
+			entry->packet.payloadLen = min(len, (uint8_t)RFM69_MAX_PAYLOAD_LEN);
+			(void)memcpy((void *)&entry->packet.payload, data, entry->packet.payloadLen);
+			entry->packet.header.packetLen = entry->packet.payloadLen + (RFM69_HEADER_LEN - 1); // -1 length byte
+			entry->timestamp = hwMillis();
+			entry->timeout = delayMS;
+			entry->order = RFM69_txOrder++;
+			entry->retries = 0;
+			entry->state = RFM69_TX_PENDING;
+			RFM69_DEBUG(PSTR("RFM69:TXQ:ADD,TO=%" PRIu8 ",SEQ=%" PRIu16 "\n"), recipient, sequenceNumber);
+#if defined(__linux__)
+			EventLoop.setTimeout(delayMS);
+#endif
+			return true;
+		}
+	}
+	RFM69_DEBUG(PSTR("!RFM69:TXQ:FULL,TO=%" PRIu8 "\n"), recipient);
+	return false;
 }
 
+LOCAL uint8_t RFM69_txPending(void)
+{
+	uint8_t count = 0;
+	for (uint8_t i = 0; i < MY_RFM69_TX_QUEUE_SIZE; i++) {
+		count += RFM69_txQueue[i].state != RFM69_TX_FREE;
+	}
+	return count;
+}
+
+LOCAL void RFM69_txComplete(const uint8_t index, const bool success)
+{
+	rfm69_txEntry_t *entry = &RFM69_txQueue[index];
+	entry->state = RFM69_TX_FREE;
+	if (RFM69_getACKReceived(entry->packet.header.controlFlags)) {
+		// ACK frames are not reported
+		return;
+	}
+	if (!success) {
+		RFM69_DEBUG(PSTR("!RFM69:TXQ:FAIL,TO=%" PRIu8 ",SEQ=%" PRIu16 "\n"),
+		            entry->packet.header.recipient, entry->packet.header.sequenceNumber);
+	}
+	if (RFM69_sendCallback != NULL) {
+		RFM69_sendCallback(entry->packet.header.recipient, success);
+	}
+}
+
+LOCAL void RFM69_txRetry(const uint8_t index)
+{
+	rfm69_txEntry_t *entry = &RFM69_txQueue[index];
+	if (++entry->retries >= RFM69_RETRIES) {
+		RFM69_txComplete(index, false);
+		return;
+	}
+	// random backoff, frames to other recipients may go first
+	entry->state = RFM69_TX_PENDING;
+	entry->timestamp = hwMillis();
+	entry->timeout = random(RFM69_CSMA_BACKOFF_MS);
+}
+
+LOCAL void RFM69_txReceiveACK(void)
+{
+	const uint8_t sender = RFM69.currentPacket.header.sender;
+	const rfm69_sequenceNumber_t ACKsequenceNumber = RFM69.currentPacket.ACK.sequenceNumber;
+	const rfm69_controlFlags_t ACKflags = RFM69.currentPacket.header.controlFlags;
+	const rfm69_RSSI_t ACKRSSI = RFM69.currentPacket.ACK.RSSI;
+	RFM69.ackReceived = false;
+	// packet read, back to RX
+	(void)RFM69_setRadioMode(RFM69_RADIO_MODE_RX);
+	for (uint8_t i = 0; i < MY_RFM69_TX_QUEUE_SIZE; i++) {
+		const rfm69_txEntry_t *entry = &RFM69_txQueue[i];
+		if (entry->state == RFM69_TX_WAIT_ACK && entry->packet.header.recipient == sender &&
+		        entry->packet.header.sequenceNumber == ACKsequenceNumber) {
+			RFM69_DEBUG(PSTR("RFM69:TXQ:ACK,FROM=%" PRIu8 ",SEQ=%" PRIu8 ",RSSI=%" PRIi16 "\n"), sender,
+			            ACKsequenceNumber, RFM69_internalToRSSI(ACKRSSI));
+			// ATC
+			if (RFM69.ATCenabled && RFM69_getACKRSSIReport(ACKflags)) {
+				(void)RFM69_executeATC(ACKRSSI, RFM69.ATCtargetRSSI);
+			}
+			RFM69_txComplete(i, true);
+			return;
+		}
+	}
+}
+
+LOCAL uint8_t RFM69_txSelect(void)
+{
+	uint8_t next = RFM69_TX_NONE;
+	bool waitingForACK = false;
+	for (uint8_t i = 0; i < MY_RFM69_TX_QUEUE_SIZE; i++) {
+		waitingForACK |= RFM69_txQueue[i].state == RFM69_TX_WAIT_ACK;
+	}
+	for (uint8_t i = 0; i < MY_RFM69_TX_QUEUE_SIZE; i++) {
+		const rfm69_txEntry_t *entry = &RFM69_txQueue[i];
+		if (entry->state != RFM69_TX_PENDING || hwMillis() - entry->timestamp < entry->timeout) {
+			continue;
+		}
+		if (RFM69_getACKReceived(entry->packet.header.controlFlags)) {
+			// ACKs for received frames go first
+			return i;
+		}
+		if (waitingForACK) {
+			// stay in RX until the outstanding ACK arrived or timed out
+			continue;
+		}
+		bool first = true;
+		for (uint8_t j = 0; j < MY_RFM69_TX_QUEUE_SIZE; j++) {
+			const rfm69_txEntry_t *other = &RFM69_txQueue[j];
+			if (other->state != RFM69_TX_FREE &&
+			        other->packet.header.recipient == entry->packet.header.recipient &&
+			        !RFM69_getACKReceived(other->packet.header.controlFlags) &&
+			        (int16_t)(other->order - entry->order) < 0) {
+				first = false;
+				break;
+			}
+		}
+		if (first && (next == RFM69_TX_NONE ||
+		              (int16_t)(entry->order - RFM69_txQueue[next].order) < 0)) {
+			next = i;
+		}
+	}
+	return next;
+}
+
+LOCAL void RFM69_txProcess(void)
+{
+	const uint32_t now = hwMillis();
+	for (uint8_t i = 0; i < MY_RFM69_TX_QUEUE_SIZE; i++) {
+		const rfm69_txEntry_t *entry = &RFM69_txQueue[i];
+		if (entry->state == RFM69_TX_WAIT_ACK && now - entry->timestamp >= entry->timeout) {
+			RFM69_DEBUG(PSTR("!RFM69:TXQ:NACK,TO=%" PRIu8 ",SEQ=%" PRIu16 "\n"),
+			            entry->packet.header.recipient, entry->packet.header.sequenceNumber);
+			RFM69_txRetry(i);
+		}
+	}
+	if (RFM69_txActive != RFM69_TX_NONE) {
+		rfm69_txEntry_t *entry = &RFM69_txQueue[RFM69_txActive];
+		if (!RFM69_txOnAir) {
+			// CSMA: no CAD mode, sample RSSI in RX
+			if (RFM69.dataReceived) {
+				// incoming packet, frame stays pending and is sent once the packet was read
+			} else if (now - RFM69_txPhaseMS < 1u) {
+				// timing for correct RSSI sampling
+				return;
+			} else if (!RFM69_channelFree() && now - RFM69_txPhaseMS < MY_RFM69_CSMA_TIMEOUT_MS) {
+				return;
+			} else {
+				RFM69_DEBUG(PSTR("RFM69:TXQ:SEND,TO=%" PRIu8 ",SEQ=%" PRIu16 ",RETRY=%" PRIu8 "\n"),
+				            entry->packet.header.recipient, entry->packet.header.sequenceNumber, entry->retries);
+				RFM69_startTransmission(&entry->packet);
+				RFM69_txOnAir = true;
+				RFM69_txPhaseMS = now;
+				return;
+			}
+		} else if (RFM69.radioMode == RFM69_RADIO_MODE_TX) {
+			if (now - RFM69_txPhaseMS < MY_RFM69_TX_TIMEOUT_MS) {
+				return;
+			}
+			RFM69_DEBUG(PSTR("!RFM69:TXQ:TIMEOUT\n"));
+			(void)RFM69_setRadioMode(RFM69_RADIO_MODE_STDBY);
+			RFM69_txRetry(RFM69_txActive);
+		} else {
+			// TX done, radio is in RX
+			if (RFM69_getACKRequested(entry->packet.header.controlFlags)) {
+				entry->state = RFM69_TX_WAIT_ACK;
+				entry->timestamp = now;
+				entry->timeout = RFM69_RETRY_TIMEOUT_MS;
+			} else {
+				RFM69_txComplete(RFM69_txActive, true);
+			}
+		}
+		RFM69_txActive = RFM69_TX_NONE;
+	}
+	if (RFM69.dataReceived || RFM69.radioMode == RFM69_RADIO_MODE_SLEEP) {
+		// received packet not read yet, or radio asleep
+		return;
+	}
+	const uint8_t next = RFM69_txSelect();
+	if (next != RFM69_TX_NONE) {
+		// ensure we are in RX for correct RSSI sampling, dirty hack to enforce rx restart :)
+		RFM69.radioMode = RFM69_RADIO_MODE_STDBY;
+		(void)RFM69_setRadioMode(RFM69_RADIO_MODE_RX);
+		RFM69_txActive = next;
+		RFM69_txOnAir = false;
+		RFM69_txPhaseMS = now;
+	}
+#if defined(__linux__)
+	// wake up the main loop for the next backoff or ACK timeout
+	if (RFM69_txPending()) {
+		EventLoop.setTimeout(RFM69_CSMA_BACKOFF_MS / 10);
+	}
+#endif
+}
+
+LOCAL void RFM69_txFlush(void)
+{
+	// a received packet has to be read first, the radio cannot send meanwhile
+	while (RFM69_txPending() && !RFM69.dataReceived) {
+		doYield();
+		RFM69_handler();
+	}
+}
+#endif
+
 LOCAL int16_t RFM69_getSendingRSSI(void)
 {
 	// own RSSI, as measured by the recipient - ACK part
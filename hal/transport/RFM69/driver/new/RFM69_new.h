@@ -56,6 +56,13 @@
 * | | RFM69 | SWR  | SEND,TO=%%d,SEQ=%%d,RETRY=%%d        | Send to (TO), sequence number (SWQ), retry if no ACK received (RETRY)
 * | | RFM69 | SWR  | ACK,FROM=%%d,SEQ=%%d,RSSI=%%d        | ACK received from (FROM), sequence nr (SEQ), ACK RSSI (RSSI)
 * |!| RFM69 | SWR  | NACK                                 | Message sent, no ACK received
+* | | RFM69 | TXQ  | ADD,TO=%%d,SEQ=%%d                   | Frame to (TO) with sequence nr (SEQ) queued for transmission
+* |!| RFM69 | TXQ  | FULL,TO=%%d                          | TX queue full, frame to (TO) dropped
+* | | RFM69 | TXQ  | SEND,TO=%%d,SEQ=%%d,RETRY=%%d        | Transmit queued frame to (TO), sequence nr (SEQ), retry counter (RETRY)
+* |!| RFM69 | TXQ  | TIMEOUT                              | Packet sent IRQ missing, transmission rescheduled
+* | | RFM69 | TXQ  | ACK,FROM=%%d,SEQ=%%d,RSSI=%%d        | ACK for queued frame received from (FROM), sequence nr (SEQ), ACK RSSI (RSSI)
+* |!| RFM69 | TXQ  | NACK,TO=%%d,SEQ=%%d                  | No ACK received for frame to (TO), sequence nr (SEQ)
+* |!| RFM69 | TXQ  | FAIL,TO=%%d,SEQ=%%d                  | Frame to (TO), sequence nr (SEQ) dropped after all retries
 * | | RFM69 | SPP  | PCT=%%d,TX LEVEL=%%d                 | Set TX level, input TX percent (PCT)
 * | | RFM69 | RSL  |                                      | Radio in sleep mode
 * | | RFM69 | RSB  |                                      | Radio in standby mode
@@ -135,6 +142,7 @@
 #define RFM69_RETRIES                    (5u)				//!< Retries in case of failed transmission
 #define RFM69_RETRY_TIMEOUT_MS           (200ul)		//!< Timeout for ACK, adjustments needed if modem configuration changed (air time different)
 #define RFM69_MODE_READY_TIMEOUT_MS      (50ul)			//!< Timeout for mode ready
+#define RFM69_SPI_QUEUE_SIZE             (6u)				//!< Register writes sent in one SPI message (Linux)
 
 #define RFM69_ACK_REQUESTED              (7u)				//!< RFM69 header, controlFlag, bit 7
 #define RFM69_ACK_RECEIVED               (6u)				//!< RFM69 header, controlFlag, bit 6
@@ -329,12 +337,60 @@ typedef struct {
 	uint8_t reserved : 2;                      //!< Reserved
 } rfm69_internal_t;
 
+#if (MY_RFM69_TX_QUEUE_SIZE > 0)
+#define RFM69_TX_QUEUE                   //!< Non-blocking TX engine
+#define RFM69_TX_NONE                    (0xFFu)			//!< No queued frame in CSMA or TX
+#define RFM69_CSMA_BACKOFF_MS            (100u)			//!< Max. random backoff before a retry
+
+/**
+* @brief State of a TX queue slot
+*/
+typedef enum {
+	RFM69_TX_FREE = 0,							//!< Slot unused
+	RFM69_TX_PENDING = 1,						//!< Waiting for (re-)transmission
+	RFM69_TX_WAIT_ACK = 2						//!< Sent, waiting for ACK
+} rfm69_txState_t;
+
+/**
+* @brief Queued outgoing frame
+*/
+typedef struct {
+	rfm69_packet_t packet;						//!< Frame, including sequence number
+	uint32_t timestamp;							//!< Entering the current state
+	uint16_t timeout;							//!< PENDING: backoff, WAIT_ACK: ACK timeout
+	uint16_t order;								//!< Queue order, frames to the same recipient leave in order
+	uint8_t retries;							//!< Failed transmission attempts
+	rfm69_txState_t state;						//!< Slot state
+} rfm69_txEntry_t;
+
+/**
+* @brief Callback type for completed transmissions
+*/
+typedef void (*rfm69_sendCallbackType)(const uint8_t recipient, const bool success);
+#endif
+
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+/**
+* @brief Callback type for received packets
+*/
+typedef void (*rfm69_receiveCallbackType)(void);
+#endif
+
 #define LOCAL static		//!< static
 
 /**
 * @brief RFM69_handler
 */
 LOCAL void RFM69_handler(void);
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+/**
+* @brief Register a callback, which is called from RFM69_handler() for every packet received.
+* @note The callback _must_ retrieve the packet by calling RFM69_receive(), the radio
+* returns to RX afterwards.
+* @param cb
+*/
+LOCAL void RFM69_registerReceiveCallback(rfm69_receiveCallbackType cb);
+#endif
 
 /**
 * @brief Clear flags and FIFO
@@ -379,12 +435,13 @@ LOCAL bool RFM69_available(void);
 
 /**
 * @brief If a valid message is received, copy it to buf and return length. 0 byte messages are permitted.
-* @param buf Location to copy the received message
+* @param buf Location to copy the received message, NULL to drop the packet without sending a requested ACK
 * @param maxBufSize Max buffer size
 * @return Number of bytes
 */
 LOCAL uint8_t RFM69_receive(uint8_t *buf, const uint8_t maxBufSize);
 
+#if !defined(RFM69_TX_QUEUE)
 /**
 * @brief RFM69_sendFrame
 * @param packet
@@ -404,6 +461,13 @@ LOCAL bool RFM69_sendFrame(rfm69_packet_t *packet, const bool increaseSequenceCo
 */
 LOCAL bool RFM69_send(const uint8_t recipient, uint8_t *data, const uint8_t len,
                       const rfm69_controlFlags_t flags, const bool increaseSequenceCounter = true);
+#endif
+
+/**
+* @brief Load a packet into the TX FIFO and start transmission
+* @param packet
+*/
+LOCAL void RFM69_startTransmission(rfm69_packet_t *packet);
 
 /**
 * @brief Sets the transmitter and receiver center frequency
@@ -473,6 +537,44 @@ LOCAL bool RFM69_sendWithRetry(const uint8_t recipient, const void *buffer,
                                const uint8_t bufferSize,
                                const bool noACK);
 
+#if defined(RFM69_TX_QUEUE)
+/**
+* @brief Register a callback, which is called when a queued frame was acknowledged or failed
+* @param cb Callback, called with recipient and result
+*/
+LOCAL void RFM69_registerSendCallback(rfm69_sendCallbackType cb);
+/**
+* @brief Add a frame to the TX queue
+* @param recipient
+* @param data
+* @param len
+* @param flags Control flags
+* @param sequenceNumber
+* @param delayMS Earliest transmission, relative to now
+* @return True if queued
+*/
+LOCAL bool RFM69_txEnqueue(const uint8_t recipient, const void *data, const uint8_t len,
+                           const rfm69_controlFlags_t flags, const rfm69_sequenceNumber_t sequenceNumber,
+                           const uint16_t delayMS);
+/**
+* @brief TX engine: handle timeouts, start the next frame when the radio is idle
+*/
+LOCAL void RFM69_txProcess(void);
+/**
+* @brief Match a received ACK against frames waiting for it
+*/
+LOCAL void RFM69_txReceiveACK(void);
+/**
+* @brief Number of queued frames
+* @return Used slots in the TX queue
+*/
+LOCAL uint8_t RFM69_txPending(void);
+/**
+* @brief Process the TX queue until it is empty
+*/
+LOCAL void RFM69_txFlush(void);
+#endif
+
 /**
 * @brief RFM69_setRadioMode
 * @param newRadioMode
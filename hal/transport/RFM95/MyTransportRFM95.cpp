@@ -19,6 +19,22 @@
 
 #include "hal/transport/RFM95/driver/RFM95.h"
 
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+static void transportRxCallback(void)
+{
+	// Called for each packet received by the radio, from RFM95_handler().
+	// This function _must_ call RFM95_receive() to get the radio back to RX!
+	transportRxFrame_t *frame = transportHALRxReserve();
+	if (frame != NULL) {
+		frame->length = RFM95_receive(frame->data, MY_TRANSPORT_MAX_FRAME_SIZE);
+		transportHALRxPush(frame);
+	} else {
+		// Queue is full. Discard packet without ACK, the sender will retry.
+		(void)RFM95_receive(NULL, 0);
+	}
+}
+#endif
+
 bool transportInit(void)
 {
 	const bool result = RFM95_initialise(MY_RFM95_FREQUENCY);
@@ -28,6 +44,12 @@ bool transportInit(void)
 #if !defined(MY_GATEWAY_FEATURE) && !defined(MY_RFM95_ATC_MODE_DISABLED)
 	// only enable ATC mode in nodes
 	RFM95_ATCmode(true, MY_RFM95_ATC_TARGET_RSSI);
+#endif
+#if defined(RFM95_TX_QUEUE)
+	RFM95_registerSendCallback(transportSendComplete);
+#endif
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+	RFM95_registerReceiveCallback(transportRxCallback);
 #endif
 	return result;
 }
@@ -47,6 +69,13 @@ bool transportSend(const uint8_t to, const void *data, const uint8_t len, const
 	return RFM95_sendWithRetry(to, data, len, noACK);
 }
 
+#if defined(RFM95_TX_QUEUE)
+uint8_t transportGetTxQueueFree(void)
+{
+	return MY_RFM95_TX_QUEUE_SIZE - RFM95_txPending();
+}
+#endif
+
 bool transportDataAvailable(void)
 {
 	RFM95_handler();
@@ -60,7 +89,7 @@ bool transportSanityCheck(void)
 
 uint8_t transportReceive(void *data)
 {
-	uint8_t len = RFM95_receive((uint8_t *)data, MAX_MESSAGE_SIZE);
+	uint8_t len = RFM95_receive((uint8_t *)data, MY_TRANSPORT_MAX_FRAME_SIZE);
 	return len;
 }
 
@@ -38,10 +38,27 @@
 rfm95_internal_t RFM95;	//!< internal variables
 volatile uint8_t RFM95_irq; //<! rfm95 irq flag
 
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+LOCAL rfm95_receiveCallbackType RFM95_receiveCallback = NULL;
+#endif
+
+#if defined(RFM95_TX_QUEUE)
+LOCAL rfm95_txEntry_t RFM95_txQueue[MY_RFM95_TX_QUEUE_SIZE];
+LOCAL uint8_t RFM95_txActive = RFM95_TX_NONE;	// slot in CAD or TX
+LOCAL uint32_t RFM95_txPhaseMS;	// start of CAD or TX
+LOCAL uint16_t RFM95_txOrder = 0;
+LOCAL rfm95_sendCallbackType RFM95_sendCallback = NULL;
+#endif
+
 #if defined(__linux__)
 // SPI RX and TX buffers (max packet len + 1 byte for the command)
 uint8_t RFM95_spi_rxbuff[RFM95_MAX_PACKET_LEN + 1];
 uint8_t RFM95_spi_txbuff[RFM95_MAX_PACKET_LEN + 1];
+// queued register writes, sent in one SPI message
+LOCAL uint8_t RFM95_spi_queuebuff[RFM95_SPI_QUEUE_SIZE][RFM95_MAX_PACKET_LEN + 1];
+LOCAL uint8_t RFM95_spi_queuelen[RFM95_SPI_QUEUE_SIZE];
+LOCAL uint8_t RFM95_spi_queueCount = 0;
+LOCAL uint8_t RFM95_spi_queueDepth = 0; // nesting level of RFM95_spiBeginQueue(), the SPI lock is held while > 0
 #endif
 
 LOCAL void RFM95_csn(const bool level)
@@ -53,11 +70,77 @@ LOCAL void RFM95_csn(const bool level)
 #endif
 }
 
+LOCAL void RFM95_spiFlushQueue(void)
+{
+#if defined(__linux__)
+	if (!RFM95_spi_queueCount) {
+		return;
+	}
+	RFM95_SPI.beginTransaction(SPISettings(MY_RFM95_SPI_SPEED, RFM95_SPI_DATA_ORDER,
+	                                       RFM95_SPI_DATA_MODE));
+	for (uint8_t i = 0; i < RFM95_spi_queueCount; i++) {
+		RFM95_SPI.queueTransfer(RFM95_spi_queuebuff[i], NULL, RFM95_spi_queuelen[i]);
+	}
+	RFM95_SPI.transferQueued();
+	RFM95_SPI.endTransaction();
+	RFM95_spi_queueCount = 0;
+#endif
+}
+
+// queue register writes until RFM95_spiEndQueue() or a register is read (Linux only)
+LOCAL void RFM95_spiBeginQueue(void)
+{
+#if defined(__linux__)
+	// the SPI lock is kept until RFM95_spiEndQueue(), an IRQ thread cannot access the queue meanwhile
+	RFM95_SPI.beginTransaction(SPISettings(MY_RFM95_SPI_SPEED, RFM95_SPI_DATA_ORDER,
+	                                       RFM95_SPI_DATA_MODE));
+	RFM95_spi_queueDepth++;
+#endif
+}
+
+LOCAL void RFM95_spiEndQueue(void)
+{
+#if defined(__linux__)
+	// the queue state is only accessed while holding the SPI lock
+	RFM95_SPI.beginTransaction(SPISettings(MY_RFM95_SPI_SPEED, RFM95_SPI_DATA_ORDER,
+	                                       RFM95_SPI_DATA_MODE));
+	if (RFM95_spi_queueDepth) {
+		if (!--RFM95_spi_queueDepth) {
+			RFM95_spiFlushQueue();
+		}
+		// release the lock taken by RFM95_spiBeginQueue()
+		RFM95_SPI.endTransaction();
+	}
+	RFM95_SPI.endTransaction();
+#endif
+}
+
 LOCAL uint8_t RFM95_spiMultiByteTransfer(const uint8_t cmd, uint8_t *buf, uint8_t len,
         const bool aReadMode)
 {
 	uint8_t status;
 	uint8_t *current = buf;
+#if defined(__linux__)
+	// the queue state is only accessed while holding the SPI lock
+	RFM95_SPI.beginTransaction(SPISettings(MY_RFM95_SPI_SPEED, RFM95_SPI_DATA_ORDER,
+	                                       RFM95_SPI_DATA_MODE));
+	if (RFM95_spi_queueDepth && !aReadMode) {
+		if (RFM95_spi_queueCount == RFM95_SPI_QUEUE_SIZE) {
+			RFM95_spiFlushQueue();
+		}
+		uint8_t *ptx = RFM95_spi_queuebuff[RFM95_spi_queueCount];
+		RFM95_spi_queuelen[RFM95_spi_queueCount++] = len + 1;
+		*ptx = cmd;
+		if (current != NULL) {
+			(void)memcpy(ptx + 1, current, len);
+		}
+		RFM95_SPI.endTransaction();
+		return 0; // status is not known until the queue is sent
+	}
+	// keep register accesses in order
+	RFM95_spiFlushQueue();
+	RFM95_SPI.endTransaction();
+#endif
 #if !defined(MY_SOFTSPI) && defined(SPI_HAS_TRANSACTION)
 	RFM95_SPI.beginTransaction(SPISettings(MY_RFM95_SPI_SPEED, RFM95_SPI_DATA_ORDER,
 	                                       RFM95_SPI_DATA_MODE));
@@ -281,6 +364,11 @@ LOCAL void RFM95_interruptHandling(void)
 	}
 	// Clear IRQ flags
 	RFM95_writeReg(RFM95_REG_12_IRQ_FLAGS, RFM95_CLEAR_IRQ);
+#if defined(RFM95_TX_QUEUE)
+	if (RFM95.ackReceived) {
+		RFM95_txReceiveACK();
+	}
+#endif
 }
 
 LOCAL void RFM95_handler(void)
@@ -289,8 +377,27 @@ LOCAL void RFM95_handler(void)
 		RFM95_irq = false;
 		RFM95_interruptHandling();
 	}
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+	if (RFM95.dataReceived && RFM95_receiveCallback != NULL) {
+		RFM95_receiveCallback();
+		if (RFM95.radioMode == RFM95_RADIO_MODE_STDBY) {
+			// packet read, back to RX
+			(void)RFM95_setRadioMode(RFM95_RADIO_MODE_RX);
+		}
+	}
+#endif
+#if defined(RFM95_TX_QUEUE)
+	RFM95_txProcess();
+#endif
 }
 
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+LOCAL void RFM95_registerReceiveCallback(rfm95_receiveCallbackType cb)
+{
+	RFM95_receiveCallback = cb;
+}
+#endif
+
 LOCAL bool RFM95_available(void)
 {
 	if (RFM95.dataReceived) {
@@ -298,6 +405,11 @@ LOCAL bool RFM95_available(void)
 		return true;
 	} else if (RFM95.radioMode == RFM95_RADIO_MODE_TX) {
 		return false;
+#if defined(RFM95_TX_QUEUE)
+	} else if (RFM95_txActive != RFM95_TX_NONE) {
+		// queued frame in CAD
+		return false;
+#endif
 	} else if (RFM95.radioMode != RFM95_RADIO_MODE_RX) {
 		// we are not in RX, not CAD, and no data received
 		(void)RFM95_setRadioMode(RFM95_RADIO_MODE_RX);
@@ -319,8 +431,8 @@ LOCAL uint8_t RFM95_receive(uint8_t *buf, const uint8_t maxBufSize)
 	// clear data flag
 	RFM95.dataReceived = false;
 	// ACK handling
-	if (RFM95_getACKRequested(controlFlags) && !RFM95_getACKReceived(controlFlags)) {
-#if defined(MY_GATEWAY_FEATURE) && (F_CPU>16*1000000ul)
+	if (buf != NULL && RFM95_getACKRequested(controlFlags) && !RFM95_getACKReceived(controlFlags)) {
+#if defined(MY_GATEWAY_FEATURE) && (F_CPU>16*1000000ul) && !defined(RFM95_TX_QUEUE)
 		// delay for fast GW and slow nodes
 		delay(50);
 #endif
@@ -329,6 +441,23 @@ LOCAL uint8_t RFM95_receive(uint8_t *buf, const uint8_t maxBufSize)
 	return payloadLen;
 }
 
+LOCAL void RFM95_startTransmission(rfm95_packet_t *packet)
+{
+	// FIFO writes are sent together with the mode change to TX
+	RFM95_spiBeginQueue();
+	// Position at the beginning of the TX FIFO
+	(void)RFM95_writeReg(RFM95_REG_0D_FIFO_ADDR_PTR, RFM95_TX_FIFO_ADDR);
+	// write packet
+	const uint8_t finalLen = packet->payloadLen + RFM95_HEADER_LEN;
+	(void)RFM95_burstWriteReg(RFM95_REG_00_FIFO, packet->data, finalLen);
+	// total payload length
+	(void)RFM95_writeReg(RFM95_REG_22_PAYLOAD_LENGTH, finalLen);
+	// send message, if sent, irq fires and radio returns to standby
+	(void)RFM95_setRadioMode(RFM95_RADIO_MODE_TX);
+	RFM95_spiEndQueue();
+}
+
+#if !defined(RFM95_TX_QUEUE)
 LOCAL bool RFM95_sendFrame(rfm95_packet_t *packet, const bool increaseSequenceCounter)
 {
 	// Check channel activity
@@ -341,15 +470,7 @@ LOCAL bool RFM95_sendFrame(rfm95_packet_t *packet, const bool increaseSequenceCo
 		RFM95.txSequenceNumber++;
 	}
 	packet->header.sequenceNumber = RFM95.txSequenceNumber;
-	// Position at the beginning of the TX FIFO
-	(void)RFM95_writeReg(RFM95_REG_0D_FIFO_ADDR_PTR, RFM95_TX_FIFO_ADDR);
-	// write packet
-	const uint8_t finalLen = packet->payloadLen + RFM95_HEADER_LEN;
-	(void)RFM95_burstWriteReg(RFM95_REG_00_FIFO, packet->data, finalLen);
-	// total payload length
-	(void)RFM95_writeReg(RFM95_REG_22_PAYLOAD_LENGTH, finalLen);
-	// send message, if sent, irq fires and radio returns to standby
-	(void)RFM95_setRadioMode(RFM95_RADIO_MODE_TX);
+	RFM95_startTransmission(packet);
 	// wait until IRQ fires or timeout
 	const uint32_t startTX_MS = hwMillis();
 	// todo: make this payload length + bit rate dependend
@@ -371,6 +492,7 @@ LOCAL bool RFM95_send(const uint8_t recipient, uint8_t *data, const uint8_t len,
 	(void)memcpy((void *)&packet.payload, (void *)data, packet.payloadLen);
 	return RFM95_sendFrame(&packet, increaseSequenceCounter);
 }
+#endif
 
 LOCAL void RFM95_setFrequency(const uint32_t frequencyHz)
 {
@@ -444,6 +566,7 @@ LOCAL bool RFM95_setRadioMode(const rfm95_radioMode_t newRadioMode)
 		return false;
 	}
 	uint8_t regMode;
+	RFM95_spiBeginQueue();
 
 	if (newRadioMode == RFM95_RADIO_MODE_STDBY) {
 		regMode = RFM95_MODE_STDBY;
@@ -463,9 +586,11 @@ LOCAL bool RFM95_setRadioMode(const rfm95_radioMode_t newRadioMode)
 		regMode = RFM95_MODE_TX;
 		(void)RFM95_writeReg(RFM95_REG_40_DIO_MAPPING1, 0x40); // Interrupt on TxDone, DIO0
 	} else {
+		RFM95_spiEndQueue();
 		return false;
 	}
 	(void)RFM95_writeReg(RFM95_REG_01_OP_MODE, regMode);
+	RFM95_spiEndQueue();
 
 	RFM95.radioMode = newRadioMode;
 	return true;
@@ -489,12 +614,18 @@ LOCAL void RFM95_powerDown(void)
 
 LOCAL bool RFM95_sleep(void)
 {
+#if defined(RFM95_TX_QUEUE)
+	RFM95_txFlush();
+#endif
 	RFM95_DEBUG(PSTR("RFM95:RSL\n"));	// put radio to sleep
 	return RFM95_setRadioMode(RFM95_RADIO_MODE_SLEEP);
 }
 
 LOCAL bool RFM95_standBy(void)
 {
+#if defined(RFM95_TX_QUEUE)
+	RFM95_txFlush();
+#endif
 	RFM95_DEBUG(PSTR("RFM95:RSB\n"));	// put radio to standby
 	return RFM95_setRadioMode(RFM95_RADIO_MODE_STDBY);
 }
@@ -514,7 +645,18 @@ LOCAL void RFM95_sendACK(const uint8_t recipient, const rfm95_sequenceNumber_t s
 	rfm95_controlFlags_t flags = 0u;
 	RFM95_setACKReceived(flags, true);
 	RFM95_setACKRSSIReport(flags, true);
-	(void)RFM95_send(recipient, (uint8_t *)&ACK, sizeof(rfm95_ack_t), flags);
+#if defined(RFM95_TX_QUEUE)
+#if defined(MY_GATEWAY_FEATURE) && (F_CPU>16*1000000ul)
+	// delay for fast GW and slow nodes, without blocking
+	const uint16_t delayMS = 50u;
+#else
+	const uint16_t delayMS = 0u;
+#endif
+	(void)RFM95_txEnqueue(recipient, &ACK, sizeof(rfm95_ack_t), flags, sequenceNumber, delayMS);
+#else
+	// ACKs keep the sequence number, they may be sent while waiting for an ACK
+	(void)RFM95_send(recipient, (uint8_t *)&ACK, sizeof(rfm95_ack_t), flags, false);
+#endif
 }
 
 LOCAL bool RFM95_executeATC(const rfm95_RSSI_t currentRSSI, const rfm95_RSSI_t targetRSSI)
@@ -541,6 +683,16 @@ LOCAL bool RFM95_executeATC(const rfm95_RSSI_t currentRSSI, const rfm95_RSSI_t t
 LOCAL bool RFM95_sendWithRetry(const uint8_t recipient, const void *buffer,
                                const uint8_t bufferSize, const bool noACK)
 {
+#if defined(RFM95_TX_QUEUE)
+	rfm95_controlFlags_t flags = 0u;
+	RFM95_setACKRequested(flags, !noACK);
+	// increase sequence counter, overflow is ok
+	const bool result = RFM95_txEnqueue(recipient, buffer, bufferSize, flags,
+	                                    ++RFM95.txSequenceNumber, 0u);
+	// start right away if the radio is idle
+	RFM95_txProcess();
+	return result;
+#else
 	for (uint8_t retry = 0; retry < RFM95_RETRIES; retry++) {
 		RFM95_DEBUG(PSTR("RFM95:SWR:SEND,TO=%" PRIu8 ",SEQ=%" PRIu16 ",RETRY=%" PRIu8 "\n"), recipient,
 		            RFM95.txSequenceNumber,
@@ -594,8 +746,232 @@ LOCAL bool RFM95_sendWithRetry(const uint8_t recipient, const void *buffer,
 		(void)RFM95_setTxPowerLevel(RFM95.powerLevel + 1);
 	}
 	return false;
+#endif
+}
+
+#if defined(RFM95_TX_QUEUE)
+LOCAL void RFM95_registerSendCallback(rfm95_sendCallbackType cb)
+{
+	RFM95_sendCallback = cb;
+}
+
+LOCAL bool RFM95_txEnqueue(const uint8_t recipient, const void *data, const uint8_t len,
+                           const rfm95_controlFlags_t flags, const rfm95_sequenceNumber_t sequenceNumber,
+                           const uint16_t delayMS)
+{
+	for (uint8_t i = 0; i < MY_RFM95_TX_QUEUE_SIZE; i++) {
+		rfm95_txEntry_t *entry = &RFM95_txQueue[i];
+		if (entry->state == RFM95_TX_FREE) {
+			entry->packet.header.version = RFM95_PACKET_HEADER_VERSION;
+			entry->packet.header.sender = RFM95.address;
+			entry->packet.header.recipient = recipient;
+			entry->packet.header.controlFlags = flags;
+			entry->packet.header.sequenceNumber = sequenceNumber;
+			entry->packet.payloadLen = min(len, (uint8_t)RFM95_MAX_PAYLOAD_LEN);
+			(void)memcpy((void *)&entry->packet.payload, data, entry->packet.payloadLen);
+			entry->timestamp = hwMillis();
+			entry->timeout = delayMS;
+			entry->order = RFM95_txOrder++;
+			entry->retries = 0;
+			entry->state = RFM95_TX_PENDING;
+			RFM95_DEBUG(PSTR("RFM95:TXQ:ADD,TO=%" PRIu8 ",SEQ=%" PRIu16 "\n"), recipient, sequenceNumber);
+#if defined(__linux__)
+			EventLoop.setTimeout(delayMS);
+#endif
+			return true;
+		}
+	}
+	RFM95_DEBUG(PSTR("!RFM95:TXQ:FULL,TO=%" PRIu8 "\n"), recipient);
+	return false;
+}
+
+LOCAL uint8_t RFM95_txPending(void)
+{
+	uint8_t count = 0;
+	for (uint8_t i = 0; i < MY_RFM95_TX_QUEUE_SIZE; i++) {
+		count += RFM95_txQueue[i].state != RFM95_TX_FREE;
+	}
+	return count;
+}
+
+LOCAL void RFM95_txComplete(const uint8_t index, const bool success)
+{
+	rfm95_txEntry_t *entry = &RFM95_txQueue[index];
+	entry->state = RFM95_TX_FREE;
+	if (RFM95_getACKReceived(entry->packet.header.controlFlags)) {
+		// ACK frames are not reported
+		return;
+	}
+	if (!success) {
+		RFM95_DEBUG(PSTR("!RFM95:TXQ:FAIL,TO=%" PRIu8 ",SEQ=%" PRIu16 "\n"),
+		            entry->packet.header.recipient, entry->packet.header.sequenceNumber);
+		if (RFM95.ATCenabled) {
+			// No ACK received, maybe out of reach: increase power level
+			(void)RFM95_setTxPowerLevel(RFM95.powerLevel + 1);
+		}
+	}
+	if (RFM95_sendCallback != NULL) {
+		RFM95_sendCallback(entry->packet.header.recipient, success);
+	}
+}
+
+LOCAL void RFM95_txRetry(const uint8_t index)
+{
+	rfm95_txEntry_t *entry = &RFM95_txQueue[index];
+	if (++entry->retries >= RFM95_RETRIES) {
+		RFM95_txComplete(index, false);
+		return;
+	}
+	// random backoff, frames to other recipients may go first
+	entry->state = RFM95_TX_PENDING;
+	entry->timestamp = hwMillis();
+	entry->timeout = random(RFM95_CSMA_BACKOFF_MS);
+}
+
+LOCAL void RFM95_txReceiveACK(void)
+{
+	const uint8_t sender = RFM95.currentPacket.header.sender;
+	const rfm95_sequenceNumber_t ACKsequenceNumber = RFM95.currentPacket.ACK.sequenceNumber;
+	const rfm95_controlFlags_t flag = RFM95.currentPacket.header.controlFlags;
+	const rfm95_RSSI_t RSSI = RFM95.currentPacket.ACK.RSSI;
+	RFM95.ackReceived = false;
+	// packet read, back to RX
+	(void)RFM95_setRadioMode(RFM95_RADIO_MODE_RX);
+	for (uint8_t i = 0; i < MY_RFM95_TX_QUEUE_SIZE; i++) {
+		const rfm95_txEntry_t *entry = &RFM95_txQueue[i];
+		if (entry->state == RFM95_TX_WAIT_ACK && entry->packet.header.recipient == sender &&
+		        entry->packet.header.sequenceNumber == ACKsequenceNumber) {
+			RFM95_DEBUG(PSTR("RFM95:TXQ:ACK FROM=%" PRIu8 ",SEQ=%" PRIu16 ",RSSI=%" PRIi16 "\n"), sender,
+			            ACKsequenceNumber, RFM95_internalToRSSI(RSSI));
+			// ATC
+			if (RFM95.ATCenabled && RFM95_getACKRSSIReport(flag)) {
+				(void)RFM95_executeATC(RSSI, RFM95.ATCtargetRSSI);
+			}
+			RFM95_txComplete(i, true);
+			return;
+		}
+	}
+}
+
+LOCAL uint8_t RFM95_txSelect(void)
+{
+	uint8_t next = RFM95_TX_NONE;
+	bool waitingForACK = false;
+	for (uint8_t i = 0; i < MY_RFM95_TX_QUEUE_SIZE; i++) {
+		waitingForACK |= RFM95_txQueue[i].state == RFM95_TX_WAIT_ACK;
+	}
+	for (uint8_t i = 0; i < MY_RFM95_TX_QUEUE_SIZE; i++) {
+		const rfm95_txEntry_t *entry = &RFM95_txQueue[i];
+		if (entry->state != RFM95_TX_PENDING || hwMillis() - entry->timestamp < entry->timeout) {
+			continue;
+		}
+		if (RFM95_getACKReceived(entry->packet.header.controlFlags)) {
+			// ACKs for received frames go first
+			return i;
+		}
+		if (waitingForACK) {
+			// stay in RX until the outstanding ACK arrived or timed out
+			continue;
+		}
+		bool first = true;
+		for (uint8_t j = 0; j < MY_RFM95_TX_QUEUE_SIZE; j++) {
+			const rfm95_txEntry_t *other = &RFM95_txQueue[j];
+			if (other->state != RFM95_TX_FREE &&
+			        other->packet.header.recipient == entry->packet.header.recipient &&
+			        !RFM95_getACKReceived(other->packet.header.controlFlags) &&
+			        (int16_t)(other->order - entry->order) < 0) {
+				first = false;
+				break;
+			}
+		}
+		if (first && (next == RFM95_TX_NONE ||
+		              (int16_t)(entry->order - RFM95_txQueue[next].order) < 0)) {
+			next = i;
+		}
+	}
+	return next;
 }
 
+LOCAL void RFM95_txProcess(void)
+{
+	const uint32_t now = hwMillis();
+	for (uint8_t i = 0; i < MY_RFM95_TX_QUEUE_SIZE; i++) {
+		const rfm95_txEntry_t *entry = &RFM95_txQueue[i];
+		if (entry->state == RFM95_TX_WAIT_ACK && now - entry->timestamp >= entry->timeout) {
+			RFM95_DEBUG(PSTR("!RFM95:TXQ:NACK,TO=%" PRIu8 ",SEQ=%" PRIu16 "\n"),
+			            entry->packet.header.recipient, entry->packet.header.sequenceNumber);
+			RFM95_txRetry(i);
+		}
+	}
+	if (RFM95_txActive != RFM95_TX_NONE) {
+		rfm95_txEntry_t *entry = &RFM95_txQueue[RFM95_txActive];
+		if (RFM95.radioMode == RFM95_RADIO_MODE_CAD) {
+			if (now - RFM95_txPhaseMS < RFM95_CAD_TIMEOUT_MS) {
+				return;
+			}
+			RFM95_DEBUG(PSTR("!RFM95:TXQ:BUSY\n"));
+			(void)RFM95_setRadioMode(RFM95_RADIO_MODE_STDBY);
+			RFM95_txRetry(RFM95_txActive);
+		} else if (RFM95.radioMode == RFM95_RADIO_MODE_STDBY) {
+			// CAD done
+			if (RFM95.channelActive) {
+				RFM95_DEBUG(PSTR("!RFM95:TXQ:BUSY\n"));
+				RFM95_txRetry(RFM95_txActive);
+			} else {
+				RFM95_DEBUG(PSTR("RFM95:TXQ:SEND,TO=%" PRIu8 ",SEQ=%" PRIu16 ",RETRY=%" PRIu8 "\n"),
+				            entry->packet.header.recipient, entry->packet.header.sequenceNumber, entry->retries);
+				RFM95_startTransmission(&entry->packet);
+				RFM95_txPhaseMS = now;
+				return;
+			}
+		} else if (RFM95.radioMode == RFM95_RADIO_MODE_TX) {
+			if (now - RFM95_txPhaseMS < MY_RFM95_TX_TIMEOUT_MS) {
+				return;
+			}
+			RFM95_DEBUG(PSTR("!RFM95:TXQ:BUSY\n"));
+			(void)RFM95_setRadioMode(RFM95_RADIO_MODE_STDBY);
+			RFM95_txRetry(RFM95_txActive);
+		} else {
+			// TX done, radio is in RX
+			if (RFM95_getACKRequested(entry->packet.header.controlFlags)) {
+				entry->state = RFM95_TX_WAIT_ACK;
+				entry->timestamp = now;
+				entry->timeout = RFM95_RETRY_TIMEOUT_MS;
+			} else {
+				RFM95_txComplete(RFM95_txActive, true);
+			}
+		}
+		RFM95_txActive = RFM95_TX_NONE;
+	}
+	if (RFM95.dataReceived || RFM95.radioMode == RFM95_RADIO_MODE_SLEEP) {
+		// received packet not read yet, or radio asleep
+		return;
+	}
+	const uint8_t next = RFM95_txSelect();
+	if (next != RFM95_TX_NONE) {
+		// receiver needs to be in STDBY before entering CAD mode
+		(void)RFM95_setRadioMode(RFM95_RADIO_MODE_STDBY);
+		(void)RFM95_setRadioMode(RFM95_RADIO_MODE_CAD);
+		RFM95_txActive = next;
+		RFM95_txPhaseMS = now;
+	}
+#if defined(__linux__)
+	// wake up the main loop for the next backoff or ACK timeout
+	if (RFM95_txPending()) {
+		EventLoop.setTimeout(RFM95_CSMA_BACKOFF_MS / 10);
+	}
+#endif
+}
+
+LOCAL void RFM95_txFlush(void)
+{
+	// a received packet has to be read first, the radio cannot send meanwhile
+	while (RFM95_txPending() && !RFM95.dataReceived) {
+		doYield();
+		RFM95_handler();
+	}
+}
+#else
 // Wait until no channel activity detected or timeout
 LOCAL bool RFM95_waitCAD(void)
 {
@@ -609,6 +985,7 @@ LOCAL bool RFM95_waitCAD(void)
 	}
 	return !RFM95.channelActive;
 }
+#endif
 
 LOCAL void RFM95_ATCmode(const bool OnOff, const int16_t targetRSSI)
 {
@@ -53,6 +53,13 @@
 * | | RFM95 | SWR  | SEND,TO=%%d,RETRY=%%d                  | Send message to (TO), NACK retry counter (RETRY)
 * | | RFM95 | SWR  | ACK FROM=%%d,SEQ=%%d,RSSI=%%d,SNR=%%d  | ACK received from node (FROM), seq ID (SEQ), (RSSI), (SNR)
 * |!| RFM95 | SWR  | NACK                                   | No ACK received
+* | | RFM95 | TXQ  | ADD,TO=%%d,SEQ=%%d                     | Frame to (TO) with seq ID (SEQ) queued for transmission
+* |!| RFM95 | TXQ  | FULL,TO=%%d                            | TX queue full, frame to (TO) dropped
+* | | RFM95 | TXQ  | SEND,TO=%%d,SEQ=%%d,RETRY=%%d          | Transmit queued frame to (TO), seq ID (SEQ), retry counter (RETRY)
+* |!| RFM95 | TXQ  | BUSY                                   | Channel busy or radio timeout, transmission rescheduled
+* | | RFM95 | TXQ  | ACK FROM=%%d,SEQ=%%d,RSSI=%%d          | ACK for queued frame received from node (FROM), seq ID (SEQ), (RSSI)
+* |!| RFM95 | TXQ  | NACK,TO=%%d,SEQ=%%d                    | No ACK received for frame to (TO), seq ID (SEQ)
+* |!| RFM95 | TXQ  | FAIL,TO=%%d,SEQ=%%d                    | Frame to (TO), seq ID (SEQ) dropped after all retries
 * | | RFM95 | SPP  | PCT=%%d,TX LEVEL=%%d                   | Set TX level percent (PCT), TX level (LEVEL)
 * | | RFM95 | PWD  |                                        | Power down radio
 * | | RFM95 | PWU  |                                        | Power up radio
@@ -161,6 +168,7 @@
 #define RFM95_RSSI_OFFSET                      (137u)			//!< RSSI offset
 #define RFM95_TARGET_RSSI                      (-70)			//!< RSSI target
 #define RFM95_PROMISCUOUS                      (false)			//!< RFM95 promiscuous mode
+#define RFM95_SPI_QUEUE_SIZE                   (5u)			//!< Register writes sent in one SPI message (Linux)
 
 #define RFM95_FXOSC                            (32*1000000ul)				//!< The crystal oscillator frequency of the module
 #define RFM95_FSTEP                            (RFM95_FXOSC / 524288.0f)	//!< The Frequency Synthesizer step
@@ -282,6 +290,45 @@ typedef struct {
 	bool reserved : 1;                        //!< unused
 } rfm95_internal_t;
 
+#if (MY_RFM95_TX_QUEUE_SIZE > 0)
+#define RFM95_TX_QUEUE                         //!< Non-blocking TX engine
+#define RFM95_TX_NONE                          (0xFFu)			//!< No queued frame on air
+#define RFM95_CSMA_BACKOFF_MS                  (100u)			//!< Max. random backoff before a retry
+
+/**
+* @brief State of a TX queue slot
+*/
+typedef enum {
+	RFM95_TX_FREE = 0,							//!< Slot unused
+	RFM95_TX_PENDING = 1,						//!< Waiting for (re-)transmission
+	RFM95_TX_WAIT_ACK = 2						//!< Sent, waiting for ACK
+} rfm95_txState_t;
+
+/**
+* @brief Queued outgoing frame
+*/
+typedef struct {
+	rfm95_packet_t packet;						//!< Frame, including sequence number
+	uint32_t timestamp;							//!< Entering the current state
+	uint16_t timeout;							//!< PENDING: backoff, WAIT_ACK: ACK timeout
+	uint16_t order;								//!< Queue order, frames to the same recipient leave in order
+	uint8_t retries;							//!< Failed transmission attempts
+	rfm95_txState_t state;						//!< Slot state
+} rfm95_txEntry_t;
+
+/**
+* @brief Callback type for completed transmissions
+*/
+typedef void (*rfm95_sendCallbackType)(const uint8_t recipient, const bool success);
+#endif
+
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+/**
+* @brief Callback type for received packets
+*/
+typedef void (*rfm95_receiveCallbackType)(void);
+#endif
+
 #define LOCAL static		//!< static
 
 /**
@@ -313,11 +360,12 @@ LOCAL void RFM95_setModemRegisters(const rfm95_modemConfig_t *config);
 LOCAL bool RFM95_available(void);
 /**
 * @brief If a valid message is received, copy it to buf and return length. 0 byte messages are permitted.
-* @param buf Location to copy the received message
+* @param buf Location to copy the received message, NULL to drop the packet without sending a requested ACK
 * @param maxBufSize Max buffer size
 * @return Number of bytes
 */
 LOCAL uint8_t RFM95_receive(uint8_t *buf, const uint8_t maxBufSize);
+#if !defined(RFM95_TX_QUEUE)
 /**
 * @brief RFM95_send
 * @param recipient
@@ -336,6 +384,12 @@ LOCAL bool RFM95_send(const uint8_t recipient, uint8_t *data, const uint8_t len,
 * @return True if frame sent
 */
 LOCAL bool RFM95_sendFrame(rfm95_packet_t *packet, const bool increaseSequenceCounter = true);
+#endif
+/**
+* @brief Load a packet into the TX FIFO and start transmission, radio must be in STDBY
+* @param packet
+*/
+LOCAL void RFM95_startTransmission(rfm95_packet_t *packet);
 /**
 * @brief RFM95_setPreambleLength
 * @param preambleLength
@@ -407,11 +461,49 @@ LOCAL void RFM95_sendACK(const uint8_t recipient, const rfm95_sequenceNumber_t s
 */
 LOCAL bool RFM95_sendWithRetry(const uint8_t recipient, const void *buffer,
                                const uint8_t bufferSize, const bool noACK);
+#if defined(RFM95_TX_QUEUE)
+/**
+* @brief Register a callback, which is called when a queued frame was acknowledged or failed
+* @param cb Callback, called with recipient and result
+*/
+LOCAL void RFM95_registerSendCallback(rfm95_sendCallbackType cb);
+/**
+* @brief Add a frame to the TX queue
+* @param recipient
+* @param data
+* @param len
+* @param flags Control flags
+* @param sequenceNumber
+* @param delayMS Earliest transmission, relative to now
+* @return True if queued
+*/
+LOCAL bool RFM95_txEnqueue(const uint8_t recipient, const void *data, const uint8_t len,
+                           const rfm95_controlFlags_t flags, const rfm95_sequenceNumber_t sequenceNumber,
+                           const uint16_t delayMS);
+/**
+* @brief TX engine: handle timeouts, start the next frame when the radio is idle
+*/
+LOCAL void RFM95_txProcess(void);
+/**
+* @brief Match a received ACK against frames waiting for it
+*/
+LOCAL void RFM95_txReceiveACK(void);
+/**
+* @brief Number of queued frames
+* @return Used slots in the TX queue
+*/
+LOCAL uint8_t RFM95_txPending(void);
+/**
+* @brief Process the TX queue until it is empty
+*/
+LOCAL void RFM95_txFlush(void);
+#else
 /**
 * @brief Wait until no channel activity detected
 * @return True if no channel activity detected, False if timeout occured
 */
 LOCAL bool RFM95_waitCAD(void);
+#endif
 
 /**
 * @brief RFM95_setRadioMode
@@ -433,6 +525,15 @@ LOCAL void RFM95_interruptHandling(void);
 * @brief RFM95_handler
 */
 LOCAL void RFM95_handler(void);
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+/**
+* @brief Register a callback, which is called from RFM95_handler() for every packet received.
+* @note The callback _must_ retrieve the packet by calling RFM95_receive(), the radio
+* returns to RX afterwards.
+* @param cb
+*/
+LOCAL void RFM95_registerReceiveCallback(rfm95_receiveCallbackType cb);
+#endif
 /**
 * @brief RFM95_getSendingRSSI
 * @return RSSI Signal strength of last packet received
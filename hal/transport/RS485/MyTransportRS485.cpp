@@ -223,17 +223,32 @@ bool _serialProcess()
 
 					switch (_recCommand) {
 					case ICSC_SYS_PACK:
+#if defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+						// buffer the packet, _data is overwritten by the next one
+						if (_recLen <= MY_TRANSPORT_MAX_FRAME_SIZE) {
+							transportRxFrame_t *frame = transportHALRxReserve();
+							if (frame != NULL) {
+								frame->length = _recLen;
+								(void)memcpy((void *)frame->data, (const void *)_data, _recLen);
+								transportHALRxPush(frame);
+							}
+						}
+#else
 						_packet_from = _recSender;
 						_packet_len = _recLen;
 						_packet_received = true;
+#endif
 						break;
 					}
 				}
 			}
 			//Clear the data
 			_serialReset();
-			//Return true, we have processed one command
+#if !defined(MY_RX_MESSAGE_BUFFER_FEATURE)
+			//Return true, we have processed one command, _data holds it until transportReceive()
 			return true;
+#endif
+			//Packet buffered, keep parsing to drain a burst in one call
 			break;
 		}
 	}
@@ -358,6 +373,7 @@ uint8_t transportGetAddress(void)
 
 bool transportDataAvailable(void)
 {
+	// with MY_RX_MESSAGE_BUFFER_FEATURE, received packets are buffered by _serialProcess()
 	_serialProcess();
 	return _packet_received;
 }
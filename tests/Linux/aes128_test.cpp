@@ -0,0 +1,163 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/*
+ * Host-side known-answer test and benchmark of the AES128 driver, covering
+ * the table driven code and the hardware accelerated path of this CPU.
+ * Built and run with "make tests" after ./configure.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <Arduino.h>
+#include "hal/crypto/generic/drivers/AES128/aes128.cpp"
+
+#define BENCHMARK_BLOCKS 2000000
+
+typedef void (*AES128Block_t)(const _AES128context_t *, const uint8_t *, uint8_t *);
+
+typedef struct {
+	uint8_t key[AES128_BLOCK_LENGTH];
+	uint8_t plain[AES128_BLOCK_LENGTH];
+	uint8_t cipher[AES128_BLOCK_LENGTH];
+} AES128Vector_t;
+
+// FIPS-197 Appendix B and Appendix C.1
+static const AES128Vector_t vectors[] = {
+	{
+		{ 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c },
+		{ 0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d, 0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34 },
+		{ 0x39, 0x25, 0x84, 0x1d, 0x02, 0xdc, 0x09, 0xfb, 0xdc, 0x11, 0x85, 0x97, 0x19, 0x6a, 0x0b, 0x32 }
+	},
+	{
+		{ 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f },
+		{ 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff },
+		{ 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a }
+	},
+};
+
+static int failures = 0;
+
+static void testVectors(const char *name, AES128Block_t encrypt, AES128Block_t decrypt)
+{
+	_AES128context_t ctx;
+	uint8_t block[AES128_BLOCK_LENGTH];
+	for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+		AES128Init(&ctx, vectors[i].key);
+		encrypt(&ctx, vectors[i].plain, block);
+		if (memcmp(block, vectors[i].cipher, AES128_BLOCK_LENGTH)) {
+			printf("FAIL: %s encryption, vector %u\n", name, (unsigned int)i);
+			failures++;
+		}
+		// in place
+		decrypt(&ctx, block, block);
+		if (memcmp(block, vectors[i].plain, AES128_BLOCK_LENGTH)) {
+			printf("FAIL: %s decryption, vector %u\n", name, (unsigned int)i);
+			failures++;
+		}
+	}
+}
+
+// compare against the table driven reference with random keys and blocks
+static void testRandom(const char *name, AES128Block_t encrypt, AES128Block_t decrypt)
+{
+	_AES128context_t ctx;
+	uint8_t key[AES128_BLOCK_LENGTH], plain[AES128_BLOCK_LENGTH];
+	uint8_t reference[AES128_BLOCK_LENGTH], block[AES128_BLOCK_LENGTH];
+	srand(1);
+	for (uint32_t round = 0; round < 10000; round++) {
+		for (uint8_t i = 0; i < AES128_BLOCK_LENGTH; i++) {
+			key[i] = (uint8_t)rand();
+			plain[i] = (uint8_t)rand();
+		}
+		AES128Init(&ctx, key);
+		AES128EncryptTable(&ctx, plain, reference);
+		encrypt(&ctx, plain, block);
+		if (memcmp(block, reference, AES128_BLOCK_LENGTH)) {
+			printf("FAIL: %s encryption differs from tables, round %u\n", name, round);
+			failures++;
+			return;
+		}
+		decrypt(&ctx, block, block);
+		if (memcmp(block, plain, AES128_BLOCK_LENGTH)) {
+			printf("FAIL: %s decryption differs from tables, round %u\n", name, round);
+			failures++;
+			return;
+		}
+	}
+}
+
+static void benchmark(const char *name, AES128Block_t encrypt, AES128Block_t decrypt)
+{
+	_AES128context_t ctx;
+	uint8_t block[AES128_BLOCK_LENGTH] = { 0 };
+	AES128Init(&ctx, vectors[0].key);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < BENCHMARK_BLOCKS; i++) {
+		encrypt(&ctx, block, block);
+	}
+	const std::chrono::duration<double> encryptTime = std::chrono::steady_clock::now() - start;
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < BENCHMARK_BLOCKS; i++) {
+		decrypt(&ctx, block, block);
+	}
+	const std::chrono::duration<double> decryptTime = std::chrono::steady_clock::now() - start;
+	// all-zero again after as many decryptions as encryptions
+	for (uint8_t i = 0; i < AES128_BLOCK_LENGTH; i++) {
+		if (block[i]) {
+			printf("FAIL: %s benchmark round trip\n", name);
+			failures++;
+			break;
+		}
+	}
+	const double megabytes = BENCHMARK_BLOCKS * AES128_BLOCK_LENGTH / 1e6;
+	printf("%-7s encrypt %7.1f MB/s, decrypt %7.1f MB/s\n", name,
+	       megabytes / encryptTime.count(), megabytes / decryptTime.count());
+}
+
+static void testPath(const char *name, AES128Block_t encrypt, AES128Block_t decrypt)
+{
+	testVectors(name, encrypt, decrypt);
+	testRandom(name, encrypt, decrypt);
+	benchmark(name, encrypt, decrypt);
+}
+
+int main(void)
+{
+	testPath("tables", AES128EncryptTable, AES128DecryptTable);
+#if defined(AES128_AESNI)
+	if (AES128hasAccel()) {
+		testPath("AES-NI", AES128EncryptAESNI, AES128DecryptAESNI);
+	} else {
+		printf("AES-NI not supported by this CPU, skipped\n");
+	}
+#elif defined(AES128_ARMV8)
+	if (AES128hasAccel()) {
+		testPath("ARMv8", AES128EncryptARMV8, AES128DecryptARMV8);
+	} else {
+		printf("ARMv8 crypto extensions not supported by this CPU, skipped\n");
+	}
+#endif
+	// public API, dispatching to the selected path
+	testVectors("AES128Encrypt", AES128Encrypt, AES128Decrypt);
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
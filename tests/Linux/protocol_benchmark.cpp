@@ -0,0 +1,299 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/*
+ * Host-side check and benchmark of the controller protocol parser.
+ * Built and run with "make tests" after ./configure.
+ *
+ * The strtok_r()/atoi() parsers the library used before are kept below as a reference:
+ * they must agree with the current parsers on valid input and are timed in the same loop.
+ */
+
+#include <cstdio>
+#include <chrono>
+
+// the gateway main() is not needed here
+#define main mysgw_main
+#include <MySensors.h>
+#undef main
+
+#if defined(MY_GATEWAY_FEATURE)
+
+#define BENCHMARK_ROUNDS 200000
+
+static int failures = 0;
+
+static void check(const bool condition, const char *what, const char *input)
+{
+	if (!condition) {
+		printf("FAIL: %s \"%s\"\n", what, input);
+		failures++;
+	}
+}
+
+static void testSerial(const char *input, const bool valid, const uint8_t destination = 0,
+                       const uint8_t sensor = 0, const uint8_t command = 0, const uint8_t type = 0,
+                       const char *payload = "")
+{
+	MyMessage message;
+	char buffer[MY_GATEWAY_MAX_RECEIVE_LENGTH];
+	char value[MAX_PAYLOAD_SIZE * 2 + 1];
+	const bool result = protocolSerial2MyMessage(message, input, strlen(input));
+	check(result == valid, "result", input);
+	// the NUL-terminated variant must agree
+	(void)strncpy(buffer, input, sizeof(buffer) - 1);
+	buffer[sizeof(buffer) - 1] = 0;
+	check(protocolSerial2MyMessage(message, buffer) == valid, "result (NUL-terminated)", input);
+	if (result && valid) {
+		check(message.getDestination() == destination, "destination", input);
+		check(message.getSensor() == sensor, "sensor", input);
+		check(message.getCommand() == command, "command", input);
+		check(message.getType() == type, "type", input);
+		check(!strcmp(message.getString(value), payload), "payload", input);
+	}
+}
+
+static void testMQTT(const char *topic, const char *payload, const bool valid)
+{
+	MyMessage message;
+	check(protocolMQTT2MyMessage(message, topic, (const uint8_t *)payload,
+	                             strlen(payload)) == valid, "MQTT result", topic);
+}
+
+// Reference: the serial parser before the single pass rewrite, modifies inputString
+static bool referenceSerial2MyMessage(MyMessage &message, char *inputString)
+{
+	char *str, *p;
+	uint8_t index = 0;
+	mysensors_command_t command = C_INVALID_7;
+	message.setSender(GATEWAY_ADDRESS);
+	message.setLast(GATEWAY_ADDRESS);
+	message.setEcho(false);
+
+	for (str = strtok_r(inputString, ";", &p); str && index < 5;
+	        str = strtok_r(NULL, ";", &p), index++) {
+		switch (index) {
+		case 0:
+			message.setDestination(atoi(str));
+			break;
+		case 1:
+			message.setSensor(atoi(str));
+			break;
+		case 2:
+			command = static_cast<mysensors_command_t>(atoi(str));
+			message.setCommand(command);
+			break;
+		case 3:
+			message.setRequestEcho(atoi(str) ? 1 : 0);
+			break;
+		case 4:
+			message.setType(atoi(str));
+			break;
+		}
+	}
+	if (str == NULL) {
+		message.set((uint8_t)0);
+	} else if (command == C_STREAM) {
+		uint8_t bvalue[MAX_PAYLOAD_SIZE];
+		uint8_t blen = 0;
+		while (*str) {
+			uint8_t val;
+			val = convertH2I(*str++) << 4;
+			val += convertH2I(*str++);
+			bvalue[blen] = val;
+			blen++;
+		}
+		message.set(bvalue, blen);
+	} else {
+		char *value = str;
+		const uint8_t lastCharacter = strlen(value) - 1;
+		if (value[lastCharacter] == '\r' || value[lastCharacter] == '\n') {
+			value[lastCharacter] = '\0';
+		}
+		message.set(value);
+	}
+	return (index == 5);
+}
+
+// Reference: the MQTT parser before the single pass rewrite, modifies topic and payload
+static bool referenceMQTT2MyMessage(MyMessage &message, char *topic, uint8_t *payload,
+                                    const unsigned int length)
+{
+	char *str, *p;
+	uint8_t index = 0;
+	message.setSender(GATEWAY_ADDRESS);
+	message.setLast(GATEWAY_ADDRESS);
+	message.setEcho(false);
+	for (str = strtok_r(topic + strlen(MY_MQTT_SUBSCRIBE_TOPIC_PREFIX) + 1, "/", &p);
+	        str && index < 5; str = strtok_r(NULL, "/", &p), index++) {
+		switch (index) {
+		case 0:
+			message.setDestination(atoi(str));
+			break;
+		case 1:
+			message.setSensor(atoi(str));
+			break;
+		case 2: {
+			const mysensors_command_t command = static_cast<mysensors_command_t>(atoi(str));
+			message.setCommand(command);
+			if (command == C_STREAM) {
+				uint8_t bvalue[MAX_PAYLOAD_SIZE];
+				uint8_t blen = 0;
+				while (*payload) {
+					uint8_t val;
+					val = convertH2I(*payload++) << 4;
+					val += convertH2I(*payload++);
+					bvalue[blen] = val;
+					blen++;
+				}
+				message.set(bvalue, blen);
+			} else {
+				char *value = (char *)payload;
+				value[length] = '\0';
+				message.set((const char*)payload);
+			}
+			break;
+		}
+		case 3:
+			message.setRequestEcho(atoi(str) ? 1 : 0);
+			break;
+		case 4:
+			message.setType(atoi(str));
+			break;
+		}
+	}
+	return (index == 5);
+}
+
+// Both parsers get a writable copy of each line, as the reference needs one
+static bool parse(MyMessage &message, const char *line, const bool mqtt, const bool reference)
+{
+	char buffer[MY_GATEWAY_MAX_RECEIVE_LENGTH];
+	char payload[8] = "23.5";
+	(void)strncpy(buffer, line, sizeof(buffer) - 1);
+	buffer[sizeof(buffer) - 1] = 0;
+	if (mqtt) {
+		return reference ? referenceMQTT2MyMessage(message, buffer, (uint8_t *)payload, 4) :
+		       protocolMQTT2MyMessage(message, buffer, (const uint8_t *)payload, 4);
+	}
+	return reference ? referenceSerial2MyMessage(message, buffer) :
+	       protocolSerial2MyMessage(message, buffer);
+}
+
+static void testReference(const char *line, const bool mqtt)
+{
+	MyMessage message, expected;
+	char value[MAX_PAYLOAD_SIZE * 2 + 1];
+	char expectedValue[MAX_PAYLOAD_SIZE * 2 + 1];
+	check(parse(message, line, mqtt, false) && parse(expected, line, mqtt, true), "reference result",
+	      line);
+	check(message.getDestination() == expected.getDestination() &&
+	      message.getSensor() == expected.getSensor() &&
+	      message.getCommand() == expected.getCommand() &&
+	      message.getType() == expected.getType() &&
+	      !strcmp(message.getString(value), expected.getString(expectedValue)), "reference message", line);
+}
+
+static double benchmark(const char * const *lines, const size_t count, const bool mqtt,
+                        const bool reference)
+{
+	MyMessage message;
+	uint32_t parsed = 0;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t round = 0; round < BENCHMARK_ROUNDS; round++) {
+		for (size_t i = 0; i < count; i++) {
+			parsed += parse(message, lines[i], mqtt, reference);
+		}
+	}
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	check(parsed == BENCHMARK_ROUNDS * count, "benchmark", mqtt ? "MQTT" : "serial");
+	return elapsed.count() / (BENCHMARK_ROUNDS * count);
+}
+
+int main(void)
+{
+	testSerial("12;3;1;0;0;23.5", true, 12, 3, C_SET, V_TEMP, "23.5");
+	testSerial("12;3;1;0;0;23.5\r", true, 12, 3, C_SET, V_TEMP, "23.5");
+	// no payload sets the default value
+	testSerial("0;255;3;0;2;", true, 0, 255, C_INTERNAL, I_VERSION, "0");
+	testSerial("0;255;3;0;2", true, 0, 255, C_INTERNAL, I_VERSION, "0");
+	// the payload ends at the next semicolon
+	testSerial("5;1;1;1;2;hello;world", true, 5, 1, C_SET, V_STATUS, "hello");
+	testSerial("7;255;4;0;2;0A0b0C", true, 7, 255, C_STREAM, 2, "0A0B0C");
+	testSerial("7;255;4;0;2;0A0", false);
+	testSerial("7;255;4;0;2;0G", false);
+	testSerial("0;1;2", false);
+	testSerial("", false);
+	testSerial("256;1;1;0;2;1", false);
+	testSerial("a;1;1;0;2;1", false);
+	testSerial("1;;1;0;2;1", false);
+	testMQTT(MY_MQTT_SUBSCRIBE_TOPIC_PREFIX "/12/3/1/0/0", "23.5", true);
+	testMQTT(MY_MQTT_SUBSCRIBE_TOPIC_PREFIX "/12/3/1/0", "23.5", false);
+	testMQTT(MY_MQTT_SUBSCRIBE_TOPIC_PREFIX "/12/x/1/0/0", "23.5", false);
+	// payloads longer than 255 characters are truncated, not wrapped around
+	{
+		char line[10 + 300 + 1] = "1;1;1;0;2;";
+		MyMessage message;
+		char value[MAX_PAYLOAD_SIZE * 2 + 1];
+		(void)memset(line + 10, 'x', 300);
+		line[10 + 300] = 0;
+		check(protocolSerial2MyMessage(message, line, strlen(line)) &&
+		      strlen(message.getString(value)) == MAX_PAYLOAD_SIZE, "long payload", "1;1;1;0;2;x...");
+	}
+
+	static const char * const serialLines[] = {
+		"12;3;1;0;0;23.5",
+		"0;255;3;0;2;",
+		"5;1;1;1;2;1",
+		"254;255;3;0;6;M",
+		"42;7;1;0;47;Lorem ipsum dolor sit",
+		"7;255;4;0;2;00112233445566778899AABBCCDDEEFF",
+	};
+	static const char * const mqttTopics[] = {
+		MY_MQTT_SUBSCRIBE_TOPIC_PREFIX "/12/3/1/0/0",
+		MY_MQTT_SUBSCRIBE_TOPIC_PREFIX "/0/255/3/0/2",
+		MY_MQTT_SUBSCRIBE_TOPIC_PREFIX "/254/255/3/0/6",
+	};
+	const size_t serialCount = sizeof(serialLines) / sizeof(serialLines[0]);
+	const size_t mqttCount = sizeof(mqttTopics) / sizeof(mqttTopics[0]);
+	for (size_t i = 0; i < serialCount; i++) {
+		testReference(serialLines[i], false);
+	}
+	for (size_t i = 0; i < mqttCount; i++) {
+		testReference(mqttTopics[i], true);
+	}
+	printf("protocolSerial2MyMessage: %.1f ns/line (reference %.1f ns/line)\n",
+	       benchmark(serialLines, serialCount, false, false), benchmark(serialLines, serialCount, false,
+	               true));
+	printf("protocolMQTT2MyMessage:   %.1f ns/message (reference %.1f ns/message)\n",
+	       benchmark(mqttTopics, mqttCount, true, false), benchmark(mqttTopics, mqttCount, true, true));
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
+
+#else
+
+int main(void)
+{
+	printf("SKIPPED: the controller protocol is only built for gateways\n");
+	return 0;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/*
+ * GPIO replacement for the host-side tests: pins read as LOW and writes are
+ * ignored, so the tests run without access to /sys/class/gpio or /dev/gpiochip*.
+ */
+
+#include <stddef.h>
+#include "GPIO.h"
+
+GPIOClass GPIO = GPIOClass();
+
+GPIOClass::GPIOClass() : lastPinNum(0), exportedPins(NULL)
+{
+}
+
+GPIOClass::GPIOClass(const GPIOClass& other) : lastPinNum(other.lastPinNum), exportedPins(NULL)
+{
+}
+
+GPIOClass::~GPIOClass()
+{
+}
+
+void GPIOClass::pinMode(uint8_t pin, uint8_t mode)
+{
+	(void)pin;
+	(void)mode;
+}
+
+void GPIOClass::digitalWrite(uint8_t pin, uint8_t value)
+{
+	(void)pin;
+	(void)value;
+}
+
+uint8_t GPIOClass::digitalRead(uint8_t pin)
+{
+	(void)pin;
+	return LOW;
+}
+
+uint8_t GPIOClass::digitalPinToInterrupt(uint8_t pin)
+{
+	return pin;
+}
+
+#if defined(LINUX_GPIO_CHARDEV)
+int GPIOClass::requestEdgeEvents(uint8_t pin, bool rising, bool falling)
+{
+	(void)pin;
+	(void)rising;
+	(void)falling;
+	return -1;
+}
+#endif
+
+GPIOClass& GPIOClass::operator=(const GPIOClass& other)
+{
+	lastPinNum = other.lastPinNum;
+	return *this;
+}